@@ -0,0 +1,383 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+
+/* Compares the button mapping encoder with the previous regex based
+ * implementation and with the compile-time encoder of the M908 settings
+ * builder (m908/profile.h), measures the first two.
+ * 
+ * Build with "make benchmarks" or cmake -D BUILD_BENCHMARKS=ON, run
+ * ./button_mapping_benchmark [keymap.md] [rounds]. Every mapping listed
+ * in keymap.md (templates like macro⟨N⟩ are expanded) and a set of
+ * invalid mappings are encoded by all implementations, the exit status
+ * is 1 if any result differs.
+ */
+
+#include "../include/rd_mouse.h"
+
+#include <chrono>
+#include <cstdlib>
+
+// access to the name → value maps
+class tables : public rd_mouse{
+	public:
+		static auto& keycodes(){ return _c_keycodes; }
+		static auto& modifiers(){ return _c_keyboard_modifier_values; }
+		static auto& keys(){ return _c_keyboard_key_values; }
+		static auto& snipe_dpi(){ return _c_snipe_dpi_values; }
+};
+
+// the previous implementation of rd_mouse::_i_encode_button_mapping, with
+// its own copies of the maps because operator[] inserts unknown keys
+static int encode_regex( const std::string& mapping, std::array<uint8_t, 4>& bytes ){
+	
+	static std::map< std::string, std::array<uint8_t, 4> > _c_keycodes = tables::keycodes();
+	static const std::map< std::string, uint8_t > _c_keyboard_modifier_values = tables::modifiers();
+	static std::map< std::string, uint8_t > _c_keyboard_key_values = tables::keys();
+	static std::map< int, uint8_t > _c_snipe_dpi_values = tables::snipe_dpi();
+	
+	// raw byte values
+	if( std::regex_match( mapping, std::regex("0x[0-9a-fA-F]{8}") ) ){
+
+		bytes[0] = std::stoi( mapping.substr(2, 2) , 0, 16 );
+		bytes[1] = std::stoi( mapping.substr(4, 2) , 0, 16 );
+		bytes[2] = std::stoi( mapping.substr(6, 2) , 0, 16 );
+		bytes[3] = std::stoi( mapping.substr(8, 2) , 0, 16 );
+
+	// is string in _c_keycodes? mousebuttons/special functions and media controls
+	} else if( _c_keycodes.find(mapping) != _c_keycodes.end() ){
+		
+		bytes[0] = _c_keycodes[mapping][0];
+		bytes[1] = _c_keycodes[mapping][1];
+		bytes[2] = _c_keycodes[mapping][2];
+		bytes[3] = _c_keycodes[mapping][3];
+	
+	// fire button (multiple keypresses)
+	} else if( mapping.find("fire") == 0 ){
+		
+		std::stringstream mapping_stream(mapping);
+		std::string value1 = "", value2 = "", value3 = "";
+		uint8_t keycode, repeats = 1, delay = 0;
+		
+		// the repeated value1 line is not a mistake, it skips the "fire:"
+		std::getline( mapping_stream, value1, ':' );
+		std::getline( mapping_stream, value1, ':' );
+		std::getline( mapping_stream, value2, ':' );
+		std::getline( mapping_stream, value3, ':' );
+		
+		if( value1 == "mouse_left" ){
+			keycode = 0x81;
+		} else if( value1 == "mouse_right" ){
+			keycode = 0x82;
+		} else if( value1 == "mouse_middle" ){
+			keycode = 0x84;
+		} else if( _c_keyboard_key_values.find(value1) != _c_keyboard_key_values.end() ){
+			keycode = _c_keyboard_key_values[value1];
+		} else{
+			return 1;
+		}
+		
+		// the previous implementation did not catch these exceptions
+		try{
+			repeats = (uint8_t)stoi(value2);
+			delay = (uint8_t)stoi(value3);
+		} catch( std::exception& f ){
+			return 1;
+		}
+		
+		// store values
+		bytes[0] = 0x99;
+		bytes[1] = keycode;
+		bytes[2] = repeats;
+		bytes[3] = delay;
+	
+	// snipe button (changes dpi while pressed)
+	} else if( mapping.find("snipe") == 0 ){
+		
+		try{
+			
+			int dpi_value = std::stoi( std::regex_replace( mapping, std::regex("snipe:"), "" ) );
+			uint8_t dpi_byte = _c_snipe_dpi_values.at( dpi_value );
+			
+			bytes[0] = 0x9a;
+			bytes[1] = 0x01;
+			bytes[2] = dpi_byte;
+			bytes[3] = dpi_byte;
+			
+		} catch( std::exception& f ){ // invalid mapping pattern or dpi
+			return 1;
+		}
+	
+	// macro (no repeats)
+	} else if( std::regex_match( mapping, std::regex("(macro[1-9]|macro1[0-5])") ) ){
+		
+		try{
+			
+			bytes[0] = 0x91;
+			bytes[1] = std::stoi( std::regex_replace( mapping, std::regex("macro"), "" ) ) - 1;
+			bytes[2] = 0x01;
+			bytes[3] = 0x00;
+			
+		} catch( std::exception& f ){
+			return 1;
+		}
+	
+	// macro (repeats)
+	} else if( std::regex_match( mapping, std::regex("(macro[1-9]|macro1[0-5]):\\d+") ) ){
+		
+		try{
+			
+			bytes[0] = 0x91;
+			bytes[1] = std::stoi( std::regex_replace( mapping, std::regex("(macro|:\\d+)"), "" ) ) - 1;
+			bytes[2] = std::stoi( std::regex_replace( mapping, std::regex("macro\\d+:"), "" ) );
+			bytes[3] = 0x00;
+			
+		} catch( std::exception& f ){
+			return 1;
+		}
+	
+	// macro (repeat until button is pressed again)
+	} else if( std::regex_match( mapping, std::regex("(macro[1-9]|macro1[0-5]):until") ) ){
+		
+		try{
+			
+			bytes[0] = 0x91;
+			bytes[1] = std::stoi( std::regex_replace( mapping, std::regex("(macro|:until)"), "" ) ) + 0x3f;
+			bytes[2] = 0xff;
+			bytes[3] = 0xff;
+			
+		} catch( std::exception& f ){
+			return 1;
+		}
+	
+	// macro (repeat while button id held down)
+	} else if( std::regex_match( mapping, std::regex("(macro[1-9]|macro1[0-5]):while") ) ){
+		
+		try{
+			
+			bytes[0] = 0x91;
+			bytes[1] = std::stoi( std::regex_replace( mapping, std::regex("(macro|:while)"), "" ) ) + 0x7f;
+			bytes[2] = 0xff;
+			bytes[3] = 0xff;
+			
+		} catch( std::exception& f ){
+			return 1;
+		}
+	
+	// string is not a key in _c_keycodes: keyboard key (+ modifiers) ?
+	} else{
+		
+		// search for modifiers and change values accordingly: ctrl, shift ...
+		uint8_t first_value = 0x90;
+		uint8_t modifier_value = 0x00;
+		for( auto i : _c_keyboard_modifier_values ){
+			if( mapping.find( i.first ) != std::string::npos ){
+				modifier_value += i.second;
+				first_value = 0x8f;
+			}
+		}
+		
+		// get key value and store everything
+		try{
+			
+			std::regex modifier_regex ("[a-z_]*\\+");
+			
+			// store values
+			bytes[0] = first_value;
+			bytes[1] = modifier_value;
+			bytes[2] = _c_keyboard_key_values[std::regex_replace( mapping, modifier_regex, "" )];
+			bytes[3] = 0x00;
+			
+		} catch( std::exception& f ){
+			return 1;
+		}
+	}
+	
+	return 0;
+}
+
+// reads the mappings from keymap.md and expands the templates
+static std::vector< std::string > keymap_mappings( const std::string& path ){
+	
+	std::vector< std::string > mappings;
+	std::vector< std::string > keys, modifiers;
+	std::ifstream keymap( path );
+	std::string line, section;
+	
+	while( std::getline( keymap, line ) ){
+		
+		if( line.rfind( "## ", 0 ) == 0 || line.rfind( "### ", 0 ) == 0 ){
+			section = line;
+			continue;
+		}
+		
+		// mappings are single words, skip text and lists
+		if( line.empty() || line[0] == '#' || line[0] == '-' || line[0] == '\t' ||
+			line.find( ' ' ) != std::string::npos || line.find( "⟨" ) != std::string::npos )
+			continue;
+		
+		if( section == "### Modifers" ){
+			modifiers.push_back( line );
+		} else{
+			mappings.push_back( line );
+			if( section == "### Keys" )
+				keys.push_back( line );
+		}
+	}
+	
+	// keys with modifiers
+	for( size_t i = 0; i < keys.size(); i++ ){
+		for( size_t j = 0; j < modifiers.size(); j++ ){
+			mappings.push_back( modifiers[j] + keys[i] );
+			mappings.push_back( modifiers[j] + modifiers[(i+j) % modifiers.size()] + keys[i] );
+		}
+	}
+	
+	// fire buttons
+	for( std::string button : { "mouse_left", "mouse_right", "mouse_middle" } )
+		mappings.push_back( "fire:" + button + ":5:1" );
+	for( size_t i = 0; i < keys.size(); i++ )
+		mappings.push_back( "fire:" + keys[i] + ":" + std::to_string( i % 255 + 1 ) + ":" + std::to_string( 255 - i % 255 ) );
+	
+	// snipe buttons
+	for( int dpi = 200; dpi <= 1100; dpi += 100 )
+		mappings.push_back( "snipe:" + std::to_string( dpi ) );
+	
+	// macros
+	for( int i = 1; i <= 15; i++ ){
+		mappings.push_back( "macro" + std::to_string( i ) );
+		mappings.push_back( "macro" + std::to_string( i ) + ":" + std::to_string( i * 17 ) );
+		mappings.push_back( "macro" + std::to_string( i ) + ":while" );
+		mappings.push_back( "macro" + std::to_string( i ) + ":until" );
+	}
+	
+	// raw bytes
+	mappings.push_back( "0x11aa22bb" );
+	mappings.push_back( "0x8E01CD00" );
+	
+	return mappings;
+}
+
+// edge cases and invalid mappings
+static const std::vector< std::string > invalid_mappings = {
+	"", "0x11aa22b", "0x11aa22bbc", "0x11aa22bg", "0X11aa22bb",
+	"fire", "fire:", "fire:mouse_left", "fire:mouse_left:5", "fire:mouse_left:x:1",
+	"fire:unknown:1:1", "fire:a:300:-1", "fire:a: 7:8x", "fireX:a:1:1",
+	"snipe", "snipe:", "snipe:250", "snipe:800x", "snipe:snipe:800", "snipe: 300", "snipe800",
+	"macro", "macro0", "macro16", "macro01", "macro1:", "macro1:x", "macro1:300",
+	"macro1:99999999999", "macro15:until:", "macro2:While",
+	"unknown", "ctrl_l+", "ctrl_l+unknown", "Ctrl_l+a", "xctrl_l+a", "ctrl_l+ctrl_l+a",
+	"foo+bar+a", "a+", "+a", "shift_r+F1+", "alt_l+super_r+Esc",
+};
+
+// runs all mappings rounds times, returns ns per mapping
+template< typename F > double measure( const std::vector< std::string >& mappings, long rounds, F fn ){
+	
+	std::array<uint8_t, 4> bytes;
+	unsigned checksum = 0;
+	
+	auto start = std::chrono::steady_clock::now();
+	for( long round = 0; round < rounds; round++ ){
+		for( auto& mapping : mappings ){
+			checksum += fn( mapping, bytes );
+			checksum += bytes[2];
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+	
+	if( checksum == 1 )
+		std::cout << "";
+	
+	return std::chrono::duration<double, std::nano>( end - start ).count() / ( rounds * mappings.size() );
+}
+
+int main( int argc, char **argv ){
+	
+	std::string path = argc > 1 ? argv[1] : "keymap.md";
+	long rounds = argc > 2 ? std::atol( argv[2] ) : 1000;
+	
+	std::vector< std::string > mappings = keymap_mappings( path );
+	if( mappings.empty() || rounds <= 0 ){
+		std::cerr << "Usage: button_mapping_benchmark [keymap.md] [rounds]\n";
+		return 2;
+	}
+	
+	rd_button_encoder encoder( tables::keycodes(), tables::modifiers(), tables::keys(), tables::snipe_dpi() );
+	
+	auto encode_new = [&]( const std::string& mapping, std::array<uint8_t, 4>& bytes ){
+		return encoder.encode( mapping, bytes );
+	};
+	
+	// compare the results
+	std::vector< std::string > all = mappings;
+	all.insert( all.end(), invalid_mappings.begin(), invalid_mappings.end() );
+	
+	int mismatches = 0;
+	for( auto& mapping : all ){
+		
+		std::array<uint8_t, 4> bytes_regex = { 0, 0, 0, 0 }, bytes_new = { 0, 0, 0, 0 };
+		int return_regex = encode_regex( mapping, bytes_regex );
+		int return_new = encode_new( mapping, bytes_new );
+		
+		if( return_regex != return_new || ( return_regex == 0 && bytes_regex != bytes_new ) ){
+			std::cout << "MISMATCH: \"" << mapping << "\" regex: " << return_regex << " " << rd_log::hex( bytes_regex.data(), 4 )
+				<< ", new: " << return_new << " " << rd_log::hex( bytes_new.data(), 4 ) << "\n";
+			mismatches++;
+		}
+	}
+	
+	// the compile-time encoder: the same bytes for every mapping of keymap.md, the invalid ones throw, it also
+	// rejects the malformed mappings the runtime encoder accepts (e.g. unknown keys as 0x00)
+	for( size_t i = 0; i < all.size(); i++ ){
+		
+		const std::string& mapping = all[i];
+		std::array<uint8_t, 4> bytes_profile = { 0, 0, 0, 0 }, bytes_new = { 0, 0, 0, 0 };
+		int return_profile = 0;
+		try{
+			bytes_profile = mouse_m908_profile::encode_button_mapping( mapping );
+		} catch( std::invalid_argument& e ){
+			return_profile = 1;
+		}
+		int return_new = encode_new( mapping, bytes_new );
+		
+		bool valid = i < mappings.size();
+		if( ( valid || return_profile == 0 ) && ( return_profile != 0 || return_new != 0 || bytes_profile != bytes_new ) ){
+			std::cout << "MISMATCH: \"" << mapping << "\" profile.h: " << return_profile << " " << rd_log::hex( bytes_profile.data(), 4 )
+				<< ", new: " << return_new << " " << rd_log::hex( bytes_new.data(), 4 ) << "\n";
+			mismatches++;
+		}
+	}
+	
+	// a configuration file has 20 buttons × 5 profiles, the regex encoder
+	// is about 1000 times slower and runs fewer rounds
+	double regex_time = measure( mappings, rounds / 100 + 1, encode_regex );
+	double new_time = measure( mappings, rounds, encode_new );
+	
+	std::cout << std::fixed << std::setprecision(1);
+	std::cout << "mappings: " << mappings.size() << " from " << path << ", " << invalid_mappings.size() << " invalid, rounds: " << rounds << "\n";
+	std::cout << "regex encoder:   " << regex_time << " ns/mapping, " << regex_time * 100 / 1000 << " us per configuration\n";
+	std::cout << "current encoder: " << new_time << " ns/mapping, " << new_time * 100 / 1000 << " us per configuration\n";
+	std::cout << "speedup:         " << regex_time / new_time << "x\n";
+	
+	if( mismatches > 0 ){
+		std::cout << "FAIL: " << mismatches << " mappings are encoded differently\n";
+		return 1;
+	}
+	
+	return 0;
+}
@@ -0,0 +1,99 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+
+/* Measures the cost of log messages that are filtered out.
+ * 
+ * Build with "make benchmarks" or cmake -D BUILD_BENCHMARKS=ON, run
+ * ./log_benchmark [calls] [limit in ns]. The exit status is 1 if a
+ * message filtered at runtime costs more than the limit (default 5 ns).
+ */
+
+#include "../include/log.h"
+
+#include <chrono>
+#include <cstdlib>
+
+// keeps the compiler from moving the level check out of the loop,
+// in the real code the check is surrounded by other work
+static inline void barrier(){
+	asm volatile( "" ::: "memory" );
+}
+
+// runs fn calls times, returns ns per call
+template< typename F > double measure( long calls, F fn ){
+	
+	auto start = std::chrono::steady_clock::now();
+	for( long i = 0; i < calls; i++ ){
+		fn( i );
+		barrier();
+	}
+	auto end = std::chrono::steady_clock::now();
+	
+	return std::chrono::duration<double, std::nano>( end - start ).count() / calls;
+}
+
+int main( int argc, char **argv ){
+	
+	long calls = argc > 1 ? std::atol( argv[1] ) : 100000000;
+	double limit = argc > 2 ? std::atof( argv[2] ) : 5.0;
+	
+	if( calls <= 0 ){
+		std::cerr << "Usage: log_benchmark [calls] [limit in ns]\n";
+		return 2;
+	}
+	
+	rd_log::set_level( rd_log::level_warning );
+	
+	uint8_t buffer[16] = { 0x02, 0xf3, 0x2c };
+	
+	// empty loop
+	double baseline = measure( calls, []( long i ){ (void)i; } );
+	
+	// removed by the compile-time filter
+	double compiled_out = measure( calls, [&]( long i ){
+		(void)i;
+		RD_LOG_TRACE( "row " << i << ": " << rd_log::hex( buffer, 16 ) );
+	} );
+	
+	// passes the compile-time filter, filtered at runtime
+	double filtered = measure( calls, [&]( long i ){
+		RD_LOG_DEBUG( "row " << i << ": " << rd_log::hex( buffer, 16 ) );
+	} );
+	
+	// written to a file, for comparison
+	rd_log::set_sink( rd_log::sink_file, "/dev/null" );
+	rd_log::set_level( rd_log::level_debug );
+	double written = measure( calls / 1000 + 1, [&]( long i ){
+		RD_LOG_DEBUG( "row " << i << ": " << rd_log::hex( buffer, 16 ) );
+	} );
+	
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "compile-time level: " << RD_LOG_LEVEL << ", calls: " << calls << "\n";
+	std::cout << "empty loop:                   " << baseline << " ns/call\n";
+	std::cout << "trace (compiled out):         " << compiled_out - baseline << " ns/call\n";
+	std::cout << "debug (filtered at runtime):  " << filtered - baseline << " ns/call\n";
+	std::cout << "debug (written to /dev/null): " << written - baseline << " ns/call\n";
+	
+	if( filtered - baseline > limit ){
+		std::cout << "FAIL: filtered message costs more than " << limit << " ns\n";
+		return 1;
+	}
+	
+	return 0;
+}
@@ -0,0 +1,39 @@
+#!/bin/sh
+# Training workload for the profile-guided optimization build, also used to
+# time it: every example configuration and example.macro are parsed, encoded
+# and sent to the simulated mouse of the model, and the settings are read,
+# dumped and compared (--dry-run) against it. No mouse is needed.
+#
+# usage: benchmarks/pgo_workload.sh <mouse_m908 binary> [repetitions]
+
+binary=$1
+repetitions=${2:-1}
+examples=$(dirname "$0")/../examples
+
+if [ ! -x "$binary" ]; then
+	echo "usage: $0 <mouse_m908 binary> [repetitions]" >&2
+	exit 1
+fi
+
+start=$(date +%s%N)
+
+i=0
+while [ $i -lt "$repetitions" ]; do
+	for config in "$examples"/example_*.ini; do
+		
+		# example_m908.ini -> 908, example_generic.ini -> generic
+		model=$(basename "$config" .ini)
+		model=${model#example_}
+		model=${model#m}
+		
+		# some models don't support (all) macros, the errors are part of the workload
+		"$binary" --simulate -M "$model" -c "$config" -m "$config" > /dev/null 2>&1
+		"$binary" --simulate -M "$model" -m "$examples/example.macro" -n 1 > /dev/null 2>&1
+		"$binary" --simulate -M "$model" -R /dev/null -D /dev/null > /dev/null 2>&1
+		"$binary" --simulate -M "$model" -c "$config" --dry-run > /dev/null 2>&1
+	done
+	i=$((i+1))
+done
+
+end=$(date +%s%N)
+echo "workload: $(( (end - start) / 1000000 )) ms for $repetitions repetitions"
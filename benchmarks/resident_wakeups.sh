@@ -0,0 +1,55 @@
+#!/bin/sh
+# Wakeups of the idle resident mode: starts mouse_m908 --resident, sends
+# one command (-R, nothing is written) so the mouse is open and its
+# interfaces are claimed, waits until they were released after the idle
+# time and counts the context switches of all threads of the process
+# (/proc/PID/task/*/status) while nothing happens. An idle resident mode
+# sleeps in poll() without a timeout, the count should stay at 0.
+# Needs the mouse.
+#
+# usage: benchmarks/resident_wakeups.sh <mouse_m908 binary> [seconds] [max wakeups per second]
+
+binary=$1
+seconds=${2:-10}
+limit=${3:-0.1}
+
+if [ ! -x "$binary" ]; then
+	echo "usage: $0 <mouse_m908 binary> [seconds] [max wakeups per second]" >&2
+	exit 1
+fi
+
+directory=$(mktemp -d)
+export MOUSE_M908_SOCKET="$directory/resident.socket"
+
+# voluntary and nonvoluntary context switches of all threads
+switches(){
+	cat /proc/"$1"/task/*/status 2>/dev/null | awk '/ctxt_switches/ { n += $2 } END { print n + 0 }'
+}
+
+"$binary" --resident=200 < /dev/null 2> "$directory/resident.log" &
+pid=$!
+trap 'kill $pid 2>/dev/null; rm -rf "$directory"' EXIT
+
+i=0
+while [ ! -S "$MOUSE_M908_SOCKET" ] && [ $i -lt 50 ]; do
+	sleep 0.1
+	i=$((i+1))
+done
+if ! "$binary" -R /dev/null > /dev/null; then
+	echo "the resident mode didn't perform the command:" >&2
+	cat "$directory/resident.log" >&2
+	exit 1
+fi
+
+# the interfaces are released after 200 ms
+sleep 1
+
+before=$(switches $pid)
+sleep "$seconds"
+after=$(switches $pid)
+
+wakeups=$((after - before))
+rate=$(awk "BEGIN { printf \"%.3f\", $wakeups / $seconds }")
+echo "idle resident mode: $wakeups wakeups in $seconds s, $rate per second"
+
+awk "BEGIN { exit !($rate <= $limit) }"
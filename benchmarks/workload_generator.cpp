@@ -0,0 +1,319 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+
+/* Generates a seeded corpus of configurations, macros and settings
+ * memory images for the benchmarks.
+ * 
+ * Build with "make benchmarks" or cmake -D BUILD_BENCHMARKS=ON, run
+ * ./workload_generator <directory> [seed] [files per model]. For every
+ * model compiled in the directory gets, numbered from 1:
+ * - <model>_<n>.ini: all keys of the configuration and 0-15 macros,
+ *   usable with -c and -m
+ * - <model>_<n>.macro: one macro, usable with -m and -n
+ * - <model>_<n>.image: the settings memory of a mouse after the .ini was
+ *   written, usable with --simulate=<file> for -R, -D and --dry-run
+ * Every value is checked with the setters of the model, the same seed
+ * gives the same corpus with every compiler and standard library.
+ */
+
+#include "../include/actions.h"
+#include "../include/keycodes.h"
+
+#include <cstdlib>
+#include <functional>
+#include <random>
+
+// names of a keycode table
+template< typename T, size_t N > static std::vector< std::string > names( const std::pair< T, uint8_t > (&table)[N] ){
+	std::vector< std::string > result;
+	for( auto& entry : table )
+		result.push_back( entry.first );
+	return result;
+}
+
+class generator{
+	
+	public:
+		
+		/// the models get their own sequences, a corpus doesn't change when other models are added
+		generator( unsigned int seed, const std::string& model ){
+			std::vector< unsigned int > seeds = { seed };
+			seeds.insert( seeds.end(), model.begin(), model.end() );
+			std::seed_seq sequence( seeds.begin(), seeds.end() );
+			_i_random.seed( sequence );
+			
+			for( auto& entry : rd_keycode_table )
+				_i_functions.push_back( entry.first );
+			_i_modifiers = names( rd_keyboard_modifier_table );
+			_i_keys = names( rd_keyboard_key_table );
+			for( auto& entry : rd_snipe_dpi_table )
+				_i_snipe_dpi.push_back( entry.first );
+		}
+		
+		/// writes the .ini, .macro and .image files of a model
+		template< typename T > void generate( const std::string& prefix ){
+			
+			std::ofstream ini( prefix+".ini" );
+			ini << "# Model: " << T::get_name() << "\n";
+			ini << "# Generated by workload_generator\n";
+			write_settings< T >( ini );
+			write_macros( ini );
+			ini.close();
+			
+			std::ofstream macro( prefix+".macro" );
+			write_macro( macro, "" );
+			macro.close();
+			
+			// the memory after writing the settings and macros to a simulated mouse
+			T m;
+			simple_ini_parser pt;
+			if( pt.read_ini( prefix+".ini" ) != 0 )
+				throw std::string( "Couldn't read "+prefix+".ini" );
+			apply_config( m, pt );
+			m.set_all_macros( prefix+".ini" );
+			m.set_dry_run( true );
+			m.set_simulated_memory( rd_mouse::memory_image() );
+			m.write_settings();
+			try{
+				for( int i = 1; i < 16; i++ )
+					m.write_macro( i );
+			} catch( std::string const &message ){
+				// models without macros (M913): the macro memory stays empty
+			}
+			
+			std::ofstream image( prefix+".image" );
+			image << "# Model: " << T::get_name() << "\n";
+			image << "# Settings memory generated by workload_generator, use with mouse_m908 --simulate=<file>\n";
+			rd_mouse::print_memory_rows( m.get_simulated_memory(), image );
+		}
+	
+	private:
+		
+		std::mt19937 _i_random;
+		std::vector< std::string > _i_functions, _i_modifiers, _i_keys;
+		std::vector< int > _i_snipe_dpi;
+		
+		// taken from the output of the engine: std::uniform_int_distribution is implementation-defined,
+		// the corpus would differ between standard libraries (the small bias of % doesn't matter here)
+		int uniform( int min, int max ){
+			return min + (int)( _i_random() % (uint_fast32_t)( max-min+1 ) );
+		}
+		
+		template< typename C > const auto& choose( const C& values ){
+			return values[uniform( 0, values.size()-1 )];
+		}
+		
+		// the first value accepted by valid out of 50 tries, empty if none
+		std::string pick( const std::function< std::string() >& value, const std::function< bool( const std::string& ) >& valid ){
+			for( int i = 0; i < 50; i++ ){
+				std::string candidate = value();
+				if( valid( candidate ) )
+					return candidate;
+			}
+			return "";
+		}
+		
+		std::string hex( int value, int width ){
+			std::ostringstream output;
+			output << std::hex << std::setfill('0') << std::setw( width ) << value;
+			return output.str();
+		}
+		
+		// one of the mapping forms of keymap.md
+		std::string mapping(){
+			
+			std::string key = choose( _i_keys );
+			switch( uniform( 0, 9 ) ){
+				case 0:
+				case 1:
+					return choose( _i_functions );
+				case 2:
+				case 3:
+					return key;
+				case 4: {
+					std::string modifiers;
+					for( int i = uniform( 1, 3 ); i > 0; i-- )
+						modifiers += choose( _i_modifiers );
+					return modifiers + key;
+				}
+				case 5: {
+					const std::vector< std::string > buttons = { "mouse_left", "mouse_right", "mouse_middle", key };
+					return "fire:" + choose( buttons ) + ":" + std::to_string( uniform( 1, 255 ) ) + ":" + std::to_string( uniform( 1, 255 ) );
+				}
+				case 6:
+					return "snipe:" + std::to_string( choose( _i_snipe_dpi ) );
+				case 7: {
+					const std::vector< std::string > modes = { "", ":" + std::to_string( uniform( 1, 255 ) ), ":while", ":until" };
+					return "macro" + std::to_string( uniform( 1, 15 ) ) + choose( modes );
+				}
+				case 8:
+					return "0x" + hex( uniform( 0, 0xffff ), 4 ) + hex( uniform( 0, 0xffff ), 4 );
+				default:
+					return "none";
+			}
+		}
+		
+		template< typename T > void write_settings( std::ostream& output ){
+			
+			T probe;
+			std::vector< std::string > lightmodes, report_rates;
+			for( auto& lightmode : probe.lightmode_strings() )
+				lightmodes.push_back( lightmode.second );
+			for( auto& report_rate : probe.report_rate_strings() )
+				report_rates.push_back( report_rate.second );
+			
+			for( int i = 1; i < 6; i++ ){
+				
+				rd_mouse::rd_profile profile = (rd_mouse::rd_profile)(i - 1);
+				output << "\n[profile" << i << "]\n";
+				
+				// LEDs, the values are hex like in the configuration files
+				if( !lightmodes.empty() )
+					output << "lightmode=" << choose( lightmodes ) << "\n";
+				output << "color=" << hex( uniform( 0, 0xffffff ), 6 ) << "\n";
+				
+				auto level = [&]( int max ){ return [this, max](){ return hex( uniform( 0, max ), 1 ); }; };
+				std::string brightness = pick( level( 0xf ), [&]( const std::string& v ){ return probe.set_brightness( profile, stoi( v, 0, 16 ) ) == 0; } );
+				std::string speed = pick( level( 0xf ), [&]( const std::string& v ){ return probe.set_speed( profile, stoi( v, 0, 16 ) ) == 0; } );
+				std::string scrollspeed = pick( level( 0x3f ), [&]( const std::string& v ){ return probe.set_scrollspeed( profile, stoi( v, 0, 16 ) ) == 0; } );
+				if( !brightness.empty() )
+					output << "brightness=" << brightness << "\n";
+				if( !speed.empty() )
+					output << "speed=" << speed << "\n";
+				if( !scrollspeed.empty() )
+					output << "scrollspeed=" << scrollspeed << "\n";
+				
+				// DPI, at least one level stays enabled
+				int enabled = uniform( 1, 5 );
+				for( int j = 1; j < 6; j++ ){
+					output << "dpi" << j << "_enable=" << (j == enabled || uniform( 0, 1 )) << "\n";
+					std::string dpi = pick( [this](){ return std::to_string( 100 * uniform( 1, 160 ) ); },
+						[&]( const std::string& v ){ return probe.set_dpi( profile, j-1, v ) == 0; } );
+					if( !dpi.empty() )
+						output << "dpi" << j << "=" << dpi << "\n";
+				}
+				
+				if( !report_rates.empty() )
+					output << "report_rate=" << choose( report_rates ) << "\n";
+				
+				// button mapping
+				for( auto& button : probe.button_names() ){
+					std::string value = pick( [this](){ return mapping(); },
+						[&]( const std::string& v ){ return probe.set_key_mapping( profile, button.first, v ) == 0; } );
+					if( !value.empty() )
+						output << button.second << "=" << value << "\n";
+				}
+			}
+		}
+		
+		// one action: key or mouse button press, movement or delay
+		std::vector< std::string > action(){
+			
+			const std::vector< std::string > buttons = { "mouse_left", "mouse_right", "mouse_middle", "mouse_backward", "mouse_forward" };
+			const std::vector< std::string > directions = { "move_left", "move_right", "move_up", "move_down" };
+			
+			switch( uniform( 0, 5 ) ){
+				case 0:
+				case 1:
+				case 2: {
+					std::string key = uniform( 0, 4 ) ? choose( _i_keys ) : choose( buttons );
+					return { "down\t" + key, "up\t" + key };
+				}
+				case 3:
+					return { choose( directions ) + "\t" + std::to_string( uniform( 1, 120 ) ) };
+				default:
+					return { "delay\t" + std::to_string( uniform( 1, 255 ) ) };
+			}
+		}
+		
+		// short macros are common, long ones overflow the slot, periodic ones repeat a sequence
+		void write_macro( std::ostream& output, const std::string& prefix ){
+			
+			std::vector< std::string > lines;
+			int kind = uniform( 0, 9 );
+			if( kind < 6 ){
+				for( int i = uniform( 1, 10 ); i > 0; i-- )
+					for( auto& line : action() )
+						lines.push_back( line );
+			} else if( kind < 8 ){
+				for( int i = uniform( 30, 80 ); i > 0; i-- )
+					for( auto& line : action() )
+						lines.push_back( line );
+			} else{
+				std::vector< std::string > period;
+				for( int i = uniform( 1, 4 ); i > 0; i-- )
+					for( auto& line : action() )
+						period.push_back( line );
+				period.push_back( "delay\t" + std::to_string( uniform( 1, 50 ) ) );
+				for( int i = uniform( 5, 60 ); i > 0; i-- )
+					lines.insert( lines.end(), period.begin(), period.end() );
+			}
+			
+			for( auto& line : lines )
+				output << prefix << line << "\n";
+		}
+		
+		void write_macros( std::ostream& output ){
+			
+			output << "\n# Macro definitions\n";
+			for( int i = 1; i < 16; i++ ){
+				if( uniform( 0, 2 ) != 0 )
+					continue;
+				output << "\n;## macro" << i << "\n";
+				write_macro( output, ";# " );
+			}
+		}
+};
+
+int main( int argc, char **argv ){
+	
+	if( argc < 2 ){
+		std::cerr << "usage: " << argv[0] << " <directory> [seed] [files per model]\n";
+		return 1;
+	}
+	
+	std::string directory = argv[1];
+	unsigned int seed = argc > 2 ? std::strtoul( argv[2], nullptr, 10 ) : 1;
+	int files = argc > 3 ? std::atoi( argv[3] ) : 20;
+	
+	// the models log an error for each macro slot they don't have
+	rd_log::set_level( rd_log::level_off );
+	
+	int generated = 0;
+	
+	try{
+		variant_loop< rd_mouse::mouse_variant >( [&]( auto m ){
+			
+			if constexpr( !std::is_same_v< decltype(m), rd_mouse::monostate > ){
+				generator g( seed, m.get_name() );
+				for( int i = 1; i <= files; i++ ){
+					g.generate< decltype(m) >( directory + "/" + m.get_name() + "_" + std::to_string( i ) );
+					generated++;
+				}
+			}
+		} );
+	} catch( std::string const &message ){
+		std::cerr << "Error: " << message << "\n";
+		return 1;
+	}
+	
+	std::cout << "generated " << generated << " configurations, macros and images with seed " << seed << " in " << directory << "\n";
+	
+	return 0;
+}
@@ -0,0 +1,132 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+
+#include "actions.h"
+
+std::atomic<bool> cancel_requested( false );
+
+extern "C" void cancel_handler( int signal ){
+	(void)signal;
+	cancel_requested = true;
+}
+
+void check_aborted( int result ){
+	if( result == rd_mouse::error_deadline_exceeded )
+		throw std::string( "Timeout: the deadline was exceeded, the operation was aborted." );
+	if( result == rd_mouse::error_cancelled )
+		throw std::string( "Cancelled: the operation was aborted." );
+}
+
+int macro_number( const std::string &string_number ){
+	
+	if( !std::regex_match( string_number, std::regex("[0-9]+") ) )
+		throw std::string( "Wrong argument, expected 1-15." );
+	
+	int number = (int)stoi(string_number);
+	if( number < 1 || number > 15 )
+		throw std::string( "Wrong argument, expected 1-15." );
+	
+	return number;
+}
+
+std::map< std::string, std::string > settings_fields( const std::string &ini ){
+	
+	std::map< std::string, std::string > fields;
+	std::istringstream input( ini );
+	std::string line, section;
+	
+	while( std::getline( input, line ) ){
+		
+		// skip comments and empty lines
+		if( line.empty() || line[0] == '#' || line[0] == ';' )
+			continue;
+		
+		if( line[0] == '[' && line.back() == ']' ){
+			section = line.substr( 1, line.length()-2 );
+		} else if( line.find( '=' ) != std::string::npos ){
+			size_t position = line.find( '=' );
+			fields[section+"."+line.substr( 0, position )] = line.substr( position+1 );
+		}
+	}
+	
+	return fields;
+}
+
+std::map< int, std::string > macro_sources( const rd_options& options ){
+	
+	std::ifstream input( options.string_macro );
+	if( !input.is_open() )
+		throw std::string( "Couldn't load macros." );
+	
+	std::map< int, std::string > sources;
+	
+	// --number: the whole file is one macro
+	if( options.flag_number ){
+		std::ostringstream source;
+		source << input.rdbuf();
+		sources[macro_number( options.string_number )] = source.str();
+		return sources;
+	}
+	
+	// otherwise split like set_all_macros: ;## macroN headers followed by ;# actions
+	int number = 0; // initially invalid
+	for( std::string line; std::getline( input, line ); ){
+		
+		if( std::regex_match( line, std::regex(";## macro[0-9]*") ) )
+			number = stoi( std::regex_replace( line, std::regex(";## macro"), "" ), 0, 10 );
+		
+		if( std::regex_match( line, std::regex(";# .*") ) && number >= 1 && number <= 15 )
+			sources[number] += line.substr( 3 )+"\n";
+	}
+	
+	return sources;
+}
+
+std::map< int, std::string > macro_names( const rd_options& options ){
+	
+	// the file name without directory and extension
+	std::string stem = options.string_macro.substr( options.string_macro.rfind( '/' ) + 1 );
+	if( stem.rfind( '.' ) != 0 && stem.rfind( '.' ) != std::string::npos )
+		stem = stem.substr( 0, stem.rfind( '.' ) );
+	
+	std::map< int, std::string > names;
+	
+	// --number: the whole file is one macro
+	if( options.flag_number ){
+		names[macro_number( options.string_number )] = stem;
+		return names;
+	}
+	
+	// a ;## name line after the ;## macroN header, otherwise <file>.macroN
+	for( auto& source : macro_sources( options ) )
+		names[source.first] = stem+".macro"+std::to_string( source.first );
+	
+	std::ifstream input( options.string_macro );
+	int number = 0;
+	for( std::string line; std::getline( input, line ); ){
+		
+		if( std::regex_match( line, std::regex(";## macro[0-9]*") ) )
+			number = stoi( std::regex_replace( line, std::regex(";## macro"), "" ), 0, 10 );
+		
+		if( std::regex_match( line, std::regex(";## name [^ ].*") ) && names.count( number ) )
+			names[number] = line.substr( 8 );
+	}
+	
+	return names;
+}
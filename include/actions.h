@@ -0,0 +1,937 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+
+#ifndef RD_ACTIONS
+#define RD_ACTIONS
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "rd_mouse.h"
+#include "device_store.h"
+#include "history.h"
+#include "load_config.h"
+#include "macro_bank.h"
+#include "stats.h"
+
+/* The actions of the command line that are performed on a mouse object.
+ * 
+ * main() parses the options into rd_options and calls the templates below
+ * for the detected model. In the monolithic build they are instantiated in
+ * mouse_m908.cpp for all models compiled in, in the plugin build in each
+ * model plugin (see plugin.h). Errors are thrown as std::string and
+ * handled in main().
+ */
+
+/// The options of the command line that are used by the actions on the mouse
+struct rd_options{
+	
+	bool flag_config = false, flag_profile = false;
+	bool flag_macro = false, flag_number = false;
+	bool flag_bus = false, flag_device = false;
+	bool flag_kernel_driver = false;
+	bool flag_dump_settings = false;
+	bool flag_read_settings = false;
+	bool flag_throttle = false;
+	bool flag_measure_jitter = false;
+	bool flag_timeout = false;
+	bool flag_dry_run = false;
+	bool flag_simulate = false;
+	bool flag_backup = false;
+	bool flag_restore = false;
+	bool flag_compress_macros = false;
+	bool flag_undo = false;
+	
+	std::string string_config, string_profile;
+	std::string string_macro, string_number;
+	std::string string_bus, string_device;
+	std::string string_dump, string_read;
+	std::string string_throttle;
+	std::string string_timeout;
+	std::string string_dry_run;
+	std::string string_compile_macros;
+	std::string string_backup, string_restore;
+	/// number of writes to roll back (--undo), empty for one
+	std::string string_undo;
+	/// settings memory of the simulated mouse (--simulate=<file>), empty for zeros
+	std::string string_simulate;
+	
+	/// dry run against a snapshot file (--dry-run=<file>)
+	bool snapshot = false;
+	/// no mouse is opened (snapshot or --simulate)
+	bool offline = false;
+	/// record the writes in a journal in the directory string_journal
+	bool journal = false;
+	std::string string_journal;
+	/// command of the resident mode: the mouse stays open after the actions and is only opened if it isn't
+	bool resident = false;
+};
+
+/// set by SIGINT and SIGTERM, cancels the running operation
+extern std::atomic<bool> cancel_requested;
+
+/// signal handler for SIGINT and SIGTERM
+extern "C" void cancel_handler( int signal );
+
+/// throws an error message if an operation was aborted
+void check_aborted( int result );
+
+/// parses the argument of --number (macro slot 1-15)
+int macro_number( const std::string &string_number );
+
+/// parses the output of print_settings into section.key -> value
+std::map< std::string, std::string > settings_fields( const std::string &ini );
+
+/// reads the macro file of --macro into slot number -> macro commands (all macros or only --number)
+std::map< int, std::string > macro_sources( const rd_options& options );
+
+/// names of the macros of --macro for a macro bank: the file name with --number, otherwise ;## name or <file>.macroN
+std::map< int, std::string > macro_names( const rd_options& options );
+
+/// whether the slot images of the macros are known (macro banks, --compress-macros), the slot codes of the M913 are missing
+template< typename T > constexpr bool has_macro_slots(){
+	return !std::is_same_v< T, mouse_m913 >;
+}
+
+/// loads a pre-encoded slot image, throws std::string for models without known macro slots
+template< typename T > int set_macro_image( T &m, int number, const std::array<uint8_t, 256>& image ){
+	if constexpr( has_macro_slots< T >() ){
+		return m.set_macro_raw( number, image );
+	} else{
+		(void)number;
+		(void)image;
+		throw std::string( "Pre-encoded macros are not supported for the "+m.get_name()+"." );
+	}
+}
+
+/** compresses the periodic macros of --macro (see rd_mouse::compress_macro) and prints
+ * how far each macro was compressed. The repeats of the buttons mapped to a compressed
+ * macro are multiplied if update_mappings is set, macros without such a mapping are not
+ * compressed. Otherwise (--compile-macros) the report names the mapping to use.
+ * Returns the slot images of the compressed macros, set them after the macros were loaded.
+ */
+template< typename T > std::map< int, std::array<uint8_t, 256> > compress_macros( T &m, const rd_options& options, const bool update_mappings ){
+	
+	if constexpr( !has_macro_slots< T >() )
+		throw std::string( "--compress-macros is not supported for the "+m.get_name()+"." );
+	
+	std::map< int, std::array<uint8_t, 256> > images;
+	
+	for( auto& source : macro_sources( options ) ){
+		
+		int number = source.first;
+		std::string name = "macro"+std::to_string( number );
+		
+		std::array< uint8_t, 256 > image;
+		if( m.get_macro_raw( number, image ) != 0 )
+			continue;
+		
+		std::istringstream input( source.second );
+		std::array< uint8_t, 256 > macro_bytes;
+		rd_mouse::macro_compression compression;
+		rd_mouse::compress_macro( macro_bytes, input, 8, compression );
+		
+		if( compression.actions == 0 )
+			continue;
+		
+		std::cout << name << ": " << compression.actions << " actions";
+		
+		if( compression.repeats == 1 ){
+			std::cout << ", no repeating sequence";
+			if( compression.dropped_actions != 0 )
+				std::cout << ", " << compression.dropped_actions << " actions don't fit into the slot";
+			std::cout << "\n";
+			continue;
+		}
+		
+		// the buttons that play this macro and their new repeats
+		std::vector< std::pair< std::pair<rd_mouse::rd_profile, int>, int > > buttons;
+		std::string problem;
+		
+		for( int i = 0; i < 5 && update_mappings && problem.empty(); i++ ){
+			
+			rd_mouse::rd_profile profile = (rd_mouse::rd_profile)i;
+			
+			for( auto& button : m.button_names() ){
+				
+				std::string mapping;
+				std::smatch match;
+				if( m.get_key_mapping( profile, button.first, mapping ) != 0 ||
+					!std::regex_match( mapping, match, std::regex( name+"(:([0-9]+|while|until))?" ) ) )
+					continue;
+				
+				if( match[2] == "while" || match[2] == "until" ){
+					problem = "mapped to "+mapping+" in profile "+std::to_string( i+1 );
+					break;
+				}
+				
+				int repeats = match[2].length() == 0 ? 1 : stoi( match[2] );
+				if( repeats * compression.repeats > 255 ){
+					problem = "mapped to "+mapping+" in profile "+std::to_string( i+1 )+", more than 255 repeats";
+					break;
+				}
+				
+				buttons.push_back( { { profile, button.first }, repeats * compression.repeats } );
+			}
+		}
+		
+		if( update_mappings && problem.empty() && buttons.empty() )
+			problem = "not mapped to a button";
+		
+		if( !problem.empty() ){
+			std::cout << ", repeating sequence not compressed (" << problem << ")";
+			if( compression.actions > compression.encoded_actions * compression.repeats )
+				std::cout << ", " << compression.actions - (compression.encoded_actions * compression.repeats) << " actions don't fit into the slot";
+			std::cout << "\n";
+			continue;
+		}
+		
+		for( auto& button : buttons ){
+			if( m.set_key_mapping( button.first.first, button.first.second, name+":"+std::to_string( button.second ) ) != 0 )
+				throw std::string( "Couldn't set the button mapping of "+name );
+		}
+		
+		std::cout << " -> " << compression.encoded_actions << " actions × " << compression.repeats << " repeats";
+		std::cout << " (" << std::fixed << std::setprecision(1) << (double)compression.actions / compression.encoded_actions << ":1)";
+		std::cout.unsetf( std::ios::floatfield );
+		
+		if( compression.exact_timing )
+			std::cout << ", timing exact";
+		else
+			std::cout << ", timing not exact (the last repetition ends with an extra delay of " << compression.added_delay << ")";
+		
+		if( compression.dropped_actions != 0 )
+			std::cout << ", " << compression.dropped_actions << " actions of the sequence don't fit into the slot";
+		
+		if( !update_mappings )
+			std::cout << ", map the buttons to " << name << ":" << compression.repeats << " (multiply existing repeats)";
+		
+		std::cout << "\n";
+		
+		std::copy( macro_bytes.begin()+8, macro_bytes.end(), image.begin()+8 );
+		images[number] = image;
+	}
+	
+	return images;
+}
+
+/// whether the memory layout of the model is known (--backup and --restore)
+template< typename T > constexpr bool has_memory_layout(){
+	return std::is_same_v< T, mouse_m908 >;
+}
+
+/// loads the macros (all or only --number) and writes them to a macro bank
+template< typename T >void compile_macro_bank( T &m, const rd_options& options ){
+	
+	if constexpr( !has_macro_slots< T >() )
+		throw std::string( "Macro banks are not supported for the "+m.get_name()+"." );
+	
+	// load and encode the macros
+	int number = 0;
+	if( options.flag_number ){
+		number = macro_number( options.string_number );
+		if( m.set_macro( number, options.string_macro ) != 0 )
+			throw std::string( "Couldn't load macro" );
+	} else if( m.set_all_macros( options.string_macro ) != 0 ){
+		throw std::string( "Couldn't load macros." );
+	}
+	
+	// replace the periodic macros by one period
+	if( options.flag_compress_macros ){
+		for( auto& image : compress_macros( m, options, false ) )
+			set_macro_image( m, image.first, image.second );
+	}
+	
+	// collect the slot images of the defined macros
+	std::map< int, std::string > names = macro_names( options );
+	std::vector< rd_macro_bank::macro > macros;
+	for( int i = 1; i < 16; i++ ){
+		
+		if( number != 0 && i != number )
+			continue;
+		
+		rd_macro_bank::macro macro;
+		macro.name = names.count( i ) ? names[i] : "macro"+std::to_string( i );
+		macro.number = i;
+		
+		if( m.get_macro_raw( i, macro.image ) != 0 )
+			continue;
+		
+		// macro not defined
+		if( macro.image[8] == 0 && macro.image[9] == 0 && macro.image[10] == 0 )
+			continue;
+		
+		macros.push_back( macro );
+	}
+	
+	if( macros.empty() )
+		throw std::string( "No macros found in "+options.string_macro );
+	
+	if( rd_macro_bank::compile( options.string_compile_macros, m.get_name(), macros ) != 0 )
+		throw std::string( "Couldn't write "+options.string_compile_macros );
+}
+
+/// applies the settings of a configuration file to the mouse object (nothing is sent)
+template< typename T >void apply_config( T &m, simple_ini_parser &pt ){
+	
+	for( int i = 1; i < 6; i++ ){
+		
+		rd_mouse::rd_profile profile = (rd_mouse::rd_profile)(i - 1);
+
+		for( auto& lightmode : m.lightmode_strings() ){
+			if( pt.get("profile"+std::to_string(i)+".lightmode", "") == lightmode.second )
+				m.set_lightmode( profile, lightmode.first );
+		}
+
+		if( std::regex_match( pt.get("profile"+std::to_string(i)+".color", ""), std::regex("[0-9a-fA-F]{6}") ) ){
+			m.set_color( profile,
+			{(uint8_t)stoi( pt.get("profile"+std::to_string(i)+".color", "").substr(0,2), 0, 16),
+			(uint8_t)stoi( pt.get("profile"+std::to_string(i)+".color", "").substr(2,2), 0, 16), 
+			(uint8_t)stoi( pt.get("profile"+std::to_string(i)+".color", "").substr(4,2), 0, 16)} );
+		}
+		
+		if( pt.get("profile"+std::to_string(i)+".brightness", "").length() != 0 ){
+			m.set_brightness( profile, (uint8_t)stoi( pt.get("profile"+std::to_string(i)+".brightness", ""), 0, 16) );
+		}
+		
+		if( pt.get("profile"+std::to_string(i)+".speed", "").length() != 0 ){
+			m.set_speed( profile, (uint8_t)stoi( pt.get("profile"+std::to_string(i)+".speed", ""), 0, 16) );
+		}
+		
+		if( pt.get("profile"+std::to_string(i)+".scrollspeed", "").length() != 0 ){
+			m.set_scrollspeed( profile, (uint8_t)stoi( pt.get("profile"+std::to_string(i)+".scrollspeed", ""), 0, 16) );
+		}
+		
+		// DPI
+		for( int j = 1; j < 6; j++ ){
+			
+			// DPI level disabled
+			if( pt.get("profile"+std::to_string(i)+".dpi"+std::to_string(j)+"_enable", "") == "0" )
+				m.set_dpi_enable( profile, j-1, false );
+			
+			// DPI value
+			if( pt.get("profile"+std::to_string(i)+".dpi"+std::to_string(j), "").length() != 0 ){ // non-empty dpi value
+				
+				if( m.set_dpi( profile, j-1, pt.get("profile"+std::to_string(i)+".dpi"+std::to_string(j), "") ) != 0 ) // if invalid dpi value
+					std::cerr << "Warning: Unknown DPI value " << pt.get("profile"+std::to_string(i)+".dpi"+std::to_string(j), "") << "\n";
+			}
+		}
+		
+		for( auto& report_rate : m.report_rate_strings() ){
+			if( pt.get("profile"+std::to_string(i)+".report_rate", "") == report_rate.second )
+				m.set_report_rate( profile, report_rate.first );
+		}
+
+		// button mapping
+		for( auto key : m.button_names() ){
+			if( pt.get("profile"+std::to_string(i)+"."+key.second, "").length() != 0 ){ m.set_key_mapping( profile, key.first, pt.get("profile"+std::to_string(i)+"."+key.second, "") );	}
+		}
+		
+	}
+}
+
+/// checks its arguments and opens the mouse accordingly (with vid and pid or with bus and device)
+template< typename T >int open_mouse_wrapper( T &m, const bool flag_bus, const bool flag_device,
+	const std::string &string_bus, const std::string &string_device ){
+	
+	int open_return = 0; // open_mouse() return value
+	
+	if( flag_bus != flag_device ){ // improper arguments
+		
+		throw std::string( "Missing argument, --bus and --device must be used together." );
+		return 1;
+		
+	} else if( flag_bus && flag_device ){ // open with bus and device
+		
+		if( !std::regex_match( string_bus, std::regex("[0-9]+") ) ||
+			!std::regex_match( string_device, std::regex("[0-9]+") ) ){
+			
+			throw std::string( "Wrong argument, expected number." );
+			return 1;
+		}
+		
+		open_return = m.open_mouse_bus_device( stoi(string_bus), stoi(string_device) );
+		
+	} else{ // open with vid and pid
+		
+		open_return = m.open_mouse();
+		
+	}
+	
+	// Could not open → print message
+	if( open_return != 0 ){
+		
+		throw std::string(
+			"Couldn't open mouse.\n"
+			"- Check hardware and permissions (maybe you need to be root?)\n"
+			"- Try with or without the --kernel-driver option\n"
+			"- Try with the --model option\n"
+			"- Try with the --bus and --device options\n"
+			"If nothing works please report this as a bug."
+		);
+		
+		return 1;
+	}
+	
+	return 0;
+}
+
+/// performs all actions of the command line on the mouse
+template< typename T >void perform_actions( T &m, const rd_options &options, rd_stats &stats ){
+	
+	// the USB transfers are a phase of their own, the other phases only measure the CPU-side work
+	m.set_stats( &stats );
+	struct stats_reset{
+		T& m;
+		~stats_reset(){ m.set_stats( nullptr ); }
+	} reset_stats{ m };
+
+	// set whether to detach kernel driver
+	m.set_detach_kernel_driver( !options.flag_kernel_driver );
+	
+	// limit the configuration traffic: transfers per ms or duty cycle in percent
+	if( options.flag_throttle ){
+		if( std::regex_match( options.string_throttle, std::regex("[0-9]*\\.?[0-9]+/ms") ) )
+			m.set_throttle_rate( std::stod( options.string_throttle ) );
+		else if( std::regex_match( options.string_throttle, std::regex("[0-9]*\\.?[0-9]+%") ) && std::stod( options.string_throttle ) > 0 )
+			m.set_throttle_duty_cycle( std::stod( options.string_throttle ) / 100.0 );
+		else
+			throw std::string( "Wrong argument, expected <transfers>/ms or <duty cycle>%." );
+	}
+	
+	// time limit for all actions in ms
+	if( options.flag_timeout ){
+		if( !std::regex_match( options.string_timeout, std::regex("[0-9]+") ) )
+			throw std::string( "Wrong argument, expected number." );
+		
+		m.set_deadline( std::chrono::steady_clock::now() + std::chrono::milliseconds( std::stoul( options.string_timeout ) ) );
+	}
+	
+	// SIGINT and SIGTERM cancel the actions cleanly, a second signal terminates immediately
+	struct sigaction action = {};
+	action.sa_handler = cancel_handler;
+	action.sa_flags = SA_RESETHAND;
+	sigaction( SIGINT, &action, nullptr );
+	sigaction( SIGTERM, &action, nullptr );
+	m.set_cancellation_token( &cancel_requested );
+	
+	// resident mode: the mouse is still open, the interfaces are claimed again if they were released while idle
+	if( options.resident && m.is_open() && m.claim_interfaces() != 0 )
+		m.close_mouse();
+	
+	// open mouse, throws std::string in case of an error, handling in main()
+	if( !options.offline && !m.is_open() )
+		open_mouse_wrapper( m, options.flag_bus, options.flag_device, options.string_bus, options.string_device );
+	
+	// simulated mouse: the dry run transport without output, in transfers return zeros or the bytes of the memory image
+	if( options.flag_simulate ){
+		m.set_dry_run( true );
+		
+		if( !options.string_simulate.empty() ){
+			std::ifstream in( options.string_simulate );
+			if( !in.is_open() )
+				throw std::string( "Couldn't open "+options.string_simulate );
+			
+			rd_mouse::memory_image memory;
+			std::string model;
+			if( rd_mouse::parse_memory_rows( in, memory, model ) != 0 || model != m.get_name() )
+				throw std::string( "Invalid memory image for the "+m.get_name()+": "+options.string_simulate );
+			m.set_simulated_memory( memory );
+		}
+	}
+	
+	// one journal and undo history per model in the state directory of the device (serial number or USB port)
+	std::string journal_file, history_file;
+	if( options.journal ){
+		rd_device_store store( options.string_journal );
+		std::string directory = store.find( m.get_device_id(), true );
+		if( directory.empty() )
+			directory = options.string_journal;
+		journal_file = directory + "/" + m.get_name() + ".journal";
+		history_file = directory + "/" + m.get_name() + ".history";
+	}
+	
+	if( options.flag_undo && !options.journal )
+		throw std::string( "Wrong options, --undo needs the undo history, it is kept next to the write journal (not with --journal=off or --dry-run)." );
+	
+	try{
+		// finish a write that was interrupted (process killed, mouse disconnected)
+		if( options.journal ){
+			
+			size_t remaining = 0;
+			stats.begin( "write" );
+			int r = m.resume_journal( journal_file, remaining );
+			stats.end();
+			check_aborted( r );
+			
+			if( r != 0 )
+				throw std::string( "Couldn't finish the interrupted write from "+journal_file+", run again to retry." );
+			if( remaining > 0 )
+				std::cerr << "Finished an interrupted write: " << remaining << " rows from " << journal_file << "\n";
+		}
+		
+		// record the pointer reports while the other actions are performed
+		if( options.flag_measure_jitter && m.start_jitter_measurement() != 0 )
+			std::cerr << "Warning: Couldn't start jitter measurement\n";
+		
+		// read settings and dump raw data
+		if( options.flag_dump_settings ){
+			
+			// dump to file or cout
+			if( options.string_dump != "-" ){
+				std::ofstream out( options.string_dump );
+				
+				if( out.is_open() ){				
+					// dump settings
+					stats.begin( "dump" );
+					check_aborted( m.dump_settings( out ) );
+					stats.end();
+				
+					out.close();
+				} else{
+					throw std::string( "Couldn't open "+options.string_dump );
+				}
+			} else{
+				stats.begin( "dump" );
+				check_aborted( m.dump_settings( std::cout ) );
+				stats.end();
+			}
+			
+		}
+		
+		// read settings and print in .ini format
+		if( options.flag_read_settings ){
+			
+			// dump to file or cout
+			if( options.string_read != "-" ){
+				std::ofstream out( options.string_read );
+				
+				if( out.is_open() ){
+					out << "# Model: " << m.get_name() << "\n";
+					// read settings
+					stats.begin( "decode" );
+					check_aborted( m.read_and_print_settings( out ) );
+					stats.end();
+				
+					out.close();
+				} else{
+					throw std::string( "Couldn't open "+options.string_read );
+				}
+			} else{
+				std::cout << "# Model: " << m.get_name() << "\n";
+				stats.begin( "decode" );
+				check_aborted( m.read_and_print_settings( std::cout ) );
+				stats.end();
+			}
+			
+			// transfers saved by skipping the empty macro slots
+			rd_mouse::readback_stats readback = m.get_readback_stats();
+			if( readback.transfers > 0 )
+				std::cerr << "Macro memory: " << readback.transfers - readback.skipped << " of " << readback.transfers
+					<< " transfers, " << readback.skipped << " skipped (empty macro slots)\n";
+			
+		}
+		
+		// backup: the settings memory without decoding, for --restore
+		if( options.flag_backup ){
+			
+			if constexpr( has_memory_layout< std::decay_t<decltype(m)> >() ){
+				
+				std::map< uint16_t, uint8_t > memory;
+				stats.begin( "decode" );
+				check_aborted( m.read_memory( memory ) );
+				stats.end();
+				
+				if( options.string_backup != "-" ){
+					std::ofstream out( options.string_backup );
+					if( !out.is_open() )
+						throw std::string( "Couldn't open "+options.string_backup );
+					m.print_memory( memory, out );
+				} else{
+					m.print_memory( memory, std::cout );
+				}
+				
+			} else{
+				throw std::string( "Backups are not supported for the "+m.get_name()+"." );
+			}
+		}
+		
+		// restore: read the backup and the current memory of the mouse, only the rows that differ are written below
+		std::map< uint16_t, uint8_t > restore_target, restore_current;
+		if( options.flag_restore ){
+			
+			if constexpr( has_memory_layout< std::decay_t<decltype(m)> >() ){
+				
+				std::ifstream in( options.string_restore );
+				if( !in.is_open() )
+					throw std::string( "Couldn't open "+options.string_restore );
+				if( m.parse_memory( in, restore_target ) != 0 )
+					throw std::string( "Invalid backup for the "+m.get_name()+": "+options.string_restore );
+				
+				stats.begin( "decode" );
+				check_aborted( m.read_memory( restore_current ) );
+				stats.end();
+				
+			} else{
+				throw std::string( "Backups are not supported for the "+m.get_name()+"." );
+			}
+		}
+		
+		// undo history: the values before a write are read back from the rows it writes, just before it is sent
+		rd_history history( history_file );
+		bool record_history = false;
+		std::map< uint16_t, uint8_t > undo_target, undo_current;
+		size_t undo_count = 0;
+		
+		// the bytes read from the mouse replace the known ones, bytes that can't be read back are kept
+		auto update_memory = [&history]( const std::map< uint16_t, uint8_t >& current ){
+			std::map< uint16_t, uint8_t > memory = history.memory();
+			for( auto& byte : current )
+				memory[byte.first] = byte.second;
+			history.set_memory( memory );
+		};
+		
+		if constexpr( has_memory_layout< std::decay_t<decltype(m)> >() ){
+			
+			record_history = options.journal &&
+				(options.flag_config || options.flag_macro || options.flag_profile || options.flag_restore || options.flag_undo);
+			if( record_history && history.load() != 0 )
+				std::cerr << "Warning: Invalid undo history " << history_file << ", starting a new one\n";
+			
+			if( options.flag_undo ){
+				
+				if( options.string_undo != "" && !std::regex_match( options.string_undo, std::regex("[1-9][0-9]*") ) )
+					throw std::string( "Wrong argument, expected number." );
+				undo_count = options.string_undo != "" ? std::stoul( options.string_undo ) : 1;
+				if( undo_count > history.size() )
+					throw std::string( "Can't undo "+std::to_string( undo_count )+" writes, the undo history of the "+m.get_name()+" has "+std::to_string( history.size() )+"." );
+				
+				// the rows are compared with the mouse, not with the known memory
+				stats.begin( "decode" );
+				check_aborted( m.read_memory( undo_current ) );
+				stats.end();
+				update_memory( undo_current );
+				undo_target = history.target( undo_count );
+				
+			} else if( options.flag_restore ){
+				update_memory( restore_current );
+			}
+			
+		} else if( options.flag_undo ){
+			throw std::string( "Undo is not supported for the "+m.get_name()+"." );
+		}
+		
+		// dry run: settings of the snapshot or read back from the mouse, the following transfers are only printed
+		std::string baseline;
+		std::ostringstream dry_run_rows;
+		if( options.flag_dry_run ){
+			
+			if( options.snapshot ){
+				simple_ini_parser snapshot_ini;
+				if( snapshot_ini.read_ini( options.string_dry_run ) != 0 )
+					throw std::string( "Couldn't open "+options.string_dry_run );
+				apply_config( m, snapshot_ini );
+			} else{
+				stats.begin( "decode" );
+				check_aborted( m.read_settings() );
+				stats.end();
+			}
+			
+			std::ostringstream settings;
+			m.print_settings( settings );
+			baseline = settings.str();
+			
+			m.set_dry_run( true, &dry_run_rows );
+		}
+		
+		// the following writes are recorded and sent together with the journal
+		if( options.journal )
+			m.begin_journal( journal_file );
+		
+		// write the rows of the backup that differ from the mouse
+		if( options.flag_restore ){
+			
+			if constexpr( has_memory_layout< std::decay_t<decltype(m)> >() ){
+				
+				size_t rows = 0;
+				stats.begin( "write" );
+				check_aborted( m.write_memory( restore_target, restore_current, rows ) );
+				stats.end();
+				
+				if( rows == 0 )
+					std::cerr << "The mouse already matches the backup, nothing to restore.\n";
+			}
+		}
+		
+		// roll back the newest writes of the history, only the rows that differ from the mouse are written
+		if( options.flag_undo ){
+			
+			if constexpr( has_memory_layout< std::decay_t<decltype(m)> >() ){
+				
+				size_t rows = 0;
+				stats.begin( "write" );
+				check_aborted( m.write_memory( undo_target, undo_current, rows ) );
+				stats.end();
+				
+				std::cerr << "Undo " << undo_count << (undo_count == 1 ? " write: " : " writes: ") << rows << " rows sent\n";
+			}
+		}
+		
+		// macros compressed by --compress-macros, they replace the macros loaded below
+		std::map< int, std::array<uint8_t, 256> > compressed_macros;
+		
+		// load and write config
+		if( options.flag_config ){
+			
+			stats.begin( "ini" );
+			simple_ini_parser pt;
+			if( pt.read_ini( options.string_config ) != 0 )
+				throw std::string( "Could not open configuration file." );
+			
+			//parse config file
+			stats.begin( "setters" );
+			apply_config( m, pt );
+			
+			// compress the macros before the settings are written, this changes the button mappings
+			if( options.flag_compress_macros ){
+				stats.begin( "macro encoding" );
+				compressed_macros = compress_macros( m, options, true );
+			}
+			
+			// write settings
+			stats.begin( "write" );
+			check_aborted( m.write_settings() );
+			stats.end();
+			
+		}
+		
+		// change active profile
+		if( options.flag_profile ){
+			
+			// set profile
+			if( !std::regex_match( options.string_profile, std::regex("[1-5]") ) )
+				throw std::string( "Wrong argument, expected 1-5." );
+
+			m.set_profile( (rd_mouse::rd_profile)(std::stoi(options.string_profile) - 1) );
+
+			// write profile
+			stats.begin( "write" );
+			check_aborted( m.write_profile() );
+			stats.end();
+			
+		}
+		
+		// send the macros from a compiled macro bank, no parsing or encoding
+		if( options.flag_macro && rd_macro_bank::is_macro_bank( options.string_macro ) ){
+			
+			rd_macro_bank bank;
+			if( bank.open( options.string_macro ) != 0 )
+				throw std::string( "Invalid macro bank: "+options.string_macro );
+			
+			if( bank.model() != m.get_name() )
+				throw std::string( "The macro bank was compiled for the "+bank.model()+", not the "+m.get_name()+"." );
+			
+			// with --number only this slot
+			int number = options.flag_number ? macro_number( options.string_number ) : 0;
+			
+			stats.begin( "macro bank" );
+			std::vector< int > slots;
+			for( size_t i = 0; i < bank.size(); i++ ){
+				
+				if( number != 0 && bank.number(i) != number )
+					continue;
+				
+				std::array< uint8_t, 256 > image;
+				std::copy_n( bank.image(i), image.size(), image.begin() );
+				
+				if( set_macro_image( m, bank.number(i), image ) != 0 )
+					throw std::string( "Invalid macro bank: "+bank.name(i)+" doesn't match the macro slots of the "+m.get_name()+"." );
+				
+				slots.push_back( bank.number(i) );
+			}
+			
+			if( slots.empty() )
+				throw std::string( "No matching macros in "+options.string_macro );
+			
+			// write macros
+			stats.begin( "write" );
+			for( int slot : slots )
+				check_aborted( m.write_macro( slot ) );
+			stats.end();
+			
+		// send all macros
+		} else if( options.flag_macro && !options.flag_number ){
+			
+			// load macros
+			stats.begin( "macro encoding" );
+			int r = m.set_all_macros( options.string_macro );
+			
+			if( r != 0 )
+				throw std::string( "Couldn't load macros." );
+			
+			for( auto& image : compressed_macros )
+				set_macro_image( m, image.first, image.second );
+			
+			// write macros
+			stats.begin( "write" );
+			for( int i = 1; i < 16; i++ )
+				check_aborted( m.write_macro(i) );
+			stats.end();
+			
+		// send individual macro
+		} else if( options.flag_macro && options.flag_number ){
+			
+			
+			// set macro and macro slot (number)
+			int number = macro_number( options.string_number );
+			
+			stats.begin( "macro encoding" );
+			if( m.set_macro( number, options.string_macro ) != 0 )
+				throw std::string( "Couldn't load macro" );
+			
+			for( auto& image : compressed_macros )
+				set_macro_image( m, image.first, image.second );
+			
+			// write macro
+			stats.begin( "write" );
+			check_aborted( m.write_macro(number) );
+			stats.end();
+			
+		} else if( !options.flag_macro && options.flag_number ){
+			throw std::string( "Misssing option, --macro and --number must be used together." );
+		}
+		
+		// the history is updated before the writes are sent, a failed write is finished from the journal
+		if( record_history ){
+			
+			if( options.flag_undo ){
+				history.remove( undo_count );
+			} else{
+				
+				std::map< uint16_t, uint8_t > written = m.get_journal_memory();
+				
+				// the rows about to be written are read from the mouse, the known memory may be outdated (other software, --journal=off)
+				if constexpr( has_memory_layout< std::decay_t<decltype(m)> >() ){
+					if( !options.flag_restore && !written.empty() ){
+						std::map< uint16_t, uint8_t > before;
+						m.set_journal_recording( false );
+						stats.begin( "decode" );
+						check_aborted( m.read_memory( before, &written ) );
+						stats.end();
+						m.set_journal_recording( true );
+						update_memory( before );
+					}
+				}
+				
+				history.record( written );
+			}
+			
+			if( history.save() != 0 )
+				std::cerr << "Warning: Couldn't write the undo history " << history_file << "\n";
+		}
+		
+		// send the recorded writes, the journal is kept if a transfer fails
+		if( options.journal ){
+			stats.begin( "write" );
+			int r = m.commit_journal();
+			stats.end();
+			check_aborted( r );
+			
+			if( r != 0 )
+				throw std::string( "Writing failed, run again to send the remaining rows from "+journal_file+"." );
+		}
+		
+		// print the changed settings, the rows that would be sent and the estimated cost
+		if( options.flag_dry_run ){
+			
+			std::ostringstream settings;
+			m.print_settings( settings );
+			auto before = settings_fields( baseline );
+			auto after = settings_fields( settings.str() );
+			
+			std::cout << "Changed settings:\n";
+			int changes = 0;
+			for( auto& field : after ){
+				if( before[field.first] != field.second ){
+					std::cout << "  " << field.first << ": " << before[field.first] << " -> " << field.second << "\n";
+					changes++;
+				}
+			}
+			if( changes == 0 )
+				std::cout << "  none\n";
+			
+			std::cout << "Transfers:\n" << dry_run_rows.str();
+			
+			// measured during the read back, nominal 1 ms (full speed control transfer) for snapshots
+			double latency = m.get_transfer_latency();
+			bool measured = latency > 0;
+			if( !measured )
+				latency = 1000;
+			
+			rd_mouse::dry_run_stats cost = m.get_dry_run_stats();
+			std::cout << "Total: " << cost.transfers << " transfers, " << cost.bytes << " bytes, estimated "
+				<< m.estimate_transfer_time( cost.transfers, latency ) / 1000.0 << " ms ("
+				<< latency << " µs per transfer, " << (measured ? "measured" : "nominal") << ")\n";
+			
+			m.set_dry_run( options.flag_simulate );
+		}
+		
+		// print the timing of the pointer reports
+		rd_mouse::jitter_stats jitter;
+		if( options.flag_measure_jitter && m.stop_jitter_measurement( jitter ) == 0 ){
+			std::cerr << "Pointer reports: " << jitter.reports << "\n";
+			std::cerr << "Interval mean: " << jitter.mean_interval << " µs\n";
+			std::cerr << "Interval standard deviation: " << jitter.stddev_interval << " µs\n";
+			std::cerr << "Interval max: " << jitter.max_interval << " µs\n";
+		}
+	
+	
+	// error handling
+	} catch( std::string const &message ){ // close mouse, rethrow
+		
+		if( !options.offline )
+			m.close_mouse();
+		throw;
+		
+	} catch( std::exception const &e ){ // close mouse, rethrow
+		
+		if( !options.offline )
+			m.close_mouse();
+		throw;
+		
+	}
+	
+	// close mouse, the resident mode keeps it open for the next command
+	if( !options.offline && !options.resident )
+		m.close_mouse();
+}
+
+#endif
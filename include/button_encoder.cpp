@@ -0,0 +1,274 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+
+#include "button_encoder.h"
+
+#include <climits>
+
+rd_button_encoder::rd_button_encoder( const std::map< std::string, std::array<uint8_t, 4> >& keycodes,
+	const std::map< std::string, uint8_t >& modifiers,
+	const std::map< std::string, uint8_t >& keys,
+	const std::map< int, uint8_t >& snipe_dpi ) :
+	_i_keycodes( keycodes ),
+	_i_modifiers( modifiers ),
+	_i_keys( keys ),
+	_i_snipe_dpi( snipe_dpi ){
+}
+
+size_t rd_button_encoder::_i_split( std::string_view text, char delimiter, std::string_view* fields, size_t max_fields ){
+	
+	size_t count = 0;
+	size_t start = 0;
+	
+	while( count < max_fields && start < text.size() ){
+		
+		size_t end = text.find( delimiter, start );
+		if( end == std::string_view::npos )
+			end = text.size();
+		
+		fields[count++] = text.substr( start, end - start );
+		start = end + 1;
+	}
+	
+	return count;
+}
+
+bool rd_button_encoder::_i_parse_int( std::string_view text, int& value ){
+	
+	size_t i = 0;
+	while( i < text.size() && ( text[i] == ' ' || ( text[i] >= '\t' && text[i] <= '\r' ) ) )
+		i++;
+	
+	bool negative = false;
+	if( i < text.size() && ( text[i] == '+' || text[i] == '-' ) ){
+		negative = text[i] == '-';
+		i++;
+	}
+	
+	// no digits or out of range: std::stoi throws
+	size_t first_digit = i;
+	long long result = 0;
+	while( i < text.size() && text[i] >= '0' && text[i] <= '9' ){
+		result = result * 10 + ( text[i] - '0' );
+		if( result > (long long)INT_MAX + 1 )
+			return false;
+		i++;
+	}
+	
+	if( i == first_digit )
+		return false;
+	if( negative )
+		result = -result;
+	if( result > INT_MAX || result < INT_MIN )
+		return false;
+	
+	value = (int)result;
+	return true;
+}
+
+size_t rd_button_encoder::_i_parse_macro_number( std::string_view mapping, int& number ){
+	
+	if( mapping.substr( 0, 5 ) != "macro" || mapping.size() < 6 )
+		return 0;
+	
+	// macro1 - macro9
+	if( mapping[5] < '1' || mapping[5] > '9' )
+		return 0;
+	number = mapping[5] - '0';
+	
+	// macro10 - macro15
+	if( number == 1 && mapping.size() > 6 && mapping[6] >= '0' && mapping[6] <= '5' ){
+		number = 10 + mapping[6] - '0';
+		return 7;
+	}
+	
+	return 6;
+}
+
+int rd_button_encoder::encode( std::string_view mapping, std::array<uint8_t, 4>& bytes ) const{
+	
+	// raw byte values: 0x followed by 8 hex digits
+	if( mapping.size() == 10 && mapping[0] == '0' && mapping[1] == 'x' ){
+		
+		std::array<uint8_t, 4> raw_bytes;
+		bool valid = true;
+		
+		for( size_t i = 2; i < 10 && valid; i++ ){
+			
+			char c = mapping[i];
+			uint8_t nibble = 0;
+			
+			if( c >= '0' && c <= '9' )
+				nibble = c - '0';
+			else if( c >= 'a' && c <= 'f' )
+				nibble = c - 'a' + 10;
+			else if( c >= 'A' && c <= 'F' )
+				nibble = c - 'A' + 10;
+			else
+				valid = false;
+			
+			raw_bytes[(i-2)/2] = ( (i % 2) == 0 ) ? nibble << 4 : raw_bytes[(i-2)/2] | nibble;
+		}
+		
+		if( valid ){
+			bytes = raw_bytes;
+			return 0;
+		}
+	}
+	
+	// mousebuttons/special functions and media controls
+	if( const std::array<uint8_t, 4>* keycode = _i_keycodes.find( mapping ) ){
+		bytes = *keycode;
+		return 0;
+	}
+	
+	// fire button (multiple keypresses): fire:button:repeats:delay, the first field is skipped
+	if( mapping.substr( 0, 4 ) == "fire" ){
+		
+		std::string_view fields[4];
+		_i_split( mapping, ':', fields, 4 );
+		
+		uint8_t keycode;
+		if( fields[1] == "mouse_left" ){
+			keycode = 0x81;
+		} else if( fields[1] == "mouse_right" ){
+			keycode = 0x82;
+		} else if( fields[1] == "mouse_middle" ){
+			keycode = 0x84;
+		} else if( const uint8_t* key = _i_keys.find( fields[1] ) ){
+			keycode = *key;
+		} else{
+			return 1;
+		}
+		
+		int repeats, delay;
+		if( !_i_parse_int( fields[2], repeats ) || !_i_parse_int( fields[3], delay ) )
+			return 1;
+		
+		bytes[0] = 0x99;
+		bytes[1] = keycode;
+		bytes[2] = (uint8_t)repeats;
+		bytes[3] = (uint8_t)delay;
+		return 0;
+	}
+	
+	// snipe button (changes dpi while pressed): every "snipe:" is removed, the rest is the DPI value
+	if( mapping.substr( 0, 5 ) == "snipe" ){
+		
+		std::string dpi_string;
+		for( size_t i = 0; i < mapping.size(); ){
+			if( mapping.compare( i, 6, "snipe:" ) == 0 ){
+				i += 6;
+			} else{
+				dpi_string += mapping[i];
+				i++;
+			}
+		}
+		
+		int dpi_value;
+		if( !_i_parse_int( dpi_string, dpi_value ) )
+			return 1;
+		
+		auto dpi_byte = _i_snipe_dpi.find( dpi_value );
+		if( dpi_byte == _i_snipe_dpi.end() )
+			return 1;
+		
+		bytes[0] = 0x9a;
+		bytes[1] = 0x01;
+		bytes[2] = dpi_byte->second;
+		bytes[3] = dpi_byte->second;
+		return 0;
+	}
+	
+	// macro: macroN, macroN:repeats, macroN:until or macroN:while
+	int macro_number;
+	if( size_t length = _i_parse_macro_number( mapping, macro_number ) ){
+		
+		std::string_view suffix = mapping.substr( length );
+		
+		if( suffix.empty() ){
+			bytes = { 0x91, (uint8_t)(macro_number - 1), 0x01, 0x00 };
+			return 0;
+		}
+		
+		if( suffix == ":until" ){
+			bytes = { 0x91, (uint8_t)(macro_number + 0x3f), 0xff, 0xff };
+			return 0;
+		}
+		
+		if( suffix == ":while" ){
+			bytes = { 0x91, (uint8_t)(macro_number + 0x7f), 0xff, 0xff };
+			return 0;
+		}
+		
+		if( suffix.size() > 1 && suffix[0] == ':' &&
+			suffix.find_first_not_of( "0123456789", 1 ) == std::string_view::npos ){
+			
+			int repeats;
+			if( !_i_parse_int( suffix.substr( 1 ), repeats ) )
+				return 1;
+			
+			bytes = { 0x91, (uint8_t)(macro_number - 1), (uint8_t)repeats, 0x00 };
+			return 0;
+		}
+	}
+	
+	// keyboard key (+ modifiers): every modifier that ends at a '+' is added,
+	// every '+' is removed together with the lowercase name in front of it
+	uint8_t first_value = 0x90;
+	uint8_t modifier_value = 0x00;
+	
+	// the key name is built in key_buffer, long mappings use a string
+	char key_buffer[64];
+	std::string long_key;
+	char* key = key_buffer;
+	size_t key_length = 0;
+	if( mapping.size() > sizeof(key_buffer) ){
+		long_key.resize( mapping.size() );
+		key = &long_key[0];
+	}
+	
+	for( size_t i = 0; i < mapping.size(); i++ ){
+		
+		if( mapping[i] != '+' ){
+			key[key_length++] = mapping[i];
+			continue;
+		}
+		
+		for( size_t length = _i_modifiers.min_length(); length <= _i_modifiers.max_length() && length <= i + 1; length++ ){
+			if( const uint8_t* modifier = _i_modifiers.find( mapping.substr( i + 1 - length, length ) ) ){
+				modifier_value |= *modifier;
+				first_value = 0x8f;
+			}
+		}
+		
+		while( key_length > 0 && ( ( key[key_length-1] >= 'a' && key[key_length-1] <= 'z' ) || key[key_length-1] == '_' ) )
+			key_length--;
+	}
+	
+	// unknown keys are encoded as 0x00
+	const uint8_t* key_value = _i_keys.find( std::string_view( key, key_length ) );
+	
+	bytes[0] = first_value;
+	bytes[1] = modifier_value;
+	bytes[2] = key_value ? *key_value : 0x00;
+	bytes[3] = 0x00;
+	
+	return 0;
+}
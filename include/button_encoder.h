@@ -0,0 +1,245 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+
+#ifndef RD_BUTTON_ENCODER
+#define RD_BUTTON_ENCODER
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * A perfect hash table for a fixed set of string keys (hash and
+ * displace): the keys are distributed to buckets by their hash, every
+ * bucket stores a seed that is mixed into the hash to place its keys in
+ * distinct slots. A lookup hashes the key once and compares one key.
+ * 
+ * The table is built once from a std::map and can not be modified.
+ */
+template< typename value_type > class rd_perfect_hash{
+	
+	public:
+		
+		/// Build the table from the keys and values of a map
+		template< typename map_type > explicit rd_perfect_hash( const map_type& entries );
+		
+		/// Returns the value for key or nullptr if key is not in the table
+		const value_type* find( std::string_view key ) const{
+			
+			if( _i_keys.empty() )
+				return nullptr;
+			
+			uint64_t hash = _i_hash( key );
+			uint32_t slot = _i_slot( hash, _i_seeds[ _i_bucket( hash ) ], _i_keys.size() );
+			
+			if( _i_used[slot] && _i_keys[slot] == key )
+				return &_i_values[slot];
+			
+			return nullptr;
+		}
+		
+		/// Length of the shortest key
+		size_t min_length() const{ return _i_min_length; }
+		/// Length of the longest key
+		size_t max_length() const{ return _i_max_length; }
+		
+	private:
+		
+		/// FNV-1a, computed once per lookup
+		static uint64_t _i_hash( std::string_view key ){
+			
+			uint64_t hash = 14695981039346656037ull;
+			for( char c : key ){
+				hash ^= (uint8_t)c;
+				hash *= 1099511628211ull;
+			}
+			
+			return hash;
+		}
+		
+		/// Bucket of a key, from the upper bits of the hash
+		uint32_t _i_bucket( uint64_t hash ) const{
+			return ( hash >> 32 ) & ( _i_seeds.size() - 1 );
+		}
+		
+		/// Slot of a key, the hash mixed with the seed of its bucket
+		static uint32_t _i_slot( uint64_t hash, uint32_t seed, size_t slots ){
+			
+			hash ^= seed * 0x9e3779b97f4a7c15ull;
+			hash ^= hash >> 33;
+			hash *= 0xff51afd7ed558ccdull;
+			hash ^= hash >> 33;
+			
+			return hash & ( slots - 1 );
+		}
+		
+		/// Tries to place all keys with slots slots, returns false if a bucket found no seed
+		bool _i_build( const std::vector< std::pair< std::string, value_type > >& entries, size_t slots );
+		
+		std::vector< uint32_t > _i_seeds;
+		std::vector< std::string > _i_keys;
+		std::vector< value_type > _i_values;
+		std::vector< bool > _i_used;
+		size_t _i_min_length = 0, _i_max_length = 0;
+};
+
+template< typename value_type > template< typename map_type >
+rd_perfect_hash< value_type >::rd_perfect_hash( const map_type& entries ){
+	
+	std::vector< std::pair< std::string, value_type > > pairs( entries.begin(), entries.end() );
+	if( pairs.empty() )
+		return;
+	
+	_i_min_length = pairs[0].first.size();
+	for( auto& entry : pairs ){
+		_i_min_length = std::min( _i_min_length, entry.first.size() );
+		_i_max_length = std::max( _i_max_length, entry.first.size() );
+	}
+	
+	// load factor <= 0.5, a larger table if the seed search fails
+	size_t slots = 1;
+	while( slots < 2 * pairs.size() )
+		slots *= 2;
+	while( !_i_build( pairs, slots ) )
+		slots *= 2;
+}
+
+template< typename value_type >
+bool rd_perfect_hash< value_type >::_i_build( const std::vector< std::pair< std::string, value_type > >& entries, size_t slots ){
+	
+	// about four keys per bucket
+	size_t bucket_count = 1;
+	while( bucket_count * 4 < entries.size() )
+		bucket_count *= 2;
+	
+	_i_seeds.assign( bucket_count, 0 );
+	
+	std::vector< uint64_t > hashes( entries.size() );
+	std::vector< std::vector< size_t > > buckets( bucket_count );
+	for( size_t i = 0; i < entries.size(); i++ ){
+		hashes[i] = _i_hash( entries[i].first );
+		buckets[ _i_bucket( hashes[i] ) ].push_back( i );
+	}
+	
+	// place the largest buckets first
+	std::vector< size_t > order( bucket_count );
+	for( size_t i = 0; i < bucket_count; i++ )
+		order[i] = i;
+	std::stable_sort( order.begin(), order.end(), [&]( size_t a, size_t b ){
+		return buckets[a].size() > buckets[b].size();
+	} );
+	
+	_i_keys.assign( slots, "" );
+	_i_values.assign( slots, value_type() );
+	_i_used.assign( slots, false );
+	
+	std::vector< size_t > placed;
+	for( size_t bucket : order ){
+		
+		if( buckets[bucket].empty() )
+			break;
+		
+		bool found = false;
+		for( uint32_t seed = 1; seed < 65536 && !found; seed++ ){
+			
+			placed.clear();
+			found = true;
+			for( size_t entry : buckets[bucket] ){
+				size_t slot = _i_slot( hashes[entry], seed, slots );
+				if( _i_used[slot] || std::find( placed.begin(), placed.end(), slot ) != placed.end() ){
+					found = false;
+					break;
+				}
+				placed.push_back( slot );
+			}
+			
+			if( found ){
+				_i_seeds[bucket] = seed;
+				for( size_t i = 0; i < placed.size(); i++ ){
+					size_t entry = buckets[bucket][i];
+					_i_keys[ placed[i] ] = entries[entry].first;
+					_i_values[ placed[i] ] = entries[entry].second;
+					_i_used[ placed[i] ] = true;
+				}
+			}
+		}
+		
+		if( !found )
+			return false;
+	}
+	
+	return true;
+}
+
+/**
+ * Turns button mapping strings into bytecode without regular
+ * expressions, see rd_mouse::_i_encode_button_mapping and keymap.md
+ * for the syntax.
+ * 
+ * The mapping is split into tokens at ':' and '+', key names and
+ * modifiers are looked up in perfect hash tables that are built once
+ * from the name → value maps of rd_mouse. The results are the same as
+ * those of the previous regex based implementation.
+ */
+class rd_button_encoder{
+	
+	public:
+		
+		/** \brief Build the lookup tables
+		 * \arg keycodes mouse buttons, special functions and media controls
+		 * \arg modifiers keyboard modifiers, including the trailing '+'
+		 * \arg keys keyboard keys
+		 * \arg snipe_dpi DPI values for the snipe button
+		 */
+		rd_button_encoder( const std::map< std::string, std::array<uint8_t, 4> >& keycodes,
+			const std::map< std::string, uint8_t >& modifiers,
+			const std::map< std::string, uint8_t >& keys,
+			const std::map< int, uint8_t >& snipe_dpi );
+		
+		/** \brief Turns a string describing a button mapping into bytecode
+		 * \arg mapping button mapping
+		 * \arg bytes holds the result, unchanged if the mapping is invalid
+		 * \return 0 if valid button mapping
+		 */
+		int encode( std::string_view mapping, std::array<uint8_t, 4>& bytes ) const;
+		
+	private:
+		
+		/// Splits text at delimiter into at most max_fields fields, returns the number of fields
+		static size_t _i_split( std::string_view text, char delimiter, std::string_view* fields, size_t max_fields );
+		
+		/// Parses a decimal number like std::stoi (leading whitespace, trailing characters are ignored), returns false if std::stoi would throw
+		static bool _i_parse_int( std::string_view text, int& value );
+		
+		/// Parses macroN with N = 1-15 (no leading zero) at the start of mapping, returns the length or 0
+		static size_t _i_parse_macro_number( std::string_view mapping, int& number );
+		
+		rd_perfect_hash< std::array<uint8_t, 4> > _i_keycodes;
+		rd_perfect_hash< uint8_t > _i_modifiers;
+		rd_perfect_hash< uint8_t > _i_keys;
+		std::map< int, uint8_t > _i_snipe_dpi;
+};
+
+#endif
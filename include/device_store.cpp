@@ -0,0 +1,293 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+
+#include "device_store.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char device_store_magic[8] = { 'R', 'D', 'D', 'E', 'V', 'I', 'D', 'X' };
+static const size_t device_store_header_size = 32;
+static const size_t device_store_bucket_size = 8;
+static const uint32_t device_store_initial_buckets = 64;
+
+// store value as little endian
+static void device_store_put( uint8_t* bytes, uint64_t value, int size ){
+	for( int i = 0; i < size; i++ )
+		bytes[i] = (value >> (8*i)) & 0xff;
+}
+
+// read little endian value
+static uint64_t device_store_get( const uint8_t* bytes, int size ){
+	uint64_t value = 0;
+	for( int i = 0; i < size; i++ )
+		value |= (uint64_t)bytes[i] << (8*i);
+	return value;
+}
+
+// FNV-1a hash of the identity
+static uint32_t device_store_hash( const std::string& identity ){
+	uint32_t hash = 2166136261u;
+	for( unsigned char c : identity ){
+		hash ^= c;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+// create the directory and its parents
+static void device_store_make_directories( const std::string& directory ){
+	for( size_t i = 1; i <= directory.size(); i++ ){
+		if( i == directory.size() || directory[i] == '/' )
+			mkdir( directory.substr( 0, i ).c_str(), 0755 );
+	}
+}
+
+// write a file to a temporary file, sync and rename it, it either exists completely or not at all
+static bool device_store_write_file( const std::string& path, const std::vector< uint8_t >& bytes ){
+	
+	std::string temporary = path + ".tmp";
+	int fd = open( temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+	if( fd < 0 )
+		return false;
+	
+	bool written = write( fd, bytes.data(), bytes.size() ) == (ssize_t)bytes.size() && fsync( fd ) == 0;
+	close( fd );
+	if( !written || rename( temporary.c_str(), path.c_str() ) != 0 ){
+		unlink( temporary.c_str() );
+		return false;
+	}
+	
+	// make the rename durable
+	size_t slash = path.rfind( '/' );
+	int directory = open( slash == std::string::npos ? "." : path.substr( 0, std::max< size_t >( slash, 1 ) ).c_str(), O_RDONLY );
+	if( directory >= 0 ){
+		fsync( directory );
+		close( directory );
+	}
+	
+	return true;
+}
+
+// an empty index with the given number of buckets, the header values are copied from header if not null
+static std::vector< uint8_t > device_store_empty_index( uint32_t buckets, const uint8_t* header ){
+	
+	std::vector< uint8_t > bytes( device_store_header_size + buckets * device_store_bucket_size, 0 );
+	std::copy( std::begin(device_store_magic), std::end(device_store_magic), bytes.begin() );
+	device_store_put( bytes.data()+8, 1, 2 );
+	device_store_put( bytes.data()+10, device_store_header_size, 2 );
+	device_store_put( bytes.data()+12, buckets, 4 );
+	device_store_put( bytes.data()+16, header ? device_store_get( header+16, 4 ) : 0, 4 );
+	device_store_put( bytes.data()+20, header ? device_store_get( header+20, 4 ) : 1, 4 );
+	
+	return bytes;
+}
+
+// read the header, false if it is not a valid index
+static bool device_store_read_header( int fd, uint8_t (&header)[device_store_header_size] ){
+	
+	if( pread( fd, header, sizeof(header), 0 ) != sizeof(header) )
+		return false;
+	
+	uint32_t buckets = device_store_get( header+12, 4 );
+	return std::equal( std::begin(device_store_magic), std::end(device_store_magic), header ) &&
+		device_store_get( header+8, 2 ) == 1 && device_store_get( header+10, 2 ) == device_store_header_size &&
+		buckets != 0 && (buckets & (buckets - 1)) == 0;
+}
+
+std::string rd_device_store::_i_device_directory( uint32_t number ){
+	return _i_directory + "/devices/" + std::to_string( number );
+}
+
+int rd_device_store::_i_open_index( bool create ){
+	
+	std::string path = _i_directory + "/devices.index";
+	
+	int fd = open( path.c_str(), O_RDWR );
+	if( fd < 0 && create ){
+		if( !device_store_write_file( path, device_store_empty_index( device_store_initial_buckets, nullptr ) ) )
+			return -1;
+		fd = open( path.c_str(), O_RDWR );
+	}
+	if( fd < 0 )
+		return -1;
+	
+	uint8_t header[device_store_header_size];
+	if( !device_store_read_header( fd, header ) ){
+		close( fd );
+		return -1;
+	}
+	
+	return fd;
+}
+
+uint32_t rd_device_store::_i_lookup( int fd, const std::string& identity, uint32_t hash, uint32_t& bucket ){
+	
+	uint8_t header[device_store_header_size];
+	if( !device_store_read_header( fd, header ) )
+		return 0;
+	
+	// linear probing from the home bucket until the identity or an empty bucket is found
+	uint32_t buckets = device_store_get( header+12, 4 );
+	bucket = buckets;
+	for( uint32_t i = 0, position = hash & (buckets - 1); i < buckets; i++, position = (position + 1) & (buckets - 1) ){
+		
+		uint8_t entry[device_store_bucket_size];
+		if( pread( fd, entry, sizeof(entry), device_store_header_size + position * device_store_bucket_size ) != sizeof(entry) )
+			return 0;
+		
+		uint32_t number = device_store_get( entry+4, 4 );
+		if( number == 0 ){
+			bucket = position;
+			return 0;
+		}
+		
+		// same hash: compare the identity of the directory
+		if( device_store_get( entry, 4 ) == hash ){
+			std::ifstream in( _i_device_directory( number ) + "/identity" );
+			std::string stored;
+			if( std::getline( in, stored ) && stored == identity ){
+				bucket = position;
+				return number;
+			}
+		}
+	}
+	
+	return 0;
+}
+
+int rd_device_store::_i_grow( int fd ){
+	
+	uint8_t header[device_store_header_size];
+	uint32_t buckets = device_store_read_header( fd, header ) ? device_store_get( header+12, 4 ) : 0;
+	std::vector< uint8_t > old( buckets * device_store_bucket_size );
+	bool valid = buckets != 0 && pread( fd, old.data(), old.size(), device_store_header_size ) == (ssize_t)old.size();
+	close( fd );
+	if( !valid )
+		return -1;
+	
+	// insert the entries with their stored hashes
+	std::vector< uint8_t > bytes = device_store_empty_index( 2 * buckets, header );
+	uint8_t* table = bytes.data() + device_store_header_size;
+	for( uint32_t i = 0; i < buckets; i++ ){
+		
+		const uint8_t* entry = old.data() + i * device_store_bucket_size;
+		if( device_store_get( entry+4, 4 ) == 0 )
+			continue;
+		
+		uint32_t position = device_store_get( entry, 4 ) & (2 * buckets - 1);
+		while( device_store_get( table + position * device_store_bucket_size + 4, 4 ) != 0 )
+			position = (position + 1) & (2 * buckets - 1);
+		std::copy( entry, entry + device_store_bucket_size, table + position * device_store_bucket_size );
+	}
+	
+	if( !device_store_write_file( _i_directory + "/devices.index", bytes ) )
+		return -1;
+	
+	return _i_open_index( false );
+}
+
+std::string rd_device_store::find( const std::string& identity, bool create ){
+	
+	if( identity.empty() || identity.find( '\n' ) != std::string::npos )
+		return "";
+	
+	if( create )
+		device_store_make_directories( _i_directory + "/devices" );
+	
+	// the lock file is never replaced, the index is (when it grows)
+	int lock = open( (_i_directory + "/devices.lock").c_str(), create ? O_RDWR | O_CREAT : O_RDONLY, 0644 );
+	if( lock < 0 )
+		return "";
+	flock( lock, create ? LOCK_EX : LOCK_SH );
+	
+	std::string result;
+	uint32_t hash = device_store_hash( identity );
+	uint32_t bucket = 0;
+	int fd = _i_open_index( create );
+	uint32_t number = fd < 0 ? 0 : _i_lookup( fd, identity, hash, bucket );
+	
+	if( number != 0 ){
+		result = _i_device_directory( number );
+	} else if( fd >= 0 && create ){
+		
+		// keep the index at most half full, the probe sequences stay short
+		uint8_t header[device_store_header_size];
+		if( device_store_read_header( fd, header ) && 2 * (device_store_get( header+16, 4 ) + 1) > device_store_get( header+12, 4 ) ){
+			fd = _i_grow( fd );
+			if( fd >= 0 )
+				_i_lookup( fd, identity, hash, bucket );
+		}
+		
+		if( fd >= 0 && device_store_read_header( fd, header ) && bucket < device_store_get( header+12, 4 ) ){
+			
+			// the directory and its identity first: after a crash the number is used again
+			number = device_store_get( header+20, 4 );
+			std::string directory = _i_device_directory( number );
+			mkdir( directory.c_str(), 0755 );
+			
+			std::string line = identity + "\n";
+			uint8_t entry[device_store_bucket_size];
+			device_store_put( entry, hash, 4 );
+			device_store_put( entry+4, number, 4 );
+			device_store_put( header+16, device_store_get( header+16, 4 ) + 1, 4 );
+			device_store_put( header+20, number + 1, 4 );
+			
+			if( device_store_write_file( directory + "/identity", std::vector< uint8_t >( line.begin(), line.end() ) ) &&
+				pwrite( fd, entry, sizeof(entry), device_store_header_size + bucket * device_store_bucket_size ) == sizeof(entry) &&
+				pwrite( fd, header+16, 8, 16 ) == 8 && fsync( fd ) == 0 )
+				result = directory;
+		}
+	}
+	
+	if( fd >= 0 )
+		close( fd );
+	flock( lock, LOCK_UN );
+	close( lock );
+	
+	return result;
+}
+
+size_t rd_device_store::size(){
+	
+	int lock = open( (_i_directory + "/devices.lock").c_str(), O_RDONLY );
+	if( lock < 0 )
+		return 0;
+	flock( lock, LOCK_SH );
+	
+	size_t result = 0;
+	int fd = _i_open_index( false );
+	uint8_t header[device_store_header_size];
+	if( fd >= 0 && device_store_read_header( fd, header ) )
+		result = device_store_get( header+16, 4 );
+	
+	if( fd >= 0 )
+		close( fd );
+	flock( lock, LOCK_UN );
+	close( lock );
+	
+	return result;
+}
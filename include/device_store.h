@@ -0,0 +1,92 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+
+#ifndef RD_DEVICE_STORE
+#define RD_DEVICE_STORE
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * The state directories of the devices: every device identity
+ * (rd_mouse::get_device_id) gets its own directory <store>/devices/<n>,
+ * the file devices.index maps the identities to the numbers. The index is
+ * a hash table with open addressing, a lookup reads the header, a few
+ * buckets and the identity file of the matching directory, independent of
+ * the number of devices.
+ * 
+ * Index format, all values little endian:
+ * 
+ * header (32 bytes):
+ *   0  char[8]   magic "RDDEVIDX"
+ *   8  uint16    format version (1)
+ *  10  uint16    header size (32)
+ *  12  uint32    number of buckets (a power of two)
+ *  16  uint32    number of devices
+ *  20  uint32    number of the next device directory
+ *  24  uint64    reserved
+ * 
+ * bucket (8 bytes):
+ *   0  uint32    FNV-1a hash of the identity
+ *   4  uint32    number of the device directory, 0 if the bucket is empty
+ * 
+ * Every device directory contains the file "identity". The index is grown
+ * (rewritten with twice the buckets) when it is half full, the hashes are
+ * stored so the identities don't have to be read again. Writers are
+ * serialized by a lock on devices.lock.
+ */
+class rd_device_store{
+	
+	public:
+		
+		/// \arg directory the store, created on first use
+		rd_device_store( const std::string& directory ) : _i_directory( directory ){}
+		
+		/** \brief Find the state directory of a device
+		 * \arg identity device identity, see rd_mouse::get_device_id
+		 * \arg create create the directory if the device is not in the store
+		 * \return the directory, empty if the device is not in the store or it couldn't be created
+		 */
+		std::string find( const std::string& identity, bool create );
+		
+		/// Number of devices in the store
+		size_t size();
+	
+	private:
+		
+		std::string _i_directory;
+		
+		/// open the index (and create it), -1 if not possible
+		int _i_open_index( bool create );
+		
+		/** \brief Search the index
+		 * \return the directory number, 0 if the identity is not in the index
+		 * \arg bucket set to the bucket of the identity or the first empty bucket of its probe sequence
+		 */
+		uint32_t _i_lookup( int fd, const std::string& identity, uint32_t hash, uint32_t& bucket );
+		
+		/// rewrite the index with twice the buckets, closes fd and returns the new file descriptor or -1
+		int _i_grow( int fd );
+		
+		/// directory of a device number
+		std::string _i_device_directory( uint32_t number );
+};
+
+#endif
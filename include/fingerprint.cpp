@@ -0,0 +1,294 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+
+#include "fingerprint.h"
+#include "log.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/// timeout of a GET_DESCRIPTOR request in ms
+static const unsigned int fingerprint_timeout = 100;
+/// interfaces tried with GET_DESCRIPTOR (the models use at most three)
+static const int fingerprint_interfaces = 4;
+
+static const char* fingerprint_names[] = { "unavailable", "unknown", "m908", "m990", "m913" };
+
+rd_fingerprint::rd_fingerprint(){
+	
+	// $XDG_CACHE_HOME/mouse_m908 or ~/.cache/mouse_m908, like the plugin index
+	if( getenv( "XDG_CACHE_HOME" ) != nullptr && getenv( "XDG_CACHE_HOME" )[0] != '\0' )
+		_i_cache_file = std::string( getenv( "XDG_CACHE_HOME" ) ) + "/mouse_m908/protocols";
+	else if( getenv( "HOME" ) != nullptr )
+		_i_cache_file = std::string( getenv( "HOME" ) ) + "/.cache/mouse_m908/protocols";
+	
+	_i_read_cache();
+}
+
+std::string rd_fingerprint::protocol_name( rd_protocol protocol ){
+	return fingerprint_names[protocol];
+}
+
+rd_fingerprint::rd_protocol rd_fingerprint::probe( libusb_device* device, bool claimed ){
+	
+	libusb_device_descriptor descriptor;
+	if( libusb_get_device_descriptor( device, &descriptor ) != 0 )
+		return protocol_unavailable;
+	
+	uint32_t id = descriptor.idVendor << 16 | descriptor.idProduct;
+	auto cached = _i_cache.find( id );
+	if( cached != _i_cache.end() && (!claimed || cached->second == protocol_m908) )
+		return cached->second;
+	
+	// sysfs while the kernel driver is bound, otherwise the mouse
+	std::vector< std::vector< uint8_t > > descriptors;
+	if( !_i_read_sysfs( device, descriptors ) && !_i_read_usb( device, descriptors ) )
+		return protocol_unavailable;
+	
+	std::map< uint8_t, size_t > reports;
+	for( auto& report_descriptor : descriptors )
+		parse_report_descriptor( report_descriptor.data(), report_descriptor.size(), reports );
+	
+	rd_protocol protocol = classify( reports );
+	RD_LOG_INFO( "Protocol family of " << std::hex << std::setfill('0') << std::setw(4) << descriptor.idVendor << ":" << std::setw(4) << descriptor.idProduct
+		<< std::dec << ": " << protocol_name( protocol ) );
+	
+	// a PID claimed by the generic backend is skipped for this run only, a wrong result must not hide it for good
+	if( claimed && protocol != protocol_m908 )
+		return protocol;
+	
+	_i_cache[id] = protocol;
+	if( _i_write_cache() != 0 )
+		RD_LOG_DEBUG( "Couldn't write the protocol cache " << _i_cache_file );
+	
+	return protocol;
+}
+
+bool rd_fingerprint::generic_protocol( libusb_device* device ){
+	
+	rd_protocol protocol = probe( device, true );
+	if( protocol == protocol_m908 || protocol == protocol_unavailable )
+		return true;
+	
+	libusb_device_descriptor descriptor;
+	libusb_get_device_descriptor( device, &descriptor );
+	RD_LOG_WARNING( "Skipped " << std::hex << std::setfill('0') << std::setw(4) << descriptor.idVendor << ":" << std::setw(4) << descriptor.idProduct
+		<< std::dec << ", its protocol family (" << protocol_name( protocol ) << ") is not supported by the generic backend" );
+	
+	return false;
+}
+
+void rd_fingerprint::parse_report_descriptor( const uint8_t* descriptor, size_t size, std::map< uint8_t, size_t >& reports ){
+	
+	// global items: report size, count and id (with push and pop), bits of the feature reports by id
+	struct globals{ uint32_t size = 0, count = 0; uint8_t id = 0; };
+	globals current;
+	std::vector< globals > stack;
+	std::map< uint8_t, size_t > bits;
+	
+	for( size_t i = 0; i < size; ){
+		
+		uint8_t prefix = descriptor[i];
+		
+		// long items carry no report information
+		if( prefix == 0xfe ){
+			i += 3 + (i+1 < size ? descriptor[i+1] : 0);
+			continue;
+		}
+		
+		size_t length = (prefix & 0x03) == 3 ? 4 : (prefix & 0x03);
+		if( i + 1 + length > size )
+			break;
+		
+		uint32_t value = 0;
+		for( size_t j = 0; j < length; j++ )
+			value |= (uint32_t)descriptor[i+1+j] << (8*j);
+		
+		switch( prefix & 0xfc ){
+			case 0x74: // report size
+				current.size = value;
+				break;
+			case 0x94: // report count
+				current.count = value;
+				break;
+			case 0x84: // report id
+				current.id = value;
+				break;
+			case 0xa4: // push
+				stack.push_back( current );
+				break;
+			case 0xb4: // pop
+				if( !stack.empty() ){
+					current = stack.back();
+					stack.pop_back();
+				}
+				break;
+			case 0xb0: // feature
+				bits[current.id] += (size_t)current.size * current.count;
+				break;
+			default:
+				break;
+		}
+		
+		i += 1 + length;
+	}
+	
+	// the transfers start with the report id
+	for( auto& report : bits )
+		reports[report.first] = std::max( reports[report.first], (report.second + 7) / 8 + (report.first != 0 ? 1 : 0) );
+}
+
+rd_fingerprint::rd_protocol rd_fingerprint::classify( const std::map< uint8_t, size_t >& reports ){
+	
+	auto size = [&reports]( uint8_t id ){
+		auto report = reports.find( id );
+		return report != reports.end() ? report->second : 0;
+	};
+	
+	if( size( 8 ) > 0 )
+		return protocol_m913;
+	// the M908 declares reports 4, 5 and 6 as well (documentation/lsusb-output_m908.txt), only the 2/3 pair tells the families apart
+	if( size( 2 ) == 16 && size( 3 ) == 64 )
+		return protocol_m908;
+	if( size( 4 ) == 256 )
+		return protocol_m990;
+	
+	return protocol_unknown;
+}
+
+void rd_fingerprint::_i_read_cache(){
+	
+	std::ifstream cache( _i_cache_file );
+	std::string line;
+	if( !cache.is_open() || !std::getline( cache, line ) || line != "# mouse_m908 protocol cache 2" )
+		return;
+	
+	uint32_t vid, pid;
+	std::string name;
+	while( cache >> std::hex >> vid >> pid >> std::dec >> name ){
+		for( int protocol = protocol_unknown; protocol <= protocol_m913; protocol++ ){
+			if( name == fingerprint_names[protocol] )
+				_i_cache[vid << 16 | pid] = (rd_protocol)protocol;
+		}
+	}
+}
+
+int rd_fingerprint::_i_write_cache(){
+	
+	if( _i_cache_file == "" )
+		return 1;
+	
+	// create the cache directory
+	std::string directory = _i_cache_file.substr( 0, _i_cache_file.rfind( '/' ) );
+	for( size_t i = 1; i <= directory.size(); i++ ){
+		if( i == directory.size() || directory[i] == '/' )
+			mkdir( directory.substr( 0, i ).c_str(), 0755 );
+	}
+	
+	// written to a temporary file first, an interrupted write leaves the old cache
+	std::string temporary = _i_cache_file + "." + std::to_string( getpid() );
+	std::ofstream cache( temporary );
+	if( !cache.is_open() )
+		return 1;
+	
+	cache << "# mouse_m908 protocol cache 2\n" << std::hex << std::setfill('0');
+	for( auto& entry : _i_cache )
+		cache << std::setw(4) << (entry.first >> 16) << " " << std::setw(4) << (entry.first & 0xffff) << " " << protocol_name( entry.second ) << "\n";
+	
+	cache.close();
+	if( !cache || std::rename( temporary.c_str(), _i_cache_file.c_str() ) != 0 ){
+		std::remove( temporary.c_str() );
+		return 1;
+	}
+	
+	return 0;
+}
+
+bool rd_fingerprint::_i_read_sysfs( libusb_device* device, std::vector< std::vector< uint8_t > >& descriptors ){
+	
+	// the interfaces of the device are named <bus>-<ports>:<configuration>.<interface>
+	std::string path = std::to_string( libusb_get_bus_number( device ) );
+	uint8_t ports[8];
+	int count = libusb_get_port_numbers( device, ports, sizeof(ports) );
+	if( count <= 0 )
+		return false;
+	for( int i = 0; i < count; i++ )
+		path += (i == 0 ? "-" : ".") + std::to_string( ports[i] );
+	path += ":";
+	
+	DIR* devices = opendir( "/sys/bus/usb/devices" );
+	if( devices == nullptr )
+		return false;
+	
+	for( dirent* interface; (interface = readdir( devices )) != nullptr; ){
+		
+		if( std::string( interface->d_name ).compare( 0, path.size(), path ) != 0 )
+			continue;
+		
+		// the HID device of the interface, e.g. 0003:04D9:FC4D.0001
+		std::string interface_path = std::string( "/sys/bus/usb/devices/" ) + interface->d_name;
+		DIR* hid = opendir( interface_path.c_str() );
+		if( hid == nullptr )
+			continue;
+		
+		for( dirent* entry; (entry = readdir( hid )) != nullptr; ){
+			std::ifstream in( interface_path + "/" + entry->d_name + "/report_descriptor", std::ios::binary );
+			if( in.is_open() )
+				descriptors.emplace_back( (std::istreambuf_iterator<char>( in )), std::istreambuf_iterator<char>() );
+		}
+		
+		closedir( hid );
+	}
+	
+	closedir( devices );
+	
+	return !descriptors.empty();
+}
+
+bool rd_fingerprint::_i_read_usb( libusb_device* device, std::vector< std::vector< uint8_t > >& descriptors ){
+	
+	libusb_device_handle* handle = nullptr;
+	if( libusb_open( device, &handle ) != 0 )
+		return false;
+	
+	// GET_DESCRIPTOR (HID report descriptor) to each interface, missing interfaces fail without waiting for the timeout
+	for( int interface = 0; interface < fingerprint_interfaces; interface++ ){
+		
+		std::vector< uint8_t > buffer( 4096 );
+		int length = libusb_control_transfer( handle, LIBUSB_ENDPOINT_IN | LIBUSB_RECIPIENT_INTERFACE, LIBUSB_REQUEST_GET_DESCRIPTOR,
+			0x2200, interface, buffer.data(), buffer.size(), fingerprint_timeout );
+		
+		if( length > 0 ){
+			buffer.resize( length );
+			descriptors.push_back( buffer );
+		}
+	}
+	
+	libusb_close( handle );
+	
+	return !descriptors.empty();
+}
@@ -0,0 +1,105 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+
+
+#ifndef RD_FINGERPRINT
+#define RD_FINGERPRINT
+
+#include <libusb.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * Protocol families of the mice, classified by the feature reports of
+ * their HID report descriptors. The backends send their requests as HID
+ * feature reports (wValue 0x03NN = feature report NN):
+ * - m908: reports 2 (16 bytes) and 3 (64 bytes), the M908 and the models
+ *   of the generic backend (the M908 declares reports 4, 5 and 6 as well)
+ * - m990: report 4 (256 bytes) without the 2/3 pair of the m908 family,
+ *   the M990 Legend sends its settings as report 4
+ * - m913: report 8 with interrupt acknowledgements, the M913
+ * 
+ * The report descriptors are read from sysfs (no USB transfer) and, if
+ * the kernel driver isn't bound, with one GET_DESCRIPTOR request per
+ * interface and a short timeout. Nothing is written to the mouse. The
+ * result is cached per VID and PID in $XDG_CACHE_HOME/mouse_m908/protocols
+ * or ~/.cache/mouse_m908/protocols, one line "vid pid protocol" each.
+ */
+class rd_fingerprint{
+	
+	public:
+		
+		/// protocol families
+		enum rd_protocol{
+			protocol_unavailable = 0, ///< the report descriptors couldn't be read (not cached)
+			protocol_unknown, ///< none of the families below
+			protocol_m908,
+			protocol_m990,
+			protocol_m913,
+		};
+		
+		rd_fingerprint();
+		
+		/// Name of a protocol family
+		static std::string protocol_name( rd_protocol protocol );
+		
+		/** \brief Protocol family of a device, from the cache or the report descriptors
+		 * A new result is added to the cache file.
+		 * \arg claimed the generic backend claims the PID: only m908 is taken from or added to the cache
+		 */
+		rd_protocol probe( libusb_device* device, bool claimed = false );
+		
+		/** \brief Whether the generic backend can be used for a device it claims
+		 * True if the device speaks its protocol (m908) or it couldn't be probed, a warning is logged otherwise.
+		 * Other families are not cached, the device is probed again by the next run.
+		 */
+		bool generic_protocol( libusb_device* device );
+		
+		/** \brief Add the feature reports of a HID report descriptor
+		 * \arg reports report id → report size in bytes (with the report id byte)
+		 */
+		static void parse_report_descriptor( const uint8_t* descriptor, size_t size, std::map< uint8_t, size_t >& reports );
+		
+		/// Classify the feature reports of all interfaces
+		static rd_protocol classify( const std::map< uint8_t, size_t >& reports );
+	
+	private:
+		
+		std::string _i_cache_file;
+		/// vid << 16 | pid → protocol
+		std::map< uint32_t, rd_protocol > _i_cache;
+		
+		/// read the cache file, missing or invalid files are an empty cache
+		void _i_read_cache();
+		
+		/// write the cache file, 0 if successful
+		int _i_write_cache();
+		
+		/// report descriptors of the HID interfaces from sysfs, false if there are none
+		bool _i_read_sysfs( libusb_device* device, std::vector< std::vector< uint8_t > >& descriptors );
+		
+		/// report descriptors of the HID interfaces with GET_DESCRIPTOR requests, false if there are none
+		bool _i_read_usb( libusb_device* device, std::vector< std::vector< uint8_t > >& descriptors );
+};
+
+#endif
@@ -147,6 +147,13 @@ class mouse_generic : public rd_mouse{
 		 */
 		int set_all_macros( std::string file );
 		
+		/** \brief Load a pre-encoded macro slot image (e.g. from a macro bank)
+		 * The image must contain the slot code of macro_number (see _c_data_macros_codes).
+		 * \param macro_number macro slot (1-15)
+		 * \return 0 if successful, 1 if the image doesn't belong to this slot
+		 */
+		int set_macro_raw( int macro_number, const std::array<uint8_t, 256>& macro );
+		
 		/// Set USB vendor id
 		void set_vid( uint16_t vid ){
 			_c_mouse_vid = vid;
@@ -191,6 +198,16 @@ class mouse_generic : public rd_mouse{
 			return _c_all_vids.find(vid) != _c_all_vids.end() && _c_all_pids.find(pid) != _c_all_pids.end();
 		}
 		
+		/// Get the USB ids of the model (vendor id, product id)
+		static std::vector< std::pair<uint16_t, uint16_t> > get_ids(){
+			std::vector< std::pair<uint16_t, uint16_t> > ids;
+			for( uint16_t vid : _c_all_vids ){
+				for( uint16_t pid : _c_all_pids )
+					ids.push_back( { vid, pid } );
+			}
+			return ids;
+		}
+		
 		/// Get mouse name
 		static std::string get_name(){
 			return _c_name;
@@ -0,0 +1,31 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+
+/*
+ * This file registers the model for the plugin build (see ../plugin.h),
+ * it is not part of the monolithic build
+ */
+
+#include "../rd_mouse.h"
+#include "../plugin.h"
+
+extern "C" const rd_plugin* rd_plugin_register(){
+	// lowest priority, like the last alternative of rd_mouse::mouse_variant
+	return rd_plugin_entry< mouse_generic >( true );
+}
@@ -47,6 +47,52 @@ Options:
 	Read settings from the mouse and dump the raw data to the specified file ('-' = stdout).
 -M --model=arg
 	Specifies the mouse model (? for a list of valid models).
+--throttle=arg
+	Limit the configuration traffic, as transfers per ms (e.g. 0.5/ms) or duty cycle (e.g. 50%).
+--timeout=arg
+	Abort all actions after the specified time in ms, the mouse is left in a consistent state.
+--measure-jitter
+	Record the pointer reports while performing the other actions and print their timing.
+--flight-recorder=arg
+	File the last transfers are written to when a transfer fails or on SIGUSR1 (default: $XDG_RUNTIME_DIR/mouse_m908.rawdump or ~/.cache/mouse_m908/mouse_m908.rawdump).
+--print-dump=arg
+	Print a binary raw dump written by the flight recorder (- for stdin).
+--log-level=arg
+	Print log messages up to this level: off, error, warning (default), info, debug or trace.
+--log-sink=arg
+	Where the log messages are written to: stderr (default), syslog or a file.
+--compile-macros=arg
+	Compile the macros from --macro (all or only --number) to a macro bank for the model (--model or detected).
+	A macro bank can be used with --macro instead of a macro file, it is sent without parsing.
+--stats[=hw]
+	Print the time spent in each phase (config parsing, setters, macro encoding, decoding, writing,
+	USB transfers), with =hw also the hardware performance counters (Linux only).
+--dry-run[=arg]
+	Don't write anything: print the settings that would change, the transfers that would be sent
+	and their estimated time. Compares against the settings read from the mouse or a snapshot from -R.
+--sync-lighting=arg
+	Run a lighting effect in sync on all connected M908: <effect>[:<fps>[:<seconds>]]
+	with the effect rainbow, wave, breathing or chase (default: 25 fps for 10 s, 0 s = until Ctrl+C).
+--simulate[=arg]
+	Don't open a mouse, run against a simulated one of --model: reads return zeros, writes are discarded.
+	With a settings memory file (format of --backup) reads return its bytes and writes change it.
+--journal=arg
+	Directory of the write journals (default: ~/.local/state/mouse_m908) or off. An interrupted write
+	(-c, -p, -m) is finished on the next run, only the rows that were not acknowledged are sent.
+--backup=arg
+	Read the settings and macros without decoding them and write them to a backup file (M908 only).
+--restore=arg
+	Restore a backup from --backup bit-exact, only the rows that differ from the mouse are sent.
+--undo[=arg]
+	Roll back the last arg writes (default: 1) from the undo history of the device (M908 only),
+	only the rows that differ from the mouse are sent.
+--compress-macros
+	Encode macros that repeat one sequence of actions as one period and multiply the repeats of the
+	button mappings (macroN:repeats) from --config. Prints the compression and whether the timing is exact.
+--resident[=arg]
+	Keep the mouse open and read commands from stdin, one per line (e.g. -p 2 or -c example.ini).
+	The interfaces are claimed by the first command and released after arg ms without commands (default: 2000).
+	While it runs, other command lines forward their commands to it over a unix socket ($MOUSE_M908_SOCKET).
 
 Examples:
 
@@ -58,4 +104,18 @@ Send all macros from example.ini
 	mouse_m908 -m example.ini
 Read and print the current config in .ini format
 	mouse_m908 -R -
+Compare the pointer report timing while writing with and without throttling
+	mouse_m908 -c example.ini --measure-jitter
+	mouse_m908 -c example.ini --measure-jitter --throttle=50%
+	mouse_m908 --print-dump=$XDG_RUNTIME_DIR/mouse_m908.rawdump
+	mouse_m908 -c example.ini --stats=hw
+	mouse_m908 --model 908 -m example.ini --compile-macros=macros.bank
+	mouse_m908 -m macros.bank -n 2
+	mouse_m908 -c example.ini --dry-run=snapshot.ini
+	mouse_m908 --sync-lighting=wave:30:0
+	mouse_m908 --simulate --model 908 -c example.ini -R -
+	mouse_m908 --backup=mouse.backup
+	mouse_m908 --restore=mouse.backup
+	mouse_m908 -c example.ini -m example.ini --compress-macros
+	mouse_m908 --resident=5000
 )";
\ No newline at end of file
@@ -0,0 +1,203 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+
+#include "history.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char history_magic[8] = { 'R', 'D', 'H', 'I', 'S', 'T', 'R', 'Y' };
+static const size_t history_header_size = 32;
+static const size_t history_entry_header_size = 12;
+
+// store value as little endian
+static void history_put( uint8_t* bytes, uint64_t value, int size ){
+	for( int i = 0; i < size; i++ )
+		bytes[i] = (value >> (8*i)) & 0xff;
+}
+
+// append value as little endian
+static void history_append( std::vector< uint8_t >& bytes, uint64_t value, int size ){
+	bytes.resize( bytes.size() + size );
+	history_put( bytes.data() + bytes.size() - size, value, size );
+}
+
+// read little endian value
+static uint64_t history_get( const uint8_t* bytes, int size ){
+	uint64_t value = 0;
+	for( int i = 0; i < size; i++ )
+		value |= (uint64_t)bytes[i] << (8*i);
+	return value;
+}
+
+// FNV-1a hash
+static uint32_t history_hash( const uint8_t* bytes, size_t size ){
+	uint32_t hash = 2166136261u;
+	for( size_t i = 0; i < size; i++ ){
+		hash ^= bytes[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+int rd_history::load(){
+	
+	_i_memory.clear();
+	_i_entries.clear();
+	
+	std::ifstream in( _i_path, std::ios::binary );
+	if( !in.is_open() )
+		return 0;
+	std::vector< uint8_t > bytes( (std::istreambuf_iterator<char>( in )), std::istreambuf_iterator<char>() );
+	
+	if( bytes.size() < history_header_size ||
+		!std::equal( std::begin(history_magic), std::end(history_magic), bytes.begin() ) ||
+		history_get( bytes.data()+8, 2 ) != 1 || history_get( bytes.data()+10, 2 ) != history_header_size ||
+		history_get( bytes.data()+20, 4 ) != history_hash( bytes.data() + history_header_size, bytes.size() - history_header_size ) )
+		return 1;
+	
+	size_t entries = history_get( bytes.data()+12, 4 );
+	size_t memory = history_get( bytes.data()+16, 4 );
+	size_t position = history_header_size;
+	
+	if( bytes.size() - position < memory * 3 )
+		return 1;
+	for( size_t i = 0; i < memory; i++, position += 3 )
+		_i_memory[history_get( bytes.data() + position, 2 )] = bytes[position+2];
+	
+	for( size_t i = 0; i < entries; i++ ){
+		
+		if( bytes.size() - position < history_entry_header_size )
+			return 1;
+		
+		entry e;
+		e.time = history_get( bytes.data() + position, 8 );
+		size_t count = history_get( bytes.data() + position + 8, 4 );
+		position += history_entry_header_size;
+		
+		if( bytes.size() - position < count * 4 )
+			return 1;
+		for( size_t j = 0; j < count; j++, position += 4 )
+			e.bytes[history_get( bytes.data() + position, 2 )] = { bytes[position+2], bytes[position+3] };
+		
+		_i_entries.push_back( e );
+	}
+	
+	return position == bytes.size() ? 0 : 1;
+}
+
+int rd_history::save(){
+	
+	std::vector< uint8_t > bytes( history_header_size, 0 );
+	std::copy( std::begin(history_magic), std::end(history_magic), bytes.begin() );
+	history_put( bytes.data()+8, 1, 2 );
+	history_put( bytes.data()+10, history_header_size, 2 );
+	history_put( bytes.data()+12, _i_entries.size(), 4 );
+	history_put( bytes.data()+16, _i_memory.size(), 4 );
+	
+	for( auto& byte : _i_memory ){
+		history_append( bytes, byte.first, 2 );
+		bytes.push_back( byte.second );
+	}
+	
+	for( auto& e : _i_entries ){
+		history_append( bytes, e.time, 8 );
+		history_append( bytes, e.bytes.size(), 4 );
+		for( auto& byte : e.bytes ){
+			history_append( bytes, byte.first, 2 );
+			bytes.push_back( byte.second.first );
+			bytes.push_back( byte.second.second );
+		}
+	}
+	
+	history_put( bytes.data()+20, history_hash( bytes.data() + history_header_size, bytes.size() - history_header_size ), 4 );
+	
+	// write to a temporary file, sync and rename, the history either exists completely or not at all
+	std::string temporary = _i_path + ".tmp";
+	int fd = open( temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+	if( fd < 0 )
+		return 1;
+	
+	bool written = write( fd, bytes.data(), bytes.size() ) == (ssize_t)bytes.size() && fsync( fd ) == 0;
+	close( fd );
+	if( !written || rename( temporary.c_str(), _i_path.c_str() ) != 0 ){
+		unlink( temporary.c_str() );
+		return 1;
+	}
+	
+	return 0;
+}
+
+bool rd_history::knows( const memory_image& written ){
+	
+	for( auto& byte : written ){
+		if( _i_memory.find( byte.first ) == _i_memory.end() )
+			return false;
+	}
+	
+	return true;
+}
+
+size_t rd_history::record( const memory_image& written ){
+	
+	entry e;
+	e.time = std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::system_clock::now().time_since_epoch() ).count();
+	
+	for( auto& byte : written ){
+		auto known = _i_memory.find( byte.first );
+		if( known != _i_memory.end() && known->second != byte.second )
+			e.bytes[byte.first] = { known->second, byte.second };
+		_i_memory[byte.first] = byte.second;
+	}
+	
+	if( e.bytes.empty() )
+		return 0;
+	
+	_i_entries.push_back( e );
+	if( _i_entries.size() > _i_limit )
+		_i_entries.erase( _i_entries.begin(), _i_entries.end() - _i_limit );
+	
+	return _i_entries.back().bytes.size();
+}
+
+rd_history::memory_image rd_history::target( size_t count ){
+	
+	// from the newest entry to the oldest, the oldest value before wins
+	memory_image memory = _i_memory;
+	count = std::min( count, _i_entries.size() );
+	for( auto e = _i_entries.rbegin(); e != _i_entries.rbegin() + count; e++ ){
+		for( auto& byte : e->bytes )
+			memory[byte.first] = byte.second.first;
+	}
+	
+	return memory;
+}
+
+void rd_history::remove( size_t count ){
+	
+	count = std::min( count, _i_entries.size() );
+	_i_memory = target( count );
+	_i_entries.erase( _i_entries.end() - count, _i_entries.end() );
+}
@@ -0,0 +1,133 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+
+
+#ifndef RD_HISTORY
+#define RD_HISTORY
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * The undo history of a device: every write records the bytes of the
+ * settings memory it changed with their values before and after, the
+ * newest entries can be rolled back (--undo). The history also keeps the
+ * memory of the mouse as far as it is known, the rows of a write are read
+ * back into it just before the write is sent.
+ * 
+ * History format, all values little endian:
+ * 
+ * header (32 bytes):
+ *   0  char[8]   magic "RDHISTRY"
+ *   8  uint16    format version (1)
+ *  10  uint16    header size (32)
+ *  12  uint32    number of entries
+ *  16  uint32    number of bytes of the known memory
+ *  20  uint32    FNV-1a hash of the rest of the file
+ *  24  uint64    reserved
+ * 
+ * known memory, ordered by address:
+ *   0  uint16    address
+ *   2  uint8     byte
+ * 
+ * entries, oldest first:
+ *   0  uint64    system clock at the time of the write in ns since the unix epoch
+ *   8  uint32    number of changed bytes
+ *  12  changed bytes, ordered by address:
+ *        0  uint16    address
+ *        2  uint8     value before the write
+ *        3  uint8     value after the write
+ * 
+ * The file is written to a temporary file, synced and renamed. The oldest
+ * entries are dropped when there are more than the limit.
+ */
+class rd_history{
+	
+	public:
+		
+		/// Settings memory (address → byte), same as rd_mouse::memory_image
+		typedef std::map< uint16_t, uint8_t > memory_image;
+		
+		/// One write: the changed bytes (address → before, after)
+		struct entry{
+			uint64_t time = 0;
+			std::map< uint16_t, std::pair< uint8_t, uint8_t > > bytes;
+		};
+		
+		/// \arg path history file, one per device and model
+		/// \arg limit maximum number of entries
+		rd_history( const std::string& path, size_t limit = 32 ) : _i_path( path ), _i_limit( limit ){}
+		
+		/** \brief Read the history file
+		 * \return 0 if successful or the file doesn't exist (empty history), 1 if it is invalid
+		 */
+		int load();
+		
+		/** \brief Write the history file
+		 * \return 0 if successful
+		 */
+		int save();
+		
+		/// Number of entries
+		size_t size(){ return _i_entries.size(); }
+		
+		/// Entries, oldest first
+		const std::vector< entry >& entries(){ return _i_entries; }
+		
+		/// Known memory of the mouse after the newest entry
+		const memory_image& memory(){ return _i_memory; }
+		
+		/// Whether the values of all addresses of written are known
+		bool knows( const memory_image& written );
+		
+		/** \brief Set the known memory, e.g. after reading the mouse
+		 * The entries are kept, their values after the write may differ from memory if the mouse was changed otherwise.
+		 */
+		void set_memory( const memory_image& memory ){ _i_memory = memory; }
+		
+		/** \brief Record a write: the bytes that differ from the known memory become a new entry
+		 * Bytes with an unknown value before the write are only stored in the known memory.
+		 * \return the number of changed bytes, 0 if nothing changed (no entry is added)
+		 */
+		size_t record( const memory_image& written );
+		
+		/** \brief The values before the newest entries
+		 * \arg count number of entries to roll back, at most size()
+		 * \return the known memory with the bytes of the entries set to their values before the oldest of them
+		 */
+		memory_image target( size_t count );
+		
+		/** \brief Remove the newest entries after they were rolled back
+		 * The known memory gets the values before the entries.
+		 */
+		void remove( size_t count );
+	
+	private:
+		
+		std::string _i_path;
+		size_t _i_limit;
+		memory_image _i_memory;
+		std::vector< entry > _i_entries;
+};
+
+#endif
@@ -0,0 +1,364 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+
+#include "rd_mouse.h"
+
+#include <sys/stat.h>
+
+//write journal: the transfers of a write are recorded, written to the journal file and then sent
+
+/* Journal format, all values little endian:
+ * 
+ * header (32 bytes):
+ *   0  char[8]  magic "RDJOURNL"
+ *   8  uint16   format version (1)
+ *  10  uint16   header size (32)
+ *  12  uint32   number of rows
+ *  16  uint32   number of acknowledged rows, updated after each transfer
+ *  20  uint32   FNV-1a hash of the rows
+ *  24  uint64   system clock at the time the journal was written in ns since the unix epoch
+ * 
+ * rows, in the order they are sent:
+ *   0  uint8    type (0 = control, 1 = interrupt)
+ *   1  uint8    bmRequestType (control) or endpoint (interrupt)
+ *   2  uint8    bRequest
+ *   3  uint8    reserved
+ *   4  uint16   wValue
+ *   6  uint16   wIndex
+ *   8  uint16   wLength
+ *  10  uint16   number of payload bytes (wLength for out transfers, 0 for in transfers)
+ *  12  uint8[]  payload
+ * 
+ * The journal is written to a temporary file, synced and renamed, it either exists completely or not at all.
+ * The acknowledged rows are not synced: after a crash of the process or a disconnected mouse the page cache
+ * still has them, after a power loss some rows are sent again, which is harmless because every row
+ * writes absolute values.
+ */
+static const char journal_magic[8] = { 'R', 'D', 'J', 'O', 'U', 'R', 'N', 'L' };
+static const size_t journal_header_size = 32;
+static const size_t journal_row_header_size = 12;
+
+// store value as little endian
+static void journal_put( uint8_t* bytes, uint64_t value, int size ){
+	for( int i = 0; i < size; i++ )
+		bytes[i] = (value >> (8*i)) & 0xff;
+}
+
+// read little endian value
+static uint64_t journal_get( const uint8_t* bytes, int size ){
+	uint64_t value = 0;
+	for( int i = 0; i < size; i++ )
+		value |= (uint64_t)bytes[i] << (8*i);
+	return value;
+}
+
+// FNV-1a hash of the rows
+static uint32_t journal_hash( const uint8_t* bytes, size_t size ){
+	uint32_t hash = 2166136261u;
+	for( size_t i = 0; i < size; i++ ){
+		hash ^= bytes[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+// create the directory and its parents
+static void journal_make_directories( const std::string& directory ){
+	for( size_t i = 1; i <= directory.size(); i++ ){
+		if( i == directory.size() || directory[i] == '/' )
+			mkdir( directory.substr( 0, i ).c_str(), 0755 );
+	}
+}
+
+// sync the directory containing path, makes a rename or unlink durable
+static void journal_sync_directory( const std::string& path ){
+	size_t slash = path.rfind( '/' );
+	std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr( 0, slash );
+	int fd = open( directory.c_str(), O_RDONLY );
+	if( fd >= 0 ){
+		fsync( fd );
+		close( fd );
+	}
+}
+
+// update the number of acknowledged rows
+static bool journal_acknowledge( int fd, size_t rows ){
+	uint8_t bytes[4];
+	journal_put( bytes, rows, 4 );
+	return pwrite( fd, bytes, sizeof(bytes), 16 ) == sizeof(bytes);
+}
+
+int rd_mouse::_i_journal_record( uint8_t type, uint8_t request_type, uint8_t request, uint16_t value, uint16_t index,
+	unsigned char* data, int length ){
+	
+	journal_row row;
+	row.type = type;
+	row.request_type = request_type;
+	row.request = request;
+	row.value = value;
+	row.index = index;
+	row.length = std::max( length, 0 );
+	
+	// in transfers (bit 7 of bmRequestType or the endpoint address) read nothing while recording
+	if( request_type & 0x80 ){
+		if( data != nullptr )
+			std::fill( data, data + length, 0 );
+	} else if( data != nullptr ){
+		row.data.assign( data, data + row.length );
+	}
+	
+	_i_journal_rows.push_back( row );
+	
+	return length;
+}
+
+rd_mouse::memory_image rd_mouse::get_journal_memory(){
+	
+	// same layout as the rows stored by the simulated memory
+	memory_image memory;
+	for( auto& row : _i_journal_rows ){
+		if( row.type != transfer_control || row.data.size() < 8 || row.data[1] != 0xf3 )
+			continue;
+		uint16_t address = row.data[2] | (row.data[3] << 8);
+		for( size_t i = 0; i < row.data[4] && 8+i < row.data.size(); i++ )
+			memory[address+i] = row.data[8+i];
+	}
+	
+	return memory;
+}
+
+int rd_mouse::commit_journal(){
+	
+	_i_journal_recording = false;
+	
+	// serialize the rows
+	std::vector< uint8_t > bytes( journal_header_size );
+	for( auto& row : _i_journal_rows ){
+		
+		uint8_t header[journal_row_header_size] = {};
+		header[0] = row.type;
+		header[1] = row.request_type;
+		header[2] = row.request;
+		journal_put( header+4, row.value, 2 );
+		journal_put( header+6, row.index, 2 );
+		journal_put( header+8, row.length, 2 );
+		journal_put( header+10, row.data.size(), 2 );
+		
+		bytes.insert( bytes.end(), std::begin(header), std::end(header) );
+		bytes.insert( bytes.end(), row.data.begin(), row.data.end() );
+	}
+	
+	std::copy( std::begin(journal_magic), std::end(journal_magic), bytes.begin() );
+	journal_put( bytes.data()+8, 1, 2 );
+	journal_put( bytes.data()+10, journal_header_size, 2 );
+	journal_put( bytes.data()+12, _i_journal_rows.size(), 4 );
+	journal_put( bytes.data()+16, 0, 4 );
+	journal_put( bytes.data()+20, journal_hash( bytes.data() + journal_header_size, bytes.size() - journal_header_size ), 4 );
+	journal_put( bytes.data()+24, std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::system_clock::now().time_since_epoch() ).count(), 8 );
+	
+	// write the journal to a temporary file and rename it, the file descriptor stays valid for the acknowledgements
+	size_t slash = _i_journal_path.rfind( '/' );
+	if( slash != std::string::npos && slash > 0 )
+		journal_make_directories( _i_journal_path.substr( 0, slash ) );
+	
+	std::string temporary = _i_journal_path + ".tmp";
+	int flags = O_RDWR | O_CREAT | O_TRUNC;
+	#ifdef O_NOFOLLOW
+	flags |= O_NOFOLLOW;
+	#endif
+	
+	int fd = open( temporary.c_str(), flags, 0644 );
+	if( fd >= 0 ){
+		
+		size_t written = 0;
+		while( written < bytes.size() ){
+			ssize_t ret = write( fd, bytes.data() + written, bytes.size() - written );
+			if( ret < 0 && errno == EINTR )
+				continue;
+			if( ret <= 0 )
+				break;
+			written += ret;
+		}
+		
+		if( written != bytes.size() || fsync( fd ) != 0 || rename( temporary.c_str(), _i_journal_path.c_str() ) != 0 ){
+			close( fd );
+			unlink( temporary.c_str() );
+			fd = -1;
+		} else{
+			journal_sync_directory( _i_journal_path );
+		}
+	}
+	
+	if( fd < 0 )
+		RD_LOG_WARNING( "couldn't write the journal " << _i_journal_path << ", writing without it" );
+	else
+		RD_LOG_DEBUG( "journal " << _i_journal_path << ": " << _i_journal_rows.size() << " rows" );
+	
+	// send, the journal is removed when all rows were acknowledged
+	int ret = _i_journal_send( fd, 0 );
+	
+	if( fd >= 0 ){
+		close( fd );
+		if( ret == 0 ){
+			unlink( _i_journal_path.c_str() );
+			journal_sync_directory( _i_journal_path );
+		}
+	}
+	
+	_i_journal_rows.clear();
+	
+	return ret;
+}
+
+int rd_mouse::resume_journal( const std::string& path, size_t& remaining ){
+	
+	remaining = 0;
+	
+	std::ifstream input( path, std::ios::binary );
+	if( !input.is_open() )
+		return 0;
+	
+	std::vector< uint8_t > bytes( (std::istreambuf_iterator<char>( input )), std::istreambuf_iterator<char>() );
+	input.close();
+	
+	// check the header and the hash
+	bool valid = bytes.size() >= journal_header_size &&
+		std::equal( std::begin(journal_magic), std::end(journal_magic), bytes.begin() ) &&
+		journal_get( bytes.data()+8, 2 ) == 1 && journal_get( bytes.data()+10, 2 ) == journal_header_size &&
+		journal_get( bytes.data()+20, 4 ) == journal_hash( bytes.data() + journal_header_size, bytes.size() - journal_header_size );
+	
+	size_t rows = valid ? journal_get( bytes.data()+12, 4 ) : 0;
+	size_t acknowledged = valid ? journal_get( bytes.data()+16, 4 ) : 0;
+	
+	// parse the rows
+	_i_journal_rows.clear();
+	size_t position = journal_header_size;
+	for( size_t i = 0; valid && i < rows; i++ ){
+		
+		if( position + journal_row_header_size > bytes.size() ){
+			valid = false;
+			break;
+		}
+		
+		const uint8_t* header = bytes.data() + position;
+		size_t payload = journal_get( header+10, 2 );
+		position += journal_row_header_size;
+		
+		if( position + payload > bytes.size() ){
+			valid = false;
+			break;
+		}
+		
+		journal_row row;
+		row.type = header[0];
+		row.request_type = header[1];
+		row.request = header[2];
+		row.value = journal_get( header+4, 2 );
+		row.index = journal_get( header+6, 2 );
+		row.length = journal_get( header+8, 2 );
+		row.data.assign( bytes.begin() + position, bytes.begin() + position + payload );
+		position += payload;
+		
+		_i_journal_rows.push_back( row );
+	}
+	
+	if( !valid || position != bytes.size() || acknowledged > rows ){
+		RD_LOG_WARNING( "invalid journal " << path << ", ignored" );
+		_i_journal_rows.clear();
+		unlink( path.c_str() );
+		return 0;
+	}
+	
+	remaining = rows - acknowledged;
+	RD_LOG_INFO( "journal " << path << ": " << remaining << " of " << rows << " rows not acknowledged" );
+	
+	int ret = 0;
+	if( remaining > 0 ){
+		
+		int fd = open( path.c_str(), O_RDWR );
+		if( fd < 0 ){
+			_i_journal_rows.clear();
+			return 1;
+		}
+		
+		ret = _i_journal_send( fd, acknowledged );
+		close( fd );
+	}
+	
+	if( ret == 0 ){
+		unlink( path.c_str() );
+		journal_sync_directory( path );
+	}
+	
+	_i_journal_rows.clear();
+	
+	return ret;
+}
+
+int rd_mouse::_i_journal_send( int fd, size_t first ){
+	
+	// reopen the session that was open at the first row, the rows before were acknowledged
+	size_t session = _i_journal_rows.size();
+	for( size_t i = 0; i < first; i++ ){
+		
+		const journal_row& row = _i_journal_rows[i];
+		if( row.type == transfer_control && row.request_type == 0x21 && row.data.size() >= 3 && row.data[1] == 0xf5 ){
+			if( row.data[2] == 0x00 )
+				session = i;
+			else if( row.data[2] == 0x01 )
+				session = _i_journal_rows.size();
+		}
+	}
+	
+	for( size_t i = (session < first ? session : first); i < _i_journal_rows.size(); i++ ){
+		
+		// the session row is sent again, then continue after the acknowledged rows
+		if( i > session && i < first )
+			i = first;
+		
+		journal_row& row = _i_journal_rows[i];
+		std::vector< uint8_t > buffer( row.length, 0 );
+		std::copy( row.data.begin(), row.data.begin() + std::min( row.data.size(), buffer.size() ), buffer.begin() );
+		
+		bool acknowledged = false;
+		if( row.type == transfer_interrupt ){
+			int transferred = 0;
+			acknowledged = _i_interrupt_transfer( row.request_type, buffer.data(), row.length, &transferred, 1000 ) == LIBUSB_SUCCESS;
+		} else{
+			acknowledged = _i_control_transfer( row.request_type, row.request, row.value, row.index,
+				row.length > 0 ? buffer.data() : nullptr, row.length, 1000 ) >= 0;
+		}
+		
+		if( _i_transfer_error != 0 )
+			return _i_transfer_error;
+		
+		// the remaining rows are sent by resume_journal on the next run
+		if( !acknowledged ){
+			RD_LOG_ERROR( "row " << i+1 << " of " << _i_journal_rows.size() << " failed, the journal is kept" );
+			_i_close_session();
+			return 1;
+		}
+		
+		if( fd >= 0 && i >= first && !journal_acknowledge( fd, i+1 ) )
+			RD_LOG_WARNING( "couldn't update the journal" );
+	}
+	
+	return 0;
+}
@@ -0,0 +1,276 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+
+#include "light_sync.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+void rd_light_sync::add_device( const std::string& name, rd_sender sender ){
+	
+	device new_device;
+	new_device.name = name;
+	new_device.sender = sender;
+	_i_devices.push_back( new_device );
+}
+
+int rd_light_sync::measure_latency( const rd_color& color, int samples ){
+	
+	int ret = 0;
+	
+	for( auto& device : _i_devices ){
+		
+		std::vector< double > durations;
+		for( int i = 0; i < samples; i++ ){
+			
+			auto start = std::chrono::steady_clock::now();
+			if( device.sender( color ) != 0 )
+				ret = 1;
+			auto end = std::chrono::steady_clock::now();
+			
+			durations.push_back( std::chrono::duration<double, std::micro>( end - start ).count() );
+		}
+		
+		// the median ignores single delayed transfers
+		if( !durations.empty() ){
+			std::nth_element( durations.begin(), durations.begin() + durations.size()/2, durations.end() );
+			device.measured_latency = durations[durations.size()/2];
+		}
+	}
+	
+	return ret;
+}
+
+int rd_light_sync::run( const rd_effect& effect, double frame_rate, double duration, const std::atomic<bool>* cancel ){
+	
+	if( _i_devices.empty() || frame_rate <= 0 || duration < 0 )
+		return 1;
+	
+	_i_frames = duration > 0 ? (size_t)std::ceil( duration * frame_rate ) : std::numeric_limits<size_t>::max();
+	
+	auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>( std::chrono::duration<double>( 1.0 / frame_rate ) );
+	
+	// the first frame leaves time to start the threads and to send early by the latency
+	double max_latency = 0;
+	for( auto& device : _i_devices ){
+		device.latency = device.measured_latency;
+		device.applied.clear();
+		device.errors.clear();
+		device.unchanged = device.dropped = device.failed = 0;
+		max_latency = std::max( max_latency, device.latency );
+	}
+	auto start = std::chrono::steady_clock::now() + std::chrono::milliseconds( 50 )
+		+ std::chrono::duration_cast<std::chrono::steady_clock::duration>( std::chrono::duration<double, std::micro>( max_latency ) );
+	
+	std::vector< std::thread > threads;
+	for( size_t i = 0; i < _i_devices.size(); i++ )
+		threads.emplace_back( &rd_light_sync::_i_run_device, this, i, std::cref( effect ), start, period, _i_frames, cancel );
+	
+	for( auto& thread : threads )
+		thread.join();
+	
+	// frames actually run, less than planned if cancelled
+	_i_frames = 0;
+	for( auto& device : _i_devices )
+		_i_frames = std::max( _i_frames, device.applied.size() );
+	
+	return 0;
+}
+
+void rd_light_sync::_i_run_device( size_t index, const rd_effect& effect, std::chrono::steady_clock::time_point start,
+	std::chrono::steady_clock::duration period, size_t frames, const std::atomic<bool>* cancel ){
+	
+	device& device = _i_devices[index];
+	rd_color last = {};
+	bool has_last = false;
+	
+	for( size_t frame = 0; frame < frames; frame++ ){
+		
+		if( cancel != nullptr && *cancel )
+			break;
+		
+		auto frame_time = start + frame * period;
+		rd_color color = effect( index, _i_devices.size(), std::chrono::duration<double>( frame_time - start ).count() );
+		
+		// only changed colors are sent
+		if( has_last && color == last ){
+			device.unchanged++;
+			device.applied.push_back( -1 );
+			continue;
+		}
+		
+		// a late frame is dropped instead of delaying the following frames
+		auto send_time = frame_time - std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+			std::chrono::duration<double, std::micro>( device.latency ) );
+		if( std::chrono::steady_clock::now() > send_time + period ){
+			device.dropped++;
+			device.applied.push_back( -1 );
+			continue;
+		}
+		
+		wait_until( send_time );
+		
+		auto send_start = std::chrono::steady_clock::now();
+		int ret = device.sender( color );
+		auto send_end = std::chrono::steady_clock::now();
+		
+		if( ret != 0 ){
+			device.failed++;
+			device.applied.push_back( -1 );
+			has_last = false;
+			continue;
+		}
+		
+		// the color is applied when the last report of the send was acknowledged
+		double applied = std::chrono::duration<double, std::micro>( send_end - start ).count();
+		device.applied.push_back( applied );
+		device.errors.push_back( applied - std::chrono::duration<double, std::micro>( frame_time - start ).count() );
+		
+		// follow slow changes of the latency
+		device.latency = 0.8 * device.latency + 0.2 * std::chrono::duration<double, std::micro>( send_end - send_start ).count();
+		
+		last = color;
+		has_last = true;
+	}
+}
+
+rd_light_sync::sync_stats rd_light_sync::get_stats(){
+	
+	sync_stats stats;
+	stats.frames = _i_frames;
+	
+	for( auto& device : _i_devices ){
+		
+		device_stats result;
+		result.name = device.name;
+		result.latency = device.measured_latency;
+		result.sent = device.errors.size();
+		result.unchanged = device.unchanged;
+		result.dropped = device.dropped;
+		result.failed = device.failed;
+		
+		for( double error : device.errors ){
+			result.mean_error += std::abs( error );
+			result.max_error = std::max( result.max_error, std::abs( error ) );
+		}
+		if( !device.errors.empty() )
+			result.mean_error /= device.errors.size();
+		
+		stats.devices.push_back( result );
+	}
+	
+	// skew: spread of the apply times of the devices that sent the same frame
+	for( size_t frame = 0; frame < _i_frames; frame++ ){
+		
+		double first = std::numeric_limits<double>::max(), last = std::numeric_limits<double>::lowest();
+		int applied = 0;
+		
+		for( auto& device : _i_devices ){
+			if( frame < device.applied.size() && device.applied[frame] >= 0 ){
+				first = std::min( first, device.applied[frame] );
+				last = std::max( last, device.applied[frame] );
+				applied++;
+			}
+		}
+		
+		if( applied >= 2 ){
+			stats.compared_frames++;
+			stats.mean_skew += last - first;
+			stats.max_skew = std::max( stats.max_skew, last - first );
+		}
+	}
+	if( stats.compared_frames > 0 )
+		stats.mean_skew /= stats.compared_frames;
+	
+	return stats;
+}
+
+void rd_light_sync::print_stats( std::ostream& output ){
+	
+	sync_stats stats = get_stats();
+	
+	output << "Frames: " << stats.frames << "\n";
+	for( auto& device : stats.devices ){
+		output << device.name << ": latency " << device.latency << " µs, sent " << device.sent
+			<< ", unchanged " << device.unchanged << ", dropped " << device.dropped << ", failed " << device.failed
+			<< ", error mean " << device.mean_error << " µs, max " << device.max_error << " µs\n";
+	}
+	output << "Skew between devices: mean " << stats.mean_skew << " µs, max " << stats.max_skew
+		<< " µs (" << stats.compared_frames << " frames)\n";
+}
+
+// color from hue (0-1, wraps around) and value (0-1), full saturation
+static rd_light_sync::rd_color hue_color( double hue, double value ){
+	
+	hue = (hue - std::floor( hue )) * 6;
+	double fraction = hue - std::floor( hue );
+	
+	double rgb[3];
+	switch( (int)hue ){
+		case 0: rgb[0] = 1; rgb[1] = fraction; rgb[2] = 0; break;
+		case 1: rgb[0] = 1 - fraction; rgb[1] = 1; rgb[2] = 0; break;
+		case 2: rgb[0] = 0; rgb[1] = 1; rgb[2] = fraction; break;
+		case 3: rgb[0] = 0; rgb[1] = 1 - fraction; rgb[2] = 1; break;
+		case 4: rgb[0] = fraction; rgb[1] = 0; rgb[2] = 1; break;
+		default: rgb[0] = 1; rgb[1] = 0; rgb[2] = 1 - fraction; break;
+	}
+	
+	return { (uint8_t)std::lround( rgb[0] * value * 255 ), (uint8_t)std::lround( rgb[1] * value * 255 ),
+		(uint8_t)std::lround( rgb[2] * value * 255 ) };
+}
+
+int rd_light_sync::effect( const std::string& name, rd_effect& effect ){
+	
+	if( name == "rainbow" ){
+		// all devices cycle through the hues, 5 s per cycle
+		effect = []( size_t, size_t, double time ){ return hue_color( time / 5.0, 1 ); };
+	} else if( name == "wave" ){
+		// like rainbow, shifted by the position of the device
+		effect = []( size_t device, size_t devices, double time ){ return hue_color( time / 5.0 + (double)device / devices, 1 ); };
+	} else if( name == "breathing" ){
+		// white, fading in and out every 4 s
+		effect = []( size_t, size_t, double time ){
+			uint8_t value = (uint8_t)std::lround( (1 - std::cos( time * M_PI / 2 )) / 2 * 255 );
+			return rd_color{ value, value, value };
+		};
+	} else if( name == "chase" ){
+		// one device after the other lights up, 0.25 s each
+		effect = []( size_t device, size_t devices, double time ){
+			bool on = (size_t)( time * 4 ) % devices == device;
+			return on ? rd_color{ 0xff, 0xff, 0xff } : rd_color{ 0, 0, 0 };
+		};
+	} else{
+		return 1;
+	}
+	
+	return 0;
+}
+
+void rd_light_sync::wait_until( std::chrono::steady_clock::time_point time ){
+	
+	// the scheduler wakes up late by up to a few hundred µs, the rest is spent spinning
+	auto spin = std::chrono::microseconds( 500 );
+	if( std::chrono::steady_clock::now() < time - spin )
+		std::this_thread::sleep_until( time - spin );
+	
+	while( std::chrono::steady_clock::now() < time )
+		std::this_thread::yield();
+}
@@ -0,0 +1,154 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+
+#ifndef RD_LIGHT_SYNC
+#define RD_LIGHT_SYNC
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * Host-driven lighting effects that stay in sync over several mice.
+ *
+ * The hardware lightmodes of the mice drift apart because each mouse runs
+ * its own clock. Instead, one timeline on the host computes a color for
+ * every device and frame, and only the color report is sent to each device.
+ *
+ * Each device is driven by its own thread, the send of a frame starts early
+ * by the latency of the device (measured before the effect and updated
+ * during it) so that the color is applied at the frame time on all devices.
+ * The difference between the devices (skew) is recorded for each frame.
+ *
+ */
+class rd_light_sync{
+	
+	public:
+		
+		/// RGB color
+		typedef std::array<uint8_t, 3> rd_color;
+		
+		/** \brief Computes the color of a device
+		 * \arg device index of the device
+		 * \arg devices number of devices
+		 * \arg time time since the start of the effect in s
+		 */
+		typedef std::function< rd_color( size_t device, size_t devices, double time ) > rd_effect;
+		
+		/// Sends a color to a device, returns 0 if successful
+		typedef std::function< int( const rd_color& color ) > rd_sender;
+		
+		/// Results of one device
+		struct device_stats{
+			/// name given to add_device
+			std::string name;
+			/// latency (duration of a send) in µs, measured by measure_latency
+			double latency = 0;
+			/// number of frames sent
+			size_t sent = 0;
+			/// number of frames not sent because the color didn't change
+			size_t unchanged = 0;
+			/// number of frames dropped because the device fell behind by more than one frame
+			size_t dropped = 0;
+			/// number of failed sends
+			size_t failed = 0;
+			/// mean and maximum difference between the time the color was applied and the frame time in µs
+			double mean_error = 0, max_error = 0;
+		};
+		
+		/// Results of the effect
+		struct sync_stats{
+			/// number of frames of the timeline
+			size_t frames = 0;
+			/// number of frames that were applied on at least two devices
+			size_t compared_frames = 0;
+			/// mean and maximum difference between the devices in µs
+			double mean_skew = 0, max_skew = 0;
+			/// results of each device
+			std::vector< device_stats > devices;
+		};
+		
+		/// Add a device, the index of the device is passed to the effect
+		void add_device( const std::string& name, rd_sender sender );
+		
+		/// Number of devices
+		size_t size(){ return _i_devices.size(); }
+		
+		/** \brief Measure the latency of each device by sending color
+		 * \arg samples number of sends per device, the median is used
+		 * \return 0 if successful, 1 if a send failed
+		 */
+		int measure_latency( const rd_color& color, int samples = 5 );
+		
+		/** \brief Run the effect on all devices
+		 * \arg frame_rate frames per second
+		 * \arg duration length of the effect in s, 0 = until cancel becomes true
+		 * \arg cancel stops the effect once it becomes true, nullptr if unused
+		 * \return 0 if successful, 1 if the arguments are invalid or there are no devices
+		 */
+		int run( const rd_effect& effect, double frame_rate, double duration, const std::atomic<bool>* cancel = nullptr );
+		
+		/// Get the results of the last run
+		sync_stats get_stats();
+		
+		/// Print the results of the last run
+		void print_stats( std::ostream& output );
+		
+		/** \brief Get an effect by name
+		 * \arg name rainbow, wave, breathing or chase
+		 * \return 0 if successful, 1 if the name is unknown
+		 */
+		static int effect( const std::string& name, rd_effect& effect );
+		
+		/// Wait until time: sleep until shortly before, then spin for an exact wakeup
+		static void wait_until( std::chrono::steady_clock::time_point time );
+		
+	private:
+		
+		/// one device
+		struct device{
+			std::string name;
+			rd_sender sender;
+			/// latency in µs, updated during the run
+			double latency = 0;
+			/// latency measured by measure_latency in µs
+			double measured_latency = 0;
+			/// time the color of each frame was applied in µs since the start, negative if not sent
+			std::vector< double > applied;
+			/// error of each frame in µs
+			std::vector< double > errors;
+			size_t unchanged = 0, dropped = 0, failed = 0;
+		};
+		
+		/// Send the frames to one device, runs in its own thread
+		void _i_run_device( size_t index, const rd_effect& effect, std::chrono::steady_clock::time_point start,
+			std::chrono::steady_clock::duration period, size_t frames, const std::atomic<bool>* cancel );
+		
+		/// the devices
+		std::vector< device > _i_devices;
+		/// number of frames of the last run
+		size_t _i_frames = 0;
+};
+
+#endif
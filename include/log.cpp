@@ -0,0 +1,104 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+#include "log.h"
+
+#include <syslog.h>
+
+int rd_log::set_level( const std::string& name ){
+
+	if( name == "off" )
+		_i_level = level_off;
+	else if( name == "error" )
+		_i_level = level_error;
+	else if( name == "warning" )
+		_i_level = level_warning;
+	else if( name == "info" )
+		_i_level = level_info;
+	else if( name == "debug" )
+		_i_level = level_debug;
+	else if( name == "trace" )
+		_i_level = level_trace;
+	else
+		return 1;
+
+	// tell the user that the messages of this level were removed at compile time
+	if( _i_level > RD_LOG_LEVEL )
+		std::cerr << "Warning: log messages above level " << RD_LOG_LEVEL << " are disabled in this build\n";
+
+	return 0;
+}
+
+int rd_log::set_sink( rd_log_sink sink, const std::string& path ){
+
+	std::lock_guard< std::mutex > lock( _i_mutex );
+
+	if( _i_file.is_open() )
+		_i_file.close();
+	if( _i_sink == sink_syslog )
+		closelog();
+
+	if( sink == sink_file ){
+		_i_file.open( path, std::ios::app );
+		if( !_i_file.is_open() ){
+			_i_sink = sink_stderr;
+			return 1;
+		}
+	} else if( sink == sink_syslog ){
+		openlog( "mouse_m908", LOG_PID, LOG_USER );
+	}
+
+	_i_sink = sink;
+	return 0;
+}
+
+int rd_log::set_sink( const std::string& name ){
+
+	if( name == "stderr" )
+		return set_sink( sink_stderr );
+	else if( name == "syslog" )
+		return set_sink( sink_syslog );
+
+	return set_sink( sink_file, name );
+}
+
+void rd_log::write( rd_log_level level, const char* function, const std::string& message ){
+
+	static const char* level_names[] = { "off", "error", "warning", "info", "debug", "trace" };
+
+	std::lock_guard< std::mutex > lock( _i_mutex );
+
+	if( _i_sink == sink_syslog ){
+
+		int priority = LOG_DEBUG;
+		if( level == level_error )
+			priority = LOG_ERR;
+		else if( level == level_warning )
+			priority = LOG_WARNING;
+		else if( level == level_info )
+			priority = LOG_INFO;
+
+		syslog( priority, "%s: %s", function, message.c_str() );
+
+	} else{
+
+		std::ostream& output = _i_sink == sink_file ? _i_file : std::cerr;
+		output << level_names[level] << ": " << function << ": " << message << std::endl;
+
+	}
+}
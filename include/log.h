@@ -0,0 +1,179 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+#ifndef RD_LOG
+#define RD_LOG
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+/* Log levels for the compile-time filter. Messages above RD_LOG_LEVEL
+ * are removed by the preprocessor, their arguments are not evaluated.
+ * Build with -D RD_LOG_LEVEL=5 to include the trace messages (every
+ * USB transfer).
+ */
+#define RD_LOG_LEVEL_OFF 0
+#define RD_LOG_LEVEL_ERROR 1
+#define RD_LOG_LEVEL_WARNING 2
+#define RD_LOG_LEVEL_INFO 3
+#define RD_LOG_LEVEL_DEBUG 4
+#define RD_LOG_LEVEL_TRACE 5
+
+#ifndef RD_LOG_LEVEL
+#define RD_LOG_LEVEL RD_LOG_LEVEL_DEBUG
+#endif
+
+/**
+ * Logging and tracing for the mouse_m908 project.
+ *
+ * Messages are written with the RD_LOG_* macros, the message is an
+ * expression for operator<<, e.g. RD_LOG_DEBUG( "row " << i ).
+ * The level is filtered twice: at compile time by RD_LOG_LEVEL and at
+ * runtime by set_level(). A message that passes the compile-time filter
+ * but not the runtime filter costs one comparison.
+ *
+ */
+class rd_log{
+
+	public:
+
+		/// The log levels, same values as RD_LOG_LEVEL_*
+		enum rd_log_level{
+			level_off = RD_LOG_LEVEL_OFF,
+			level_error = RD_LOG_LEVEL_ERROR,
+			level_warning = RD_LOG_LEVEL_WARNING,
+			level_info = RD_LOG_LEVEL_INFO,
+			level_debug = RD_LOG_LEVEL_DEBUG,
+			level_trace = RD_LOG_LEVEL_TRACE
+		};
+
+		/// Where the messages are written to
+		enum rd_log_sink{
+			sink_stderr,
+			sink_file,
+			sink_syslog
+		};
+
+		/// Hexdump of a buffer for operator<<, e.g. RD_LOG_TRACE( rd_log::hex( buffer, 16 ) )
+		struct hex{
+			const uint8_t* data;
+			size_t length;
+			hex( const uint8_t* data, size_t length ) : data( data ), length( length ) {}
+		};
+
+		/// Whether messages of the given level are written (runtime filter)
+		static bool enabled( rd_log_level level ){ return level <= _i_level; }
+
+		/// Set the runtime log level
+		static void set_level( rd_log_level level ){ _i_level = level; }
+		/// Get _i_level
+		static rd_log_level get_level(){ return _i_level; }
+
+		/** \brief Set the runtime log level by name
+		 * \arg name off, error, warning, info, debug or trace
+		 * \return 0 if successful, 1 if the name is unknown
+		 */
+		static int set_level( const std::string& name );
+
+		/** \brief Select where the messages are written to
+		 * \arg sink sink_stderr, sink_file or sink_syslog
+		 * \arg path file for sink_file, ignored otherwise
+		 * \return 0 if successful
+		 */
+		static int set_sink( rd_log_sink sink, const std::string& path = "" );
+
+		/** \brief Select where the messages are written to by name
+		 * \arg name stderr, syslog or a file path
+		 * \return 0 if successful
+		 */
+		static int set_sink( const std::string& name );
+
+		/// Write a message to the sink, used by the RD_LOG_* macros after the level was checked
+		static void write( rd_log_level level, const char* function, const std::string& message );
+
+	private:
+
+		/// runtime log level
+		inline static rd_log_level _i_level = level_warning;
+		/// current sink
+		inline static rd_log_sink _i_sink = sink_stderr;
+		/// file for sink_file
+		inline static std::ofstream _i_file;
+		/// serializes the messages of several threads (--sync-lighting) and changes of the sink
+		inline static std::mutex _i_mutex;
+};
+
+/// Print a hexdump
+inline std::ostream& operator<<( std::ostream& output, const rd_log::hex& bytes ){
+
+	output << std::hex << std::setfill('0');
+	for( size_t i = 0; bytes.data != nullptr && i < bytes.length; i++ ){
+		output << (i > 0 ? " " : "") << std::setw(2) << (int)bytes.data[i];
+	}
+	output << std::dec << std::setfill(' ');
+
+	return output;
+}
+
+/// Write message if level passes the runtime filter, use the RD_LOG_* macros instead
+#define RD_LOG_MESSAGE( level, message ) \
+	do{ \
+		if( rd_log::enabled( level ) ){ \
+			std::ostringstream rd_log_stream; \
+			rd_log_stream << message; \
+			rd_log::write( level, __func__, rd_log_stream.str() ); \
+		} \
+	} while( 0 )
+
+#if RD_LOG_LEVEL >= RD_LOG_LEVEL_ERROR
+#define RD_LOG_ERROR( message ) RD_LOG_MESSAGE( rd_log::level_error, message )
+#else
+#define RD_LOG_ERROR( message ) do{} while( 0 )
+#endif
+
+#if RD_LOG_LEVEL >= RD_LOG_LEVEL_WARNING
+#define RD_LOG_WARNING( message ) RD_LOG_MESSAGE( rd_log::level_warning, message )
+#else
+#define RD_LOG_WARNING( message ) do{} while( 0 )
+#endif
+
+#if RD_LOG_LEVEL >= RD_LOG_LEVEL_INFO
+#define RD_LOG_INFO( message ) RD_LOG_MESSAGE( rd_log::level_info, message )
+#else
+#define RD_LOG_INFO( message ) do{} while( 0 )
+#endif
+
+#if RD_LOG_LEVEL >= RD_LOG_LEVEL_DEBUG
+#define RD_LOG_DEBUG( message ) RD_LOG_MESSAGE( rd_log::level_debug, message )
+#else
+#define RD_LOG_DEBUG( message ) do{} while( 0 )
+#endif
+
+#if RD_LOG_LEVEL >= RD_LOG_LEVEL_TRACE
+#define RD_LOG_TRACE( message ) RD_LOG_MESSAGE( rd_log::level_trace, message )
+#else
+#define RD_LOG_TRACE( message ) do{} while( 0 )
+#endif
+
+#endif
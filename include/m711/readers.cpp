@@ -22,6 +22,8 @@
 
 int mouse_m711::dump_settings( std::ostream& output ){
 	
+	RD_LOG_DEBUG( "model " << get_name() );
+	
 	//prepare data 1
 	int rows1 = sizeof(_c_data_read_1) / sizeof(_c_data_read_1[0]);
 	uint8_t buffer1[rows1][16];
@@ -48,13 +50,13 @@ int mouse_m711::dump_settings( std::ostream& output ){
 	//send data 1
 	uint8_t buffer_in1[16];
 	int num_bytes_in;
-	libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer1[0], 16, 1000 );
+	_i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, buffer1[0], 16, 1000 );
 	for( int i = 1; i < rows1; i++ ){
 		// control out
-		libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer1[i], 16, 1000 );
+		_i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, buffer1[i], 16, 1000 );
 		
 		// control in
-		num_bytes_in = libusb_control_transfer( _i_handle, 0xa1, 0x01, 0x0302, 0x0002, buffer_in1, 16, 1000 );
+		num_bytes_in = _i_control_transfer( 0xa1, 0x01, 0x0302, 0x0002, buffer_in1, 16, 1000 );
 		
 		// hexdump
 		if ( num_bytes_in > 0 ){
@@ -72,10 +74,10 @@ int mouse_m711::dump_settings( std::ostream& output ){
 	uint8_t buffer_in2[64];
 	for( int i = 0; i < rows2; i++ ){
 		// control out
-		libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0303, 0x0002, buffer2[i], 64, 1000 );
+		_i_control_transfer( 0x21, 0x09, 0x0303, 0x0002, buffer2[i], 64, 1000 );
 		
 		// control in
-		num_bytes_in = libusb_control_transfer( _i_handle, 0xa1, 0x01, 0x0303, 0x0002, buffer_in2, 64, 1000 );
+		num_bytes_in = _i_control_transfer( 0xa1, 0x01, 0x0303, 0x0002, buffer_in2, 64, 1000 );
 		
 		// hexdump
 		if ( num_bytes_in > 0 ){
@@ -93,10 +95,10 @@ int mouse_m711::dump_settings( std::ostream& output ){
 	uint8_t buffer_in3[16];
 	for( int i = 0; i < rows3-1; i++ ){
 		// control out
-		libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer3[i], 16, 1000 );
+		_i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, buffer3[i], 16, 1000 );
 		
 		// control in
-		num_bytes_in = libusb_control_transfer( _i_handle, 0xa1, 0x01, 0x0302, 0x0002, buffer_in3, 16, 1000 );
+		num_bytes_in = _i_control_transfer( 0xa1, 0x01, 0x0302, 0x0002, buffer_in3, 16, 1000 );
 		
 		// hexdump
 		if ( num_bytes_in > 0 ){
@@ -107,13 +109,15 @@ int mouse_m711::dump_settings( std::ostream& output ){
 			output << "\n\n" << std::dec << std::setw(0) << std::setfill(' ');
 		}
 	}
-	libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer3[45], 16, 1000 );
+	_i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, buffer3[45], 16, 1000 );
 	
-	return 0;
+	return _i_transfer_error;
 }
 
 int mouse_m711::read_and_print_settings( std::ostream& output ){
 	
+	RD_LOG_DEBUG( "model " << get_name() );
+	
 	//prepare data 1
 	int rows1 = sizeof(_c_data_read_1) / sizeof(_c_data_read_1[0]);
 	uint8_t buffer1[rows1][16];
@@ -138,40 +142,37 @@ int mouse_m711::read_and_print_settings( std::ostream& output ){
 	
 	//send data 1
 	uint8_t buffer_in1[8][16] = {{0}};
-	libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer1[0], 16, 1000 );
+	_i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, buffer1[0], 16, 1000 );
 	for( int i = 1; i < rows1; i++ ){
 		// control out
-		libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer1[i], 16, 1000 );
+		_i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, buffer1[i], 16, 1000 );
 		
 		// control in
-		libusb_control_transfer( _i_handle, 0xa1, 0x01, 0x0302, 0x0002, buffer_in1[i-1], 16, 1000 );
+		_i_control_transfer( 0xa1, 0x01, 0x0302, 0x0002, buffer_in1[i-1], 16, 1000 );
 		
 	}
 	
-	//send data 2
+	//send data 2 (rows 5-84 are the macro slots, empty slots are skipped after their first row)
 	uint8_t buffer_in2[85][64] = {{0}};
-	for( int i = 0; i < rows2; i++ ){
-		// control out
-		libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0303, 0x0002, buffer2[i], 64, 1000 );
-		
-		// control in
-		libusb_control_transfer( _i_handle, 0xa1, 0x01, 0x0303, 0x0002, buffer_in2[i], 64, 1000 );
-		
-	}
+	_i_read_macro_rows( buffer2, buffer_in2, rows2, 5 );
 	
 	//send data 3
 	uint8_t buffer_in3[45][16] = {{0}};
 	for( int i = 0; i < rows3-1; i++ ){
 		// control out
-		libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer3[i], 16, 1000 );
+		_i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, buffer3[i], 16, 1000 );
 		
 		// control in
-		libusb_control_transfer( _i_handle, 0xa1, 0x01, 0x0302, 0x0002, buffer_in3[i], 16, 1000 );
+		_i_control_transfer( 0xa1, 0x01, 0x0302, 0x0002, buffer_in3[i], 16, 1000 );
 		
 	}
-	libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer3[45], 16, 1000 );
+	_i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, buffer3[45], 16, 1000 );
 	
 	
+	// stop if the transfers were aborted (deadline or cancellation)
+	if( _i_transfer_error != 0 )
+		return _i_transfer_error;
+	
 	// print configuration
 	output << "# Configuration created with mouse_m908 -R.\n";
 	output << "# This configuration can be send to the mouse with mouse_m908 -c.\n";
@@ -297,6 +298,8 @@ int mouse_m711::read_and_print_settings( std::ostream& output ){
 
 int mouse_m711::read_settings(){
 	
+	RD_LOG_DEBUG( "model " << get_name() );
+	
 	//prepare data 1
 	int rows1 = sizeof(_c_data_read_1) / sizeof(_c_data_read_1[0]);
 	uint8_t buffer1[rows1][16];
@@ -321,13 +324,13 @@ int mouse_m711::read_settings(){
 	
 	//send data 1
 	uint8_t buffer_in1[8][16] = {{0}};
-	libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer1[0], 16, 1000 );
+	_i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, buffer1[0], 16, 1000 );
 	for( int i = 1; i < rows1; i++ ){
 		// control out
-		libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer1[i], 16, 1000 );
+		_i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, buffer1[i], 16, 1000 );
 		
 		// control in
-		libusb_control_transfer( _i_handle, 0xa1, 0x01, 0x0302, 0x0002, buffer_in1[i-1], 16, 1000 );
+		_i_control_transfer( 0xa1, 0x01, 0x0302, 0x0002, buffer_in1[i-1], 16, 1000 );
 		
 	}
 	
@@ -335,10 +338,10 @@ int mouse_m711::read_settings(){
 	uint8_t buffer_in2[85][64] = {{0}};
 	for( int i = 0; i < rows2; i++ ){
 		// control out
-		libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0303, 0x0002, buffer2[i], 64, 1000 );
+		_i_control_transfer( 0x21, 0x09, 0x0303, 0x0002, buffer2[i], 64, 1000 );
 		
 		// control in
-		libusb_control_transfer( _i_handle, 0xa1, 0x01, 0x0303, 0x0002, buffer_in2[i], 64, 1000 );
+		_i_control_transfer( 0xa1, 0x01, 0x0303, 0x0002, buffer_in2[i], 64, 1000 );
 		
 	}
 	
@@ -346,13 +349,17 @@ int mouse_m711::read_settings(){
 	uint8_t buffer_in3[45][16] = {{0}};
 	for( int i = 0; i < rows3-1; i++ ){
 		// control out
-		libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer3[i], 16, 1000 );
+		_i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, buffer3[i], 16, 1000 );
 		
 		// control in
-		libusb_control_transfer( _i_handle, 0xa1, 0x01, 0x0302, 0x0002, buffer_in3[i], 16, 1000 );
+		_i_control_transfer( 0xa1, 0x01, 0x0302, 0x0002, buffer_in3[i], 16, 1000 );
 		
 	}
-	libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer3[45], 16, 1000 );
+	_i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, buffer3[45], 16, 1000 );
+	
+	// stop if the transfers were aborted (deadline or cancellation)
+	if( _i_transfer_error != 0 )
+		return _i_transfer_error;
 	
 	// parse received data
 	
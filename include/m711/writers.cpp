@@ -22,6 +22,8 @@
 
 int mouse_m711::write_profile(){
 	
+	RD_LOG_DEBUG( "model " << get_name() << ", profile " << _s_profile+1 );
+	
 	//prepare data
 	uint8_t buffer[6][16];
 	for( int i = 0; i < 6; i++ ){
@@ -33,14 +35,16 @@ int mouse_m711::write_profile(){
 	
 	//send data
 	for( int i = 0; i < 6; i++ ){
-		libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer[i], 16, 1000 );
+		_i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, buffer[i], 16, 1000 );
 	}
 	
-	return 0;
+	return _i_transfer_error;
 }
 
 int mouse_m711::write_settings(){
 	
+	RD_LOG_DEBUG( "model " << get_name() );
+	
 	//prepare data 1
 	int rows1 = sizeof(_c_data_settings_1) / sizeof(_c_data_settings_1[0]);
 	uint8_t buffer1[rows1][16];
@@ -109,7 +113,7 @@ int mouse_m711::write_settings(){
 			buffer3[35+(8*i)+j][9] = _s_keymap_data[i][j][1];
 			buffer3[35+(8*i)+j][10] = _s_keymap_data[i][j][2];
 			buffer3[35+(8*i)+j][11] = _s_keymap_data[i][j][3];
-			//std::cout << (int)_s_keymap_data[i][j][0] << " " << (int)_s_keymap_data[i][j][1] << " " << (int)_s_keymap_data[i][j][2] << " " << (int)_s_keymap_data[i][j][3] << "\n";
+			RD_LOG_TRACE( "profile " << i+1 << ", button " << j << ": " << rd_log::hex( _s_keymap_data[i][j].data(), 4 ) );
 		}
 	}
 	
@@ -122,29 +126,32 @@ int mouse_m711::write_settings(){
 	
 	//send data 1
 	for( int i = 0; i < rows1; i++ ){
-		libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer1[i], 16, 1000 );
+		_i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, buffer1[i], 16, 1000 );
 	}
 	
 	// Currently no data capture available 
 	//send data 2
-	libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer2, 64, 1000 );
+	_i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, buffer2, 64, 1000 );
 	
 	//send data 3
 	for( int i = 0; i < rows3; i++ ){
-		libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer3[i], 16, 1000 );
+		_i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, buffer3[i], 16, 1000 );
 	}
 	// end
 	
-	return 0;
+	return _i_transfer_error;
 }
 
 int mouse_m711::write_macro( int macro_number ){
 	
 	//check if macro_number is valid
 	if( macro_number < 1 || macro_number > 15 ){
+		RD_LOG_ERROR( "invalid macro number " << macro_number );
 		return 1;
 	}
 	
+	RD_LOG_DEBUG( "model " << get_name() << ", macro " << macro_number );
+	
 	//prepare data 1
 	uint8_t buffer1[16];
 	std::copy(std::begin(_c_data_macros_1), std::end(_c_data_macros_1), std::begin(buffer1));
@@ -158,13 +165,13 @@ int mouse_m711::write_macro( int macro_number ){
 	std::copy(std::begin(_c_data_macros_3), std::end(_c_data_macros_3), std::begin(buffer3));
 	
 	//send data 1
-	libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer1, 16, 1000 );
+	_i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, buffer1, 16, 1000 );
 	
 	//send data 2
-	libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer2, 256, 1000 );
+	_i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, buffer2, 256, 1000 );
 	
 	//send data 3
-	libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer3, 16, 1000 );
+	_i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, buffer3, 16, 1000 );
 	
-	return 0;
+	return _i_transfer_error;
 }
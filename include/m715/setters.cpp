@@ -236,3 +236,21 @@ int mouse_m715::set_all_macros( std::string file ){
 	
 	return 0;
 }
+
+int mouse_m715::set_macro_raw( int macro_number, const std::array<uint8_t, 256>& macro ){
+	
+	//check if macro_number is valid
+	if( macro_number < 1 || macro_number > 15 ){
+		return 1;
+	}
+	
+	//the slot image must be addressed to this slot
+	if( macro[0] != _c_data_macros_2[0] || macro[1] != _c_data_macros_2[1] ||
+		macro[2] != _c_data_macros_codes[macro_number-1][0] || macro[3] != _c_data_macros_codes[macro_number-1][1] ){
+		return 1;
+	}
+	
+	std::copy( macro.begin(), macro.end(), _s_macro_data[macro_number-1].begin() );
+	
+	return 0;
+}
@@ -144,6 +144,13 @@ class mouse_m719 : public rd_mouse{
 		 */
 		int set_all_macros( std::string file );
 		
+		/** \brief Load a pre-encoded macro slot image (e.g. from a macro bank)
+		 * The image must contain the slot code of macro_number (see _c_data_macros_codes).
+		 * \param macro_number macro slot (1-15)
+		 * \return 0 if successful, 1 if the image doesn't belong to this slot
+		 */
+		int set_macro_raw( int macro_number, const std::array<uint8_t, 256>& macro );
+		
 		/// Does nothing, exists only for compatibility
 		void set_vid( uint16_t vid ){ (void)vid; }
 		/// Does nothing, exists only for compatibility
@@ -186,6 +193,11 @@ class mouse_m719 : public rd_mouse{
 			return vid == _c_mouse_vid && pid == _c_mouse_pid;
 		}
 		
+		/// Get the USB ids of the model (vendor id, product id)
+		static std::vector< std::pair<uint16_t, uint16_t> > get_ids(){
+			return { { _c_mouse_vid, _c_mouse_pid } };
+		}
+		
 		/// Get mouse name
 		static std::string get_name(){
 			return _c_name;
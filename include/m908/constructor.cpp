@@ -36,10 +36,7 @@ mouse_m908::mouse_m908(){
 	// button mapping
 	for( int i = 0; i < 5; i++ ){
 		for( int j = 0; j < 20; j++ ){
-			_s_keymap_data[i][j][0] = _c_data_settings_3[35+(20*i)+j][8];
-			_s_keymap_data[i][j][1] = _c_data_settings_3[35+(20*i)+j][9];
-			_s_keymap_data[i][j][2] = _c_data_settings_3[35+(20*i)+j][10];
-			_s_keymap_data[i][j][3] = _c_data_settings_3[35+(20*i)+j][11];
+			_s_keymap_data[i][j] = mouse_m908_profile::default_key_mapping( i, j );
 		}
 	}
 	
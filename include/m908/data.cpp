@@ -52,102 +52,9 @@ std::map< int, std::string > mouse_m908::_c_button_names = {
 	{ 19, "scroll_down" } };
 
 // Mapping of real DPI values to bytecode
-std::map< unsigned int, std::array<uint8_t, 2> > mouse_m908::_c_dpi_codes = {
-	{ 200, {0x4, 0x00} },
-	{ 300, {0x6, 0x00} },
-	{ 400, {0x9, 0x00} },
-	{ 500, {0xb, 0x00} },
-	{ 600, {0xd, 0x00} },
-	{ 700, {0xf, 0x00} },
-	{ 800, {0x12, 0x00} },
-	{ 900, {0x14, 0x00} },
-	{ 1000, {0x16, 0x00} },
-	{ 1100, {0x18, 0x00} },
-	{ 1200, {0x1b, 0x00} },
-	{ 1300, {0x1d, 0x00} },
-	{ 1400, {0x1f, 0x00} },
-	{ 1500, {0x21, 0x00} },
-	{ 1600, {0x24, 0x00} },
-	{ 1700, {0x26, 0x00} },
-	{ 1800, {0x28, 0x00} },
-	{ 1900, {0x2b, 0x00} },
-	{ 2000, {0x2d, 0x00} },
-	{ 2100, {0x2f, 0x00} },
-	{ 2200, {0x31, 0x00} },
-	{ 2300, {0x34, 0x00} },
-	{ 2400, {0x36, 0x00} },
-	{ 2500, {0x38, 0x00} },
-	{ 2600, {0x3a, 0x00} },
-	{ 2700, {0x3d, 0x00} },
-	{ 2800, {0x3f, 0x00} },
-	{ 2900, {0x41, 0x00} },
-	{ 3000, {0x43, 0x00} },
-	{ 3100, {0x46, 0x00} },
-	{ 3200, {0x48, 0x00} },
-	{ 3300, {0x4a, 0x00} },
-	{ 3400, {0x4d, 0x00} },
-	{ 3500, {0x4f, 0x00} },
-	{ 3600, {0x51, 0x00} },
-	{ 3700, {0x53, 0x00} },
-	{ 3800, {0x56, 0x00} },
-	{ 3900, {0x58, 0x00} },
-	{ 4000, {0x5a, 0x00} },
-	{ 4100, {0x5c, 0x00} },
-	{ 4200, {0x5f, 0x00} },
-	{ 4300, {0x61, 0x00} },
-	{ 4400, {0x63, 0x00} },
-	{ 4500, {0x66, 0x00} },
-	{ 4600, {0x68, 0x00} },
-	{ 4700, {0x6a, 0x00} },
-	{ 4800, {0x6c, 0x00} },
-	{ 4900, {0x6f, 0x00} },
-	{ 5000, {0x71, 0x00} },
-	{ 5100, {0x73, 0x00} },
-	{ 5200, {0x75, 0x00} },
-	{ 5300, {0x78, 0x00} },
-	{ 5400, {0x7a, 0x00} },
-	{ 5500, {0x7c, 0x00} },
-	{ 5600, {0x7f, 0x00} },
-	{ 5700, {0x81, 0x00} },
-	{ 5800, {0x83, 0x00} },
-	{ 5900, {0x85, 0x00} },
-	{ 6000, {0x87, 0x00} },
-	{ 6100, {0x8a, 0x00} },
-	{ 6200, {0x8c, 0x00} },
-	{ 6400, {0x48, 0x01} },
-	{ 6600, {0x4a, 0x01} },
-	{ 6800, {0x4d, 0x01} },
-	{ 7000, {0x4f, 0x01} },
-	{ 7200, {0x51, 0x01} },
-	{ 7400, {0x53, 0x01} },
-	{ 7600, {0x56, 0x01} },
-	{ 7800, {0x58, 0x01} },
-	{ 8000, {0x5a, 0x01} },
-	{ 8200, {0x5c, 0x01} },
-	{ 8400, {0x5f, 0x01} },
-	{ 8600, {0x61, 0x01} },
-	{ 8800, {0x63, 0x01} },
-	{ 9000, {0x66, 0x01} },
-	{ 9200, {0x68, 0x01} },
-	{ 9400, {0x6a, 0x01} },
-	{ 9600, {0x6c, 0x01} },
-	{ 9800, {0x6f, 0x01} },
-	{ 10000, {0x71, 0x01} },
-	{ 10200, {0x73, 0x01} },
-	{ 10400, {0x75, 0x01} },
-	{ 10600, {0x78, 0x01} },
-	{ 10800, {0x7a, 0x01} },
-	{ 11000, {0x7c, 0x01} },
-	{ 11200, {0x7f, 0x01} },
-	{ 11400, {0x81, 0x01} },
-	{ 11600, {0x83, 0x01} },
-	{ 11800, {0x85, 0x01} },
-	{ 12000, {0x87, 0x01} },
-	{ 12200, {0x8a, 0x01} },
-	{ 12400, {0x8c, 0x01} }
-};
+std::map< unsigned int, std::array<uint8_t, 2> > mouse_m908::_c_dpi_codes( std::begin( mouse_m908_profile::dpi_codes ), std::end( mouse_m908_profile::dpi_codes ) );
 
-//usb data packets
+//usb data packets (the settings reports are in profile.h)
 uint8_t mouse_m908::_c_data_s_profile[6][16] = {
 	{0x02, 0xf3, 0x2c, 0x00, 0x02, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
 	{0x02, 0xf1, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
@@ -157,174 +64,6 @@ uint8_t mouse_m908::_c_data_s_profile[6][16] = {
 	{0x02, 0xf1, 0x02, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}
 };
 
-uint8_t mouse_m908::_c_data_settings_1[15][16] = {
-	{0x02, 0xf5, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x3e, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x46, 0x04, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x49, 0x04, 0x06, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x02, 0x08, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x4f, 0x04, 0x01, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x51, 0x04, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0x02, 0x08, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x57, 0x04, 0x01, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x59, 0x04, 0x06, 0x00, 0x00, 0x00, 0x00, 0xff, 0x00, 0x02, 0x08, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x5f, 0x04, 0x01, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x61, 0x04, 0x06, 0x00, 0x00, 0x00, 0xff, 0x00, 0xff, 0x02, 0x08, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x67, 0x04, 0x01, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x69, 0x04, 0x06, 0x00, 0x00, 0x00, 0xff, 0xff, 0x00, 0x02, 0x08, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x6f, 0x04, 0x01, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x32, 0x00, 0x06, 0x00, 0x00, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x38, 0x00, 0x04, 0x00, 0x00, 0x00, 0x02, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00}
-};
-
-uint8_t mouse_m908::_c_data_settings_2[64] = {
-	0x03, 0xf3, 0x20, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x01, 0x00, 0x01, 0x00,
-	0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
-};
-
-uint8_t mouse_m908::_c_data_settings_3[140][16] = {
-	{0x02, 0xf3, 0x42, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x02, 0x01, 0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xb2, 0x01, 0x01, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x62, 0x02, 0x01, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x12, 0x03, 0x01, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf1, 0x02, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf1, 0x02, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x44, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01, 0x0b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x04, 0x01, 0x04, 0x00, 0x00, 0x00, 0x01, 0x0b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xb4, 0x01, 0x04, 0x00, 0x00, 0x00, 0x01, 0x0b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x64, 0x02, 0x04, 0x00, 0x00, 0x00, 0x01, 0x0b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x14, 0x03, 0x04, 0x00, 0x00, 0x00, 0x01, 0x0b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x4a, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01, 0x16, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x0a, 0x01, 0x04, 0x00, 0x00, 0x00, 0x01, 0x16, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xba, 0x01, 0x04, 0x00, 0x00, 0x00, 0x01, 0x16, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x6a, 0x02, 0x04, 0x00, 0x00, 0x00, 0x01, 0x16, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x1a, 0x03, 0x04, 0x00, 0x00, 0x00, 0x01, 0x16, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x50, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01, 0x2d, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x10, 0x01, 0x04, 0x00, 0x00, 0x00, 0x01, 0x2d, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xc0, 0x01, 0x04, 0x00, 0x00, 0x00, 0x01, 0x2d, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x70, 0x02, 0x04, 0x00, 0x00, 0x00, 0x01, 0x2d, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x20, 0x03, 0x04, 0x00, 0x00, 0x00, 0x01, 0x2d, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x56, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01, 0x43, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x16, 0x01, 0x04, 0x00, 0x00, 0x00, 0x01, 0x43, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xc6, 0x01, 0x04, 0x00, 0x00, 0x00, 0x01, 0x43, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x76, 0x02, 0x04, 0x00, 0x00, 0x00, 0x01, 0x43, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x26, 0x03, 0x04, 0x00, 0x00, 0x00, 0x01, 0x43, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x5c, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01, 0x8c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x1c, 0x01, 0x04, 0x00, 0x00, 0x00, 0x01, 0x8c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xcc, 0x01, 0x04, 0x00, 0x00, 0x00, 0x01, 0x8c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x7c, 0x02, 0x04, 0x00, 0x00, 0x00, 0x01, 0x8c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x2c, 0x03, 0x04, 0x00, 0x00, 0x00, 0x01, 0x8c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf1, 0x02, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x2c, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf1, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x82, 0x00, 0x04, 0x00, 0x00, 0x00, 0x81, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x86, 0x00, 0x04, 0x00, 0x00, 0x00, 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x8a, 0x00, 0x04, 0x00, 0x00, 0x00, 0x83, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x8e, 0x00, 0x04, 0x00, 0x00, 0x00, 0x99, 0x81, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x92, 0x00, 0x04, 0x00, 0x00, 0x00, 0x8a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x96, 0x00, 0x04, 0x00, 0x00, 0x00, 0x89, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x9a, 0x00, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x1e, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x9e, 0x00, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xa2, 0x00, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xa6, 0x00, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x21, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xaa, 0x00, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x22, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xae, 0x00, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x23, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xb2, 0x00, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xb6, 0x00, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x25, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xba, 0x00, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x26, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xbe, 0x00, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x27, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xc2, 0x00, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x57, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xc6, 0x00, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x56, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xda, 0x00, 0x04, 0x00, 0x00, 0x00, 0x8b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xde, 0x00, 0x04, 0x00, 0x00, 0x00, 0x8c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x42, 0x01, 0x04, 0x00, 0x00, 0x00, 0x81, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x46, 0x01, 0x04, 0x00, 0x00, 0x00, 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x4a, 0x01, 0x04, 0x00, 0x00, 0x00, 0x83, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x4e, 0x01, 0x04, 0x00, 0x00, 0x00, 0x99, 0x81, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x52, 0x01, 0x04, 0x00, 0x00, 0x00, 0x8a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x56, 0x01, 0x04, 0x00, 0x00, 0x00, 0x89, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x5a, 0x01, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x1e, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x5e, 0x01, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x62, 0x01, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x66, 0x01, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x21, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x6a, 0x01, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x22, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x6e, 0x01, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x23, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x72, 0x01, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x76, 0x01, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x25, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x7a, 0x01, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x26, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x7e, 0x01, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x27, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x82, 0x01, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x57, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x86, 0x01, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x56, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x9a, 0x01, 0x04, 0x00, 0x00, 0x00, 0x8b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x9e, 0x01, 0x04, 0x00, 0x00, 0x00, 0x8c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xf2, 0x01, 0x04, 0x00, 0x00, 0x00, 0x81, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xf6, 0x01, 0x04, 0x00, 0x00, 0x00, 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xfa, 0x01, 0x04, 0x00, 0x00, 0x00, 0x83, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xfe, 0x01, 0x04, 0x00, 0x00, 0x00, 0x99, 0x81, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x02, 0x02, 0x04, 0x00, 0x00, 0x00, 0x8a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x06, 0x02, 0x04, 0x00, 0x00, 0x00, 0x89, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x0a, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x1e, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x0e, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x12, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x16, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x21, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x1a, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x22, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x1e, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x23, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x22, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x26, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x25, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x2a, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x26, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x2e, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x27, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x32, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x57, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x36, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x56, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x4a, 0x02, 0x04, 0x00, 0x00, 0x00, 0x8b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x4e, 0x02, 0x04, 0x00, 0x00, 0x00, 0x8c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xa2, 0x02, 0x04, 0x00, 0x00, 0x00, 0x81, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xa6, 0x02, 0x04, 0x00, 0x00, 0x00, 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xaa, 0x02, 0x04, 0x00, 0x00, 0x00, 0x83, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xae, 0x02, 0x04, 0x00, 0x00, 0x00, 0x99, 0x81, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xb2, 0x02, 0x04, 0x00, 0x00, 0x00, 0x8a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xb6, 0x02, 0x04, 0x00, 0x00, 0x00, 0x89, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xba, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x1e, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xbe, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xc2, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xc6, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x21, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xca, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x22, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xce, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x23, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xd2, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xd6, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x25, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xda, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x26, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xde, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x27, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xe2, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x57, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xe6, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x56, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xfa, 0x02, 0x04, 0x00, 0x00, 0x00, 0x8b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xfe, 0x02, 0x04, 0x00, 0x00, 0x00, 0x8c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x52, 0x03, 0x04, 0x00, 0x00, 0x00, 0x81, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x56, 0x03, 0x04, 0x00, 0x00, 0x00, 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x5a, 0x03, 0x04, 0x00, 0x00, 0x00, 0x83, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x5e, 0x03, 0x04, 0x00, 0x00, 0x00, 0x99, 0x81, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x62, 0x03, 0x04, 0x00, 0x00, 0x00, 0x8a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x66, 0x03, 0x04, 0x00, 0x00, 0x00, 0x89, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x6a, 0x03, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x1e, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x6e, 0x03, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x72, 0x03, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x76, 0x03, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x21, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x7a, 0x03, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x22, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x7e, 0x03, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x23, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x82, 0x03, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x86, 0x03, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x25, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x8a, 0x03, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x26, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x8e, 0x03, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x27, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x92, 0x03, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x57, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0x96, 0x03, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x56, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xaa, 0x03, 0x04, 0x00, 0x00, 0x00, 0x8b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf3, 0xae, 0x03, 0x04, 0x00, 0x00, 0x00, 0x8c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf1, 0x02, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf1, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf1, 0x02, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf1, 0x02, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-	{0x02, 0xf5, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}
-};
-
 uint8_t mouse_m908::_c_data_macros_1[16] = 
 	{0x02, 0xf5, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 
@@ -158,6 +158,26 @@ int mouse_m908::print_settings( std::ostream& output ){
 	return 0;
 }
 
+int mouse_m908::print_memory( const memory_image& memory, std::ostream& output ){
+	
+	output << "# Model: " << get_name() << "\n";
+	output << "# Backup created with mouse_m908 --backup, it can be restored with mouse_m908 --restore.\n";
+	output << "# address length: bytes\n";
+	print_memory_rows( memory, output );
+	
+	return 0;
+}
+
+int mouse_m908::parse_memory( std::istream& input, memory_image& memory ){
+	
+	// the model must match
+	std::string model;
+	if( parse_memory_rows( input, memory, model ) != 0 || model != get_name() )
+		return 1;
+	
+	return 0;
+}
+
 int mouse_m908::_i_decode_dpi( std::array<uint8_t, 2>& dpi_bytes, std::string& dpi_string ){
 	
 	// is dpi value known?
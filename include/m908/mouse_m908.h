@@ -33,6 +33,8 @@
 #include <iostream>
 #include <iomanip>
 
+#include "profile.h"
+
 /**
  * The main class representing the M908 mouse.
  * This class has member functions to open, close and apply settings to the mouse.
@@ -144,6 +146,13 @@ class mouse_m908 : public rd_mouse{
 		 */
 		int set_all_macros( std::string file );
 		
+		/** \brief Load a pre-encoded macro slot image (e.g. from a macro bank)
+		 * The image must contain the slot code of macro_number (see _c_data_macros_codes).
+		 * \param macro_number macro slot (1-15)
+		 * \return 0 if successful, 1 if the image doesn't belong to this slot
+		 */
+		int set_macro_raw( int macro_number, const std::array<uint8_t, 256>& macro );
+		
 		/// Does nothing, exists only for compatibility
 		void set_vid( uint16_t vid ){ (void)vid; }
 		/// Does nothing, exists only for compatibility
@@ -184,6 +193,11 @@ class mouse_m908 : public rd_mouse{
 			return vid == _c_mouse_vid && pid == _c_mouse_pid;
 		}
 		
+		/// Get the USB ids of the model (vendor id, product id)
+		static std::vector< std::pair<uint16_t, uint16_t> > get_ids(){
+			return { { _c_mouse_vid, _c_mouse_pid } };
+		}
+		
 		/// Get mouse name
 		static std::string get_name(){
 			return _c_name;
@@ -200,11 +214,32 @@ class mouse_m908 : public rd_mouse{
 		 */
 		int write_settings();
 		
+		/** \brief Write settings reports built with mouse_m908_profile (e.g. at compile time) to the mouse
+		 * \return 0 if successful
+		 */
+		int write_settings( const mouse_m908_profile::reports& reports );
+		
 		/** \brief Write a macro to the mouse
 		 * \return 0 if successful
 		 */
 		int write_macro( int macro_number );
 		
+		/** \brief Write only the color of a profile, used for host-driven lighting effects
+		 * Sends 3 reports instead of the full settings, the lightmode and speed of the profile are kept.
+		 * \return 0 if successful, the number of failed transfers otherwise
+		 */
+		int write_color( rd_profile profile, std::array<uint8_t, 3> color );
+		
+		/** \brief Restore a backup: write the settings and macro rows whose bytes differ between target and current
+		 * The rows are those of write_settings and write_macro with the bytes taken from target. Bytes
+		 * missing from target are taken from current, rows with bytes missing from both (scrollspeed) are not sent.
+		 * \arg target memory to restore, see read_memory and parse_memory
+		 * \arg current memory of the mouse, empty to send all rows
+		 * \arg rows set to the number of settings and macro rows sent
+		 * \return 0 if successful
+		 */
+		int write_memory( const memory_image& target, const memory_image& current, size_t& rows );
+		
 		
 		
 		//helper functions
@@ -226,6 +261,14 @@ class mouse_m908 : public rd_mouse{
 		/// Print the current configuration in .ini format to output
 		int print_settings( std::ostream& output );
 		
+		/// Print a memory image as backup file (hex rows: address length: bytes)
+		static int print_memory( const memory_image& memory, std::ostream& output );
+		
+		/** \brief Read a backup file written by print_memory
+		 * \return 0 if successful, 1 if the backup is invalid or for another model
+		 */
+		static int parse_memory( std::istream& input, memory_image& memory );
+		
 		
 		
 		//reader functions (get settings from the mouse)
@@ -242,6 +285,13 @@ class mouse_m908 : public rd_mouse{
 		 */
 		int read_settings();
 		
+		/**
+		 * \brief Read the settings and macros as memory image without decoding them, used for backups
+		 * Contains every byte the mouse returns, including values the decoders don't understand.
+		 * \arg addresses only read the rows that contain one of these addresses (e.g. the rows about to be written), all rows if nullptr
+		 */
+		int read_memory( memory_image& memory, const memory_image* addresses = nullptr );
+		
 		
 		
 		/// Returns a reference to _c_button_names (physical button names)
@@ -280,12 +330,6 @@ class mouse_m908 : public rd_mouse{
 		//usb data packets
 		/// Used for changing the active profile
 		static uint8_t _c_data_s_profile[6][16];
-		/// Used for sending the settings, part 1/3
-		static uint8_t _c_data_settings_1[15][16];
-		/// Used for sending the settings, part 2/3
-		static uint8_t _c_data_settings_2[64];
-		/// Used for sending the settings, part 3/3
-		static uint8_t _c_data_settings_3[140][16];
 		/// Used for sending a macro, part 1/3
 		static uint8_t _c_data_macros_1[16];
 		/// Used for sending a macro, part 2/3
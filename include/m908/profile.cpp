@@ -0,0 +1,56 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+/*
+ * This file contains the compile-time checks of the settings builder (profile.h)
+ */
+
+#include "../rd_mouse.h"
+
+// the expected values are the output of the runtime encoders (rd_button_encoder::encode,
+// mouse_m908::write_settings), benchmarks/button_mapping_benchmark compares the button
+// mappings with rd_button_encoder for every mapping of keymap.md
+static_assert( mouse_m908_profile::equal( mouse_m908_profile::encode_button_mapping( "left" ), std::array<uint8_t, 4>{ 0x81, 0x00, 0x00, 0x00 } ) );
+static_assert( mouse_m908_profile::equal( mouse_m908_profile::encode_button_mapping( "ctrl_l+c" ), std::array<uint8_t, 4>{ 0x8f, 0x01, 0x06, 0x00 } ) );
+static_assert( mouse_m908_profile::equal( mouse_m908_profile::encode_button_mapping( "shift_l+alt_r+F5" ), std::array<uint8_t, 4>{ 0x8f, 0x42, 0x3e, 0x00 } ) );
+static_assert( mouse_m908_profile::equal( mouse_m908_profile::encode_button_mapping( "super_r+Media_Calc" ), std::array<uint8_t, 4>{ 0x8f, 0x80, 0xfb, 0x00 } ) );
+static_assert( mouse_m908_profile::equal( mouse_m908_profile::encode_button_mapping( "Esc" ), std::array<uint8_t, 4>{ 0x90, 0x00, 0x29, 0x00 } ) );
+static_assert( mouse_m908_profile::equal( mouse_m908_profile::encode_button_mapping( "fire:mouse_left:5:1" ), std::array<uint8_t, 4>{ 0x99, 0x81, 0x05, 0x01 } ) );
+static_assert( mouse_m908_profile::equal( mouse_m908_profile::encode_button_mapping( "snipe:800" ), std::array<uint8_t, 4>{ 0x9a, 0x01, 0x12, 0x12 } ) );
+static_assert( mouse_m908_profile::equal( mouse_m908_profile::encode_button_mapping( "macro3" ), std::array<uint8_t, 4>{ 0x91, 0x02, 0x01, 0x00 } ) );
+static_assert( mouse_m908_profile::equal( mouse_m908_profile::encode_button_mapping( "macro12:7" ), std::array<uint8_t, 4>{ 0x91, 0x0b, 0x07, 0x00 } ) );
+static_assert( mouse_m908_profile::equal( mouse_m908_profile::encode_button_mapping( "macro2:while" ), std::array<uint8_t, 4>{ 0x91, 0x81, 0xff, 0xff } ) );
+static_assert( mouse_m908_profile::equal( mouse_m908_profile::encode_button_mapping( "macro15:until" ), std::array<uint8_t, 4>{ 0x91, 0x4e, 0xff, 0xff } ) );
+static_assert( mouse_m908_profile::equal( mouse_m908_profile::encode_button_mapping( "media_play" ), std::array<uint8_t, 4>{ 0x8e, 0x01, 0xcd, 0x00 } ) );
+static_assert( mouse_m908_profile::equal( mouse_m908_profile::encode_button_mapping( "0x11aa22bb" ), std::array<uint8_t, 4>{ 0x11, 0xaa, 0x22, 0xbb } ) );
+
+// the rows of a changed profile
+static_assert( [](){
+	mouse_m908_profile profile;
+	profile.set_color( rd_mouse::profile_2, {0x12, 0x34, 0x56} )
+		.set_lightmode( rd_mouse::profile_2, rd_mouse::lightmode_wave )
+		.set_dpi( rd_mouse::profile_3, 1, 1600u )
+		.set_key_mapping( rd_mouse::profile_1, 3, "ctrl_l+c" )
+		.set_report_rate( rd_mouse::profile_5, rd_mouse::r_1000Hz );
+	auto reports = profile.get_reports();
+	return mouse_m908_profile::equal( reports.data_1[5], std::array<uint8_t, 16>{ 0x02, 0xf3, 0x51, 0x04, 0x06, 0x00, 0x00, 0x00, 0x12, 0x34, 0x56, 0x02, 0x08, 0x00, 0x00, 0x00 } ) &&
+		mouse_m908_profile::equal( reports.data_3[14], std::array<uint8_t, 16>{ 0x02, 0xf3, 0xba, 0x01, 0x04, 0x00, 0x00, 0x00, 0x01, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } ) &&
+		mouse_m908_profile::equal( reports.data_3[38], std::array<uint8_t, 16>{ 0x02, 0xf3, 0x8e, 0x00, 0x04, 0x00, 0x00, 0x00, 0x8f, 0x01, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00 } ) &&
+		reports.data_1[14][10] == 0x01 &&
+		mouse_m908_profile::equal( mouse_m908_profile::encode_color( 1, rd_mouse::lightmode_wave, {0x12, 0x34, 0x56}, 0x08 ), reports.data_1[5] );
+}() );
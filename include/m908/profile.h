@@ -0,0 +1,709 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+
+// rd_mouse.h includes this file from mouse_m908.h, the enums of rd_mouse are needed here
+#include "../rd_mouse.h"
+
+#ifndef MOUSE_M908_PROFILE
+#define MOUSE_M908_PROFILE
+
+#include "../keycodes.h"
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+/**
+ * Compile-time builder for the settings of the M908 (header-only).
+ * 
+ * All member functions are constexpr, a profile built in a constant
+ * expression yields the settings reports as constants, no encoding
+ * happens at runtime. Invalid values throw std::invalid_argument, which
+ * is a compile error in a constant expression. Example:
+ * 
+ *     constexpr mouse_m908_profile::reports packets = [](){
+ *         mouse_m908_profile profile;
+ *         profile.set_color( rd_mouse::profile_1, {0x00, 0x80, 0xff} );
+ *         profile.set_dpi( rd_mouse::profile_1, 0, 1600 );
+ *         profile.set_key_mapping( rd_mouse::profile_1, 3, "ctrl_l+c" );
+ *         profile.set_report_rate( rd_mouse::profile_1, rd_mouse::r_1000Hz );
+ *         return profile.get_reports();
+ *     }();
+ *     
+ *     mouse.write_settings( packets );
+ * 
+ * The initial values are those of a new mouse_m908 object.
+ * mouse_m908::write_settings() uses encode() of this class as well, so
+ * both produce the same reports.
+ */
+class mouse_m908_profile{
+	
+	public:
+		
+		/// The settings reports in the order they are sent
+		struct reports{
+			/// part 1/3: lightmode, color, brightness, speed, report rate (16 byte rows)
+			std::array< std::array<uint8_t, 16>, 15 > data_1;
+			/// part 2/3: scrollspeed (one 64 byte report)
+			std::array< uint8_t, 64 > data_2;
+			/// part 3/3: dpi and button mapping (16 byte rows)
+			std::array< std::array<uint8_t, 16>, 140 > data_3;
+		};
+		
+		/// Mapping of real DPI values to bytecode
+		static constexpr std::pair< unsigned int, std::array<uint8_t, 2> > dpi_codes[] = {
+			{ 200, {0x4, 0x00} },
+			{ 300, {0x6, 0x00} },
+			{ 400, {0x9, 0x00} },
+			{ 500, {0xb, 0x00} },
+			{ 600, {0xd, 0x00} },
+			{ 700, {0xf, 0x00} },
+			{ 800, {0x12, 0x00} },
+			{ 900, {0x14, 0x00} },
+			{ 1000, {0x16, 0x00} },
+			{ 1100, {0x18, 0x00} },
+			{ 1200, {0x1b, 0x00} },
+			{ 1300, {0x1d, 0x00} },
+			{ 1400, {0x1f, 0x00} },
+			{ 1500, {0x21, 0x00} },
+			{ 1600, {0x24, 0x00} },
+			{ 1700, {0x26, 0x00} },
+			{ 1800, {0x28, 0x00} },
+			{ 1900, {0x2b, 0x00} },
+			{ 2000, {0x2d, 0x00} },
+			{ 2100, {0x2f, 0x00} },
+			{ 2200, {0x31, 0x00} },
+			{ 2300, {0x34, 0x00} },
+			{ 2400, {0x36, 0x00} },
+			{ 2500, {0x38, 0x00} },
+			{ 2600, {0x3a, 0x00} },
+			{ 2700, {0x3d, 0x00} },
+			{ 2800, {0x3f, 0x00} },
+			{ 2900, {0x41, 0x00} },
+			{ 3000, {0x43, 0x00} },
+			{ 3100, {0x46, 0x00} },
+			{ 3200, {0x48, 0x00} },
+			{ 3300, {0x4a, 0x00} },
+			{ 3400, {0x4d, 0x00} },
+			{ 3500, {0x4f, 0x00} },
+			{ 3600, {0x51, 0x00} },
+			{ 3700, {0x53, 0x00} },
+			{ 3800, {0x56, 0x00} },
+			{ 3900, {0x58, 0x00} },
+			{ 4000, {0x5a, 0x00} },
+			{ 4100, {0x5c, 0x00} },
+			{ 4200, {0x5f, 0x00} },
+			{ 4300, {0x61, 0x00} },
+			{ 4400, {0x63, 0x00} },
+			{ 4500, {0x66, 0x00} },
+			{ 4600, {0x68, 0x00} },
+			{ 4700, {0x6a, 0x00} },
+			{ 4800, {0x6c, 0x00} },
+			{ 4900, {0x6f, 0x00} },
+			{ 5000, {0x71, 0x00} },
+			{ 5100, {0x73, 0x00} },
+			{ 5200, {0x75, 0x00} },
+			{ 5300, {0x78, 0x00} },
+			{ 5400, {0x7a, 0x00} },
+			{ 5500, {0x7c, 0x00} },
+			{ 5600, {0x7f, 0x00} },
+			{ 5700, {0x81, 0x00} },
+			{ 5800, {0x83, 0x00} },
+			{ 5900, {0x85, 0x00} },
+			{ 6000, {0x87, 0x00} },
+			{ 6100, {0x8a, 0x00} },
+			{ 6200, {0x8c, 0x00} },
+			{ 6400, {0x48, 0x01} },
+			{ 6600, {0x4a, 0x01} },
+			{ 6800, {0x4d, 0x01} },
+			{ 7000, {0x4f, 0x01} },
+			{ 7200, {0x51, 0x01} },
+			{ 7400, {0x53, 0x01} },
+			{ 7600, {0x56, 0x01} },
+			{ 7800, {0x58, 0x01} },
+			{ 8000, {0x5a, 0x01} },
+			{ 8200, {0x5c, 0x01} },
+			{ 8400, {0x5f, 0x01} },
+			{ 8600, {0x61, 0x01} },
+			{ 8800, {0x63, 0x01} },
+			{ 9000, {0x66, 0x01} },
+			{ 9200, {0x68, 0x01} },
+			{ 9400, {0x6a, 0x01} },
+			{ 9600, {0x6c, 0x01} },
+			{ 9800, {0x6f, 0x01} },
+			{ 10000, {0x71, 0x01} },
+			{ 10200, {0x73, 0x01} },
+			{ 10400, {0x75, 0x01} },
+			{ 10600, {0x78, 0x01} },
+			{ 10800, {0x7a, 0x01} },
+			{ 11000, {0x7c, 0x01} },
+			{ 11200, {0x7f, 0x01} },
+			{ 11400, {0x81, 0x01} },
+			{ 11600, {0x83, 0x01} },
+			{ 11800, {0x85, 0x01} },
+			{ 12000, {0x87, 0x01} },
+			{ 12200, {0x8a, 0x01} },
+			{ 12400, {0x8c, 0x01} }
+		};
+		
+		/// Default settings (same as mouse_m908())
+		constexpr mouse_m908_profile() :
+			_s_scrollspeeds{ 0x01, 0x01, 0x01, 0x01, 0x01 },
+			_s_lightmodes{ rd_mouse::lightmode_static, rd_mouse::lightmode_static, rd_mouse::lightmode_static, rd_mouse::lightmode_static, rd_mouse::lightmode_static },
+			_s_colors{{ {0xff, 0xff, 0xff}, {0xff, 0xff, 0xff}, {0xff, 0xff, 0xff}, {0xff, 0xff, 0xff}, {0xff, 0xff, 0xff} }},
+			_s_brightness_levels{ 0x03, 0x03, 0x03, 0x03, 0x03 },
+			_s_speed_levels{ 0x08, 0x08, 0x08, 0x08, 0x08 },
+			_s_dpi_enabled{},
+			_s_dpi_levels{},
+			_s_keymap_data{},
+			_s_report_rates{ rd_mouse::r_125Hz, rd_mouse::r_125Hz, rd_mouse::r_125Hz, rd_mouse::r_125Hz, rd_mouse::r_125Hz }{
+			
+			for( int i = 0; i < 5; i++ ){
+				_s_dpi_enabled[i] = { true, true, true, true, true };
+				_s_dpi_levels[i] = {{ {0x04, 0x00}, {0x16, 0x00}, {0x2d, 0x00}, {0x43, 0x00}, {0x8c, 0x00} }};
+				for( int j = 0; j < 20; j++ )
+					_s_keymap_data[i][j] = default_key_mapping( i, j );
+			}
+		}
+		
+		//setter functions, same checks as in mouse_m908
+		/// Set scrollspeed (0x01-0x3f)
+		constexpr mouse_m908_profile& set_scrollspeed( rd_mouse::rd_profile profile, uint8_t speed ){
+			_i_check( speed >= 0x01 && speed <= 0x3f, "scrollspeed out of range" );
+			_s_scrollspeeds[profile] = speed;
+			return *this;
+		}
+		/// Set lightmode
+		constexpr mouse_m908_profile& set_lightmode( rd_mouse::rd_profile profile, rd_mouse::rd_lightmode lightmode ){
+			_s_lightmodes[profile] = lightmode;
+			return *this;
+		}
+		/// Set led color
+		constexpr mouse_m908_profile& set_color( rd_mouse::rd_profile profile, std::array<uint8_t, 3> color ){
+			_s_colors[profile] = color;
+			return *this;
+		}
+		/// Set led brightness (0x01-0x03)
+		constexpr mouse_m908_profile& set_brightness( rd_mouse::rd_profile profile, uint8_t brightness ){
+			_i_check( brightness >= 0x01 && brightness <= 0x03, "brightness out of range" );
+			_s_brightness_levels[profile] = brightness;
+			return *this;
+		}
+		/// Set led animation speed (0x01-0x08)
+		constexpr mouse_m908_profile& set_speed( rd_mouse::rd_profile profile, uint8_t speed ){
+			_i_check( speed >= 0x01 && speed <= 0x08, "speed out of range" );
+			_s_speed_levels[profile] = speed;
+			return *this;
+		}
+		/// Enables/Disables a dpi level (0-4), at least one level must stay enabled
+		constexpr mouse_m908_profile& set_dpi_enable( rd_mouse::rd_profile profile, int level, bool enabled ){
+			_i_check( level >= 0 && level <= 4, "dpi level out of range" );
+			_s_dpi_enabled[profile][level] = enabled;
+			bool any = false;
+			for( bool e : _s_dpi_enabled[profile] )
+				any = any || e;
+			_i_check( any, "all dpi levels disabled" );
+			return *this;
+		}
+		/// Set value of a dpi level (0-4) as raw bytes
+		constexpr mouse_m908_profile& set_dpi( rd_mouse::rd_profile profile, int level, std::array<uint8_t, 2> dpi ){
+			_i_check( level >= 0 && level <= 4, "dpi level out of range" );
+			_i_check( dpi[0] >= 0x04 && dpi[0] <= 0x8c && dpi[1] <= 0x01, "dpi out of range" );
+			_s_dpi_levels[profile][level] = dpi;
+			return *this;
+		}
+		/// Set value of a dpi level (0-4) as real DPI, see dpi_codes
+		constexpr mouse_m908_profile& set_dpi( rd_mouse::rd_profile profile, int level, unsigned int dpi ){
+			for( auto& code : dpi_codes ){
+				if( code.first == dpi )
+					return set_dpi( profile, level, code.second );
+			}
+			throw std::invalid_argument( "unknown dpi value" );
+		}
+		/// Set a button mapping as bytecode, key is the button number (see mouse_m908::_c_button_names)
+		constexpr mouse_m908_profile& set_key_mapping( rd_mouse::rd_profile profile, int key, std::array<uint8_t, 4> mapping ){
+			_i_check( key >= 0 && key < 20, "button number out of range" );
+			_s_keymap_data[profile][key] = mapping;
+			return *this;
+		}
+		/// Set a button mapping by name, see keymap.md
+		constexpr mouse_m908_profile& set_key_mapping( rd_mouse::rd_profile profile, int key, std::string_view mapping ){
+			return set_key_mapping( profile, key, encode_button_mapping( mapping ) );
+		}
+		/// Set USB report rate
+		constexpr mouse_m908_profile& set_report_rate( rd_mouse::rd_profile profile, rd_mouse::rd_report_rate report_rate ){
+			_s_report_rates[profile] = report_rate;
+			return *this;
+		}
+		
+		/// Returns the settings reports
+		constexpr reports get_reports() const{
+			return encode( _s_scrollspeeds, _s_lightmodes, _s_colors, _s_brightness_levels, _s_speed_levels,
+				_s_dpi_enabled, _s_dpi_levels, _s_keymap_data, _s_report_rates );
+		}
+		
+		/** \brief Turns the settings into reports (no checks), used by mouse_m908::write_settings()
+		 * \return the reports for all 5 profiles
+		 */
+		static constexpr reports encode(
+			const std::array<uint8_t, 5>& scrollspeeds,
+			const std::array<rd_mouse::rd_lightmode, 5>& lightmodes,
+			const std::array<std::array<uint8_t, 3>, 5>& colors,
+			const std::array<uint8_t, 5>& brightness_levels,
+			const std::array<uint8_t, 5>& speed_levels,
+			const std::array<std::array<bool, 5>, 5>& dpi_enabled,
+			const std::array<std::array<std::array<uint8_t, 2>, 5>, 5>& dpi_levels,
+			const std::array<std::array<std::array<uint8_t, 4>, 20>, 5>& keymap_data,
+			const std::array<rd_mouse::rd_report_rate, 5>& report_rates ){
+			
+			reports result = { _c_data_settings_1, _c_data_settings_2, _c_data_settings_3 };
+			
+			for( int i = 0; i < 5; i++ ){
+				
+				//scrollspeed
+				result.data_2[8+(2*i)] = scrollspeeds[i];
+				//lightmode
+				std::array<uint8_t, 2> lightmode_bytes = encode_lightmode( lightmodes[i] );
+				result.data_1[3+(2*i)][11] = lightmode_bytes[0];
+				result.data_1[3+(2*i)][13] = lightmode_bytes[1];
+				//color
+				result.data_1[3+(2*i)][8] = colors[i][0];
+				result.data_1[3+(2*i)][9] = colors[i][1];
+				result.data_1[3+(2*i)][10] = colors[i][2];
+				//brightness
+				result.data_1[4+(2*i)][8] = brightness_levels[i];
+				//speed
+				result.data_1[3+(2*i)][12] = speed_levels[i];
+				//dpi (i is the level, j the profile)
+				for( int j = 0; j < 5; j++ ){
+					result.data_3[7+(5*i)+j][8] = dpi_enabled[j][i];
+					result.data_3[7+(5*i)+j][9] = dpi_levels[j][i][0];
+					result.data_3[7+(5*i)+j][10] = dpi_levels[j][i][1];
+				}
+				//key mapping
+				for( int j = 0; j < 20; j++ ){
+					for( int k = 0; k < 4; k++ )
+						result.data_3[35+(20*i)+j][8+k] = keymap_data[i][j][k];
+				}
+			}
+			
+			//usb report rate
+			for( int i = 0; i < 3; i++ )
+				result.data_1[13][8+(2*i)] = encode_report_rate( report_rates[i] );
+			for( int i = 3; i < 5; i++ )
+				result.data_1[14][2+(2*i)] = encode_report_rate( report_rates[i] );
+			
+			return result;
+		}
+		
+		/** \brief Lightmode and color report of one profile (row 3+2*profile of part 1/3), used by mouse_m908::write_color()
+		 * The row must be sent between session_open and session_close.
+		 */
+		static constexpr std::array<uint8_t, 16> encode_color( int profile, rd_mouse::rd_lightmode lightmode,
+			const std::array<uint8_t, 3>& color, uint8_t speed_level ){
+			
+			std::array<uint8_t, 16> row = _c_data_settings_1[3+(2*profile)];
+			std::array<uint8_t, 2> lightmode_bytes = encode_lightmode( lightmode );
+			row[8] = color[0];
+			row[9] = color[1];
+			row[10] = color[2];
+			row[11] = lightmode_bytes[0];
+			row[12] = speed_level;
+			row[13] = lightmode_bytes[1];
+			
+			return row;
+		}
+		
+		/// Opens a session (first row of part 1/3)
+		static constexpr std::array<uint8_t, 16> session_open(){ return _c_data_settings_1[0]; }
+		/// Closes a session (last row of part 3/3)
+		static constexpr std::array<uint8_t, 16> session_close(){ return _c_data_settings_3[139]; }
+		
+		/// Compares two arrays (std::array::operator== is not constexpr in C++17)
+		template< size_t N > static constexpr bool equal( const std::array<uint8_t, N>& a, const std::array<uint8_t, N>& b ){
+			for( size_t i = 0; i < N; i++ ){
+				if( a[i] != b[i] )
+					return false;
+			}
+			return true;
+		}
+		
+		/// Button mapping of the factory settings
+		static constexpr std::array<uint8_t, 4> default_key_mapping( int profile, int key ){
+			auto& row = _c_data_settings_3[35+(20*profile)+key];
+			return { row[8], row[9], row[10], row[11] };
+		}
+		
+		/// Lightmode bytecode, same values as rd_mouse::_c_lightmode_values
+		static constexpr std::array<uint8_t, 2> encode_lightmode( rd_mouse::rd_lightmode lightmode ){
+			switch( lightmode ){
+				case rd_mouse::lightmode_off: return { 0x00, 0x00 };
+				case rd_mouse::lightmode_breathing_rainbow: return { 0x01, 0x01 };
+				case rd_mouse::lightmode_static: return { 0x01, 0x02 };
+				case rd_mouse::lightmode_breathing: return { 0x01, 0x04 };
+				case rd_mouse::lightmode_rainbow: return { 0x01, 0x08 };
+				case rd_mouse::lightmode_flashing: return { 0x01, 0x10 };
+				case rd_mouse::lightmode_wave: return { 0x02, 0x00 };
+				case rd_mouse::lightmode_reactive_button: return { 0x03, 0x00 };
+				case rd_mouse::lightmode_random: return { 0x04, 0x00 };
+				case rd_mouse::lightmode_alternating: return { 0x06, 0x00 };
+				case rd_mouse::lightmode_reactive: return { 0x07, 0x00 };
+			}
+			return { 0x01, 0x02 };
+		}
+		
+		/// Report rate bytecode, same values as rd_mouse::_c_report_rate_values
+		static constexpr uint8_t encode_report_rate( rd_mouse::rd_report_rate report_rate ){
+			switch( report_rate ){
+				case rd_mouse::r_125Hz: return 0x08;
+				case rd_mouse::r_250Hz: return 0x04;
+				case rd_mouse::r_500Hz: return 0x02;
+				case rd_mouse::r_1000Hz: return 0x01;
+			}
+			return 0x08;
+		}
+		
+		/** \brief Turns a button mapping into bytecode, same syntax and
+		 * results as rd_button_encoder::encode for the mappings of keymap.md
+		 * Malformed mappings that rd_button_encoder accepts (e.g. unknown keys
+		 * as 0x00) are rejected. benchmarks/button_mapping_benchmark compares
+		 * both encoders for every mapping of keymap.md.
+		 * \throw std::invalid_argument if the mapping is invalid
+		 */
+		static constexpr std::array<uint8_t, 4> encode_button_mapping( std::string_view mapping ){
+			
+			// raw byte values: 0x followed by 8 hex digits
+			if( mapping.size() == 10 && mapping.substr( 0, 2 ) == "0x" ){
+				std::array<uint8_t, 4> bytes = {};
+				bool valid = true;
+				for( size_t i = 2; i < 10; i++ ){
+					int nibble = _i_hex_digit( mapping[i] );
+					valid = valid && nibble >= 0;
+					bytes[(i-2)/2] = ( bytes[(i-2)/2] << 4 ) | ( nibble & 0x0f );
+				}
+				if( valid )
+					return bytes;
+			}
+			
+			// mousebuttons/special functions and media controls
+			for( auto& keycode : rd_keycode_table ){
+				if( mapping == keycode.first )
+					return keycode.second;
+			}
+			
+			// fire button: fire:button:repeats:delay
+			if( mapping.substr( 0, 4 ) == "fire" ){
+				
+				std::string_view fields[4] = {};
+				size_t count = 0, start = 0;
+				while( count < 4 && start < mapping.size() ){
+					size_t end = mapping.find( ':', start );
+					if( end == std::string_view::npos )
+						end = mapping.size();
+					fields[count++] = mapping.substr( start, end - start );
+					start = end + 1;
+				}
+				
+				uint8_t keycode = 0;
+				if( fields[1] == "mouse_left" )
+					keycode = 0x81;
+				else if( fields[1] == "mouse_right" )
+					keycode = 0x82;
+				else if( fields[1] == "mouse_middle" )
+					keycode = 0x84;
+				else
+					keycode = _i_key_value( fields[1] );
+				
+				return { 0x99, keycode, (uint8_t)_i_number( fields[2] ), (uint8_t)_i_number( fields[3] ) };
+			}
+			
+			// snipe button: snipe:dpi
+			if( mapping.substr( 0, 6 ) == "snipe:" ){
+				int dpi = _i_number( mapping.substr( 6 ) );
+				for( auto& value : rd_snipe_dpi_table ){
+					if( value.first == dpi )
+						return { 0x9a, 0x01, value.second, value.second };
+				}
+				throw std::invalid_argument( "invalid snipe dpi" );
+			}
+			
+			// macro: macroN, macroN:repeats, macroN:until or macroN:while with N = 1-15
+			if( mapping.substr( 0, 5 ) == "macro" && mapping.size() > 5 && mapping[5] >= '1' && mapping[5] <= '9' ){
+				
+				int number = mapping[5] - '0';
+				size_t length = 6;
+				if( number == 1 && mapping.size() > 6 && mapping[6] >= '0' && mapping[6] <= '5' ){
+					number = 10 + mapping[6] - '0';
+					length = 7;
+				}
+				
+				std::string_view suffix = mapping.substr( length );
+				if( suffix.empty() )
+					return { 0x91, (uint8_t)(number - 1), 0x01, 0x00 };
+				if( suffix == ":until" )
+					return { 0x91, (uint8_t)(number + 0x3f), 0xff, 0xff };
+				if( suffix == ":while" )
+					return { 0x91, (uint8_t)(number + 0x7f), 0xff, 0xff };
+				if( suffix.size() > 1 && suffix[0] == ':' && suffix.find_first_not_of( "0123456789", 1 ) == std::string_view::npos )
+					return { 0x91, (uint8_t)(number - 1), (uint8_t)_i_number( suffix.substr( 1 ) ), 0x00 };
+			}
+			
+			// keyboard key with modifiers: modifier+modifier+key
+			uint8_t modifier_value = 0x00;
+			size_t key_start = 0;
+			for( size_t plus = mapping.find( '+' ); plus != std::string_view::npos; plus = mapping.find( '+', key_start ) ){
+				
+				std::string_view modifier = mapping.substr( key_start, plus + 1 - key_start );
+				bool found = false;
+				for( auto& value : rd_keyboard_modifier_table ){
+					if( modifier == value.first ){
+						modifier_value |= value.second;
+						found = true;
+					}
+				}
+				_i_check( found, "unknown modifier" );
+				key_start = plus + 1;
+			}
+			
+			return { (uint8_t)(key_start > 0 ? 0x8f : 0x90), modifier_value, _i_key_value( mapping.substr( key_start ) ), 0x00 };
+		}
+		
+	private:
+		
+		/// throws std::invalid_argument if condition is false (a compile error in a constant expression)
+		static constexpr void _i_check( bool condition, const char* message ){
+			if( !condition )
+				throw std::invalid_argument( message );
+		}
+		
+		/// value of a hex digit or -1
+		static constexpr int _i_hex_digit( char c ){
+			if( c >= '0' && c <= '9' )
+				return c - '0';
+			if( c >= 'a' && c <= 'f' )
+				return c - 'a' + 10;
+			if( c >= 'A' && c <= 'F' )
+				return c - 'A' + 10;
+			return -1;
+		}
+		
+		/// decimal number (0-65535)
+		static constexpr int _i_number( std::string_view text ){
+			int value = 0;
+			_i_check( !text.empty() && text.size() <= 5, "invalid number" );
+			for( char c : text ){
+				_i_check( c >= '0' && c <= '9', "invalid number" );
+				value = value * 10 + ( c - '0' );
+			}
+			return value;
+		}
+		
+		/// keyboard key value, see rd_keyboard_key_table
+		static constexpr uint8_t _i_key_value( std::string_view name ){
+			for( auto& key : rd_keyboard_key_table ){
+				if( name == key.first )
+					return key.second;
+			}
+			throw std::invalid_argument( "unknown key" );
+		}
+		
+		//setting vars, same layout as in mouse_m908
+		std::array<uint8_t, 5> _s_scrollspeeds;
+		std::array<rd_mouse::rd_lightmode, 5> _s_lightmodes;
+		std::array<std::array<uint8_t, 3>, 5> _s_colors;
+		std::array<uint8_t, 5> _s_brightness_levels;
+		std::array<uint8_t, 5> _s_speed_levels;
+		std::array<std::array<bool, 5>, 5> _s_dpi_enabled;
+		std::array<std::array<std::array<uint8_t, 2>, 5>, 5> _s_dpi_levels;
+		std::array<std::array<std::array<uint8_t, 4>, 20>, 5> _s_keymap_data;
+		std::array<rd_mouse::rd_report_rate, 5> _s_report_rates;
+		
+		//usb data packets
+		/// Used for sending the settings, part 1/3
+		static constexpr std::array< std::array<uint8_t, 16>, 15 > _c_data_settings_1 = {{
+			{ 0x02, 0xf5, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x3e, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x46, 0x04, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x49, 0x04, 0x06, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x02, 0x08, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x4f, 0x04, 0x01, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x51, 0x04, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0x02, 0x08, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x57, 0x04, 0x01, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x59, 0x04, 0x06, 0x00, 0x00, 0x00, 0x00, 0xff, 0x00, 0x02, 0x08, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x5f, 0x04, 0x01, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x61, 0x04, 0x06, 0x00, 0x00, 0x00, 0xff, 0x00, 0xff, 0x02, 0x08, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x67, 0x04, 0x01, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x69, 0x04, 0x06, 0x00, 0x00, 0x00, 0xff, 0xff, 0x00, 0x02, 0x08, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x6f, 0x04, 0x01, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x32, 0x00, 0x06, 0x00, 0x00, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x38, 0x00, 0x04, 0x00, 0x00, 0x00, 0x02, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00 }
+		}};
+		/// Used for sending the settings, part 2/3
+		static constexpr std::array< uint8_t, 64 > _c_data_settings_2 = {
+			0x03, 0xf3, 0x20, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x01, 0x00, 0x01, 0x00,
+			0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+		};
+		/// Used for sending the settings, part 3/3
+		static constexpr std::array< std::array<uint8_t, 16>, 140 > _c_data_settings_3 = {{
+			{ 0x02, 0xf3, 0x42, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x02, 0x01, 0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xb2, 0x01, 0x01, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x62, 0x02, 0x01, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x12, 0x03, 0x01, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf1, 0x02, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf1, 0x02, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x44, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01, 0x0b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x04, 0x01, 0x04, 0x00, 0x00, 0x00, 0x01, 0x0b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xb4, 0x01, 0x04, 0x00, 0x00, 0x00, 0x01, 0x0b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x64, 0x02, 0x04, 0x00, 0x00, 0x00, 0x01, 0x0b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x14, 0x03, 0x04, 0x00, 0x00, 0x00, 0x01, 0x0b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x4a, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01, 0x16, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x0a, 0x01, 0x04, 0x00, 0x00, 0x00, 0x01, 0x16, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xba, 0x01, 0x04, 0x00, 0x00, 0x00, 0x01, 0x16, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x6a, 0x02, 0x04, 0x00, 0x00, 0x00, 0x01, 0x16, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x1a, 0x03, 0x04, 0x00, 0x00, 0x00, 0x01, 0x16, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x50, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01, 0x2d, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x10, 0x01, 0x04, 0x00, 0x00, 0x00, 0x01, 0x2d, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xc0, 0x01, 0x04, 0x00, 0x00, 0x00, 0x01, 0x2d, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x70, 0x02, 0x04, 0x00, 0x00, 0x00, 0x01, 0x2d, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x20, 0x03, 0x04, 0x00, 0x00, 0x00, 0x01, 0x2d, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x56, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01, 0x43, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x16, 0x01, 0x04, 0x00, 0x00, 0x00, 0x01, 0x43, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xc6, 0x01, 0x04, 0x00, 0x00, 0x00, 0x01, 0x43, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x76, 0x02, 0x04, 0x00, 0x00, 0x00, 0x01, 0x43, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x26, 0x03, 0x04, 0x00, 0x00, 0x00, 0x01, 0x43, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x5c, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01, 0x8c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x1c, 0x01, 0x04, 0x00, 0x00, 0x00, 0x01, 0x8c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xcc, 0x01, 0x04, 0x00, 0x00, 0x00, 0x01, 0x8c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x7c, 0x02, 0x04, 0x00, 0x00, 0x00, 0x01, 0x8c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x2c, 0x03, 0x04, 0x00, 0x00, 0x00, 0x01, 0x8c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf1, 0x02, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x2c, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf1, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x82, 0x00, 0x04, 0x00, 0x00, 0x00, 0x81, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x86, 0x00, 0x04, 0x00, 0x00, 0x00, 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x8a, 0x00, 0x04, 0x00, 0x00, 0x00, 0x83, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x8e, 0x00, 0x04, 0x00, 0x00, 0x00, 0x99, 0x81, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x92, 0x00, 0x04, 0x00, 0x00, 0x00, 0x8a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x96, 0x00, 0x04, 0x00, 0x00, 0x00, 0x89, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x9a, 0x00, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x1e, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x9e, 0x00, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xa2, 0x00, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xa6, 0x00, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x21, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xaa, 0x00, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x22, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xae, 0x00, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x23, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xb2, 0x00, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xb6, 0x00, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x25, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xba, 0x00, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x26, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xbe, 0x00, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x27, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xc2, 0x00, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x57, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xc6, 0x00, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x56, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xda, 0x00, 0x04, 0x00, 0x00, 0x00, 0x8b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xde, 0x00, 0x04, 0x00, 0x00, 0x00, 0x8c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x42, 0x01, 0x04, 0x00, 0x00, 0x00, 0x81, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x46, 0x01, 0x04, 0x00, 0x00, 0x00, 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x4a, 0x01, 0x04, 0x00, 0x00, 0x00, 0x83, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x4e, 0x01, 0x04, 0x00, 0x00, 0x00, 0x99, 0x81, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x52, 0x01, 0x04, 0x00, 0x00, 0x00, 0x8a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x56, 0x01, 0x04, 0x00, 0x00, 0x00, 0x89, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x5a, 0x01, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x1e, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x5e, 0x01, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x62, 0x01, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x66, 0x01, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x21, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x6a, 0x01, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x22, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x6e, 0x01, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x23, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x72, 0x01, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x76, 0x01, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x25, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x7a, 0x01, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x26, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x7e, 0x01, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x27, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x82, 0x01, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x57, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x86, 0x01, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x56, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x9a, 0x01, 0x04, 0x00, 0x00, 0x00, 0x8b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x9e, 0x01, 0x04, 0x00, 0x00, 0x00, 0x8c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xf2, 0x01, 0x04, 0x00, 0x00, 0x00, 0x81, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xf6, 0x01, 0x04, 0x00, 0x00, 0x00, 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xfa, 0x01, 0x04, 0x00, 0x00, 0x00, 0x83, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xfe, 0x01, 0x04, 0x00, 0x00, 0x00, 0x99, 0x81, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x02, 0x02, 0x04, 0x00, 0x00, 0x00, 0x8a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x06, 0x02, 0x04, 0x00, 0x00, 0x00, 0x89, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x0a, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x1e, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x0e, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x12, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x16, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x21, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x1a, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x22, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x1e, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x23, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x22, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x26, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x25, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x2a, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x26, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x2e, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x27, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x32, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x57, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x36, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x56, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x4a, 0x02, 0x04, 0x00, 0x00, 0x00, 0x8b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x4e, 0x02, 0x04, 0x00, 0x00, 0x00, 0x8c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xa2, 0x02, 0x04, 0x00, 0x00, 0x00, 0x81, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xa6, 0x02, 0x04, 0x00, 0x00, 0x00, 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xaa, 0x02, 0x04, 0x00, 0x00, 0x00, 0x83, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xae, 0x02, 0x04, 0x00, 0x00, 0x00, 0x99, 0x81, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xb2, 0x02, 0x04, 0x00, 0x00, 0x00, 0x8a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xb6, 0x02, 0x04, 0x00, 0x00, 0x00, 0x89, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xba, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x1e, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xbe, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xc2, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xc6, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x21, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xca, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x22, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xce, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x23, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xd2, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xd6, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x25, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xda, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x26, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xde, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x27, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xe2, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x57, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xe6, 0x02, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x56, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xfa, 0x02, 0x04, 0x00, 0x00, 0x00, 0x8b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xfe, 0x02, 0x04, 0x00, 0x00, 0x00, 0x8c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x52, 0x03, 0x04, 0x00, 0x00, 0x00, 0x81, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x56, 0x03, 0x04, 0x00, 0x00, 0x00, 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x5a, 0x03, 0x04, 0x00, 0x00, 0x00, 0x83, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x5e, 0x03, 0x04, 0x00, 0x00, 0x00, 0x99, 0x81, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x62, 0x03, 0x04, 0x00, 0x00, 0x00, 0x8a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x66, 0x03, 0x04, 0x00, 0x00, 0x00, 0x89, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x6a, 0x03, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x1e, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x6e, 0x03, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x72, 0x03, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x76, 0x03, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x21, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x7a, 0x03, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x22, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x7e, 0x03, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x23, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x82, 0x03, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x86, 0x03, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x25, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x8a, 0x03, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x26, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x8e, 0x03, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x27, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x92, 0x03, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x57, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0x96, 0x03, 0x04, 0x00, 0x00, 0x00, 0x90, 0x00, 0x56, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xaa, 0x03, 0x04, 0x00, 0x00, 0x00, 0x8b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf3, 0xae, 0x03, 0x04, 0x00, 0x00, 0x00, 0x8c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf1, 0x02, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf1, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf1, 0x02, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf1, 0x02, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+			{ 0x02, 0xf5, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }
+		}};
+};
+
+#endif
@@ -22,6 +22,8 @@
 
 int mouse_m908::write_profile(){
 	
+	RD_LOG_DEBUG( "model " << get_name() << ", profile " << _s_profile+1 );
+	
 	//prepare data
 	uint8_t buffer[6][16];
 	for( int i = 0; i < 6; i++ ){
@@ -33,105 +35,71 @@ int mouse_m908::write_profile(){
 	
 	//send data
 	for( int i = 0; i < 6; i++ ){
-		libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer[i], 16, 1000 );
+		_i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, buffer[i], 16, 1000 );
 	}
 	
-	return 0;
+	return _i_transfer_error;
 }
 
 int mouse_m908::write_settings(){
 	
-	//prepare data 1
-	int rows1 = sizeof(_c_data_settings_1) / sizeof(_c_data_settings_1[0]);
-	uint8_t buffer1[rows1][16];
-	for( int i = 0; i < rows1; i++ ){
-		std::copy(std::begin(_c_data_settings_1[i]), std::end(_c_data_settings_1[i]), std::begin(buffer1[i]));
-	}
+	RD_LOG_DEBUG( "model " << get_name() );
 	
-	//prepare data 2
-	uint8_t buffer2[64];
-	std::copy(std::begin(_c_data_settings_2), std::end(_c_data_settings_2), std::begin(buffer2));
+	return write_settings( mouse_m908_profile::encode( _s_scrollspeeds, _s_lightmodes, _s_colors, _s_brightness_levels, _s_speed_levels,
+		_s_dpi_enabled, _s_dpi_levels, _s_keymap_data, _s_report_rates ) );
+}
+
+int mouse_m908::write_settings( const mouse_m908_profile::reports& reports ){
 	
-	//prepare data 3
-	int rows3 = sizeof(_c_data_settings_3) / sizeof(_c_data_settings_3[0]);
-	uint8_t buffer3[rows3][16];
-	for( int i = 0; i < rows3; i++ ){
-		std::copy(std::begin(_c_data_settings_3[i]), std::end(_c_data_settings_3[i]), std::begin(buffer3[i]));
-	}
+	//the reports are not modified, the copies are needed because _i_control_transfer takes non-const buffers
+	mouse_m908_profile::reports buffers = reports;
 	
-	//modify buffers to include settings
-	//scrollspeed
-	for( int i = 0; i < 5; i++ ){
-		buffer2[8+(2*i)] = _s_scrollspeeds[i];
-	}
-	//lightmode
-	for( int i = 0; i < 5; i++ ){
-		std::array<uint8_t, 2> lightmode_bytes = {0x01, 0x02}; // default value is lightmode_static, only relevent in case of an error
-		_i_encode_lightmode( _s_lightmodes[i], lightmode_bytes );
-		buffer1[3+(2*i)][11] = lightmode_bytes.at(0);
-		buffer1[3+(2*i)][13] = lightmode_bytes.at(1);
-	}
-	//color
-	for( int i = 0; i < 5; i++ ){
-		buffer1[3+(2*i)][8] = _s_colors[i].at(0);
-		buffer1[3+(2*i)][9] = _s_colors[i].at(1);
-		buffer1[3+(2*i)][10] = _s_colors[i].at(2);
-	}
-	//brightness
-	for( int i = 0; i < 5; i++ ){
-		buffer1[4+(2*i)][8] = _s_brightness_levels[i];
-	}
-	//speed
-	for( int i = 0; i < 5; i++ ){
-		buffer1[3+(2*i)][12] = _s_speed_levels[i];
-	}
-	//dpi
-	for( int i = 0; i < 5; i++ ){
-		for( int j = 0; j < 5; j++ ){
-			buffer3[7+(5*i)+j][8] = _s_dpi_enabled[j][i];
-			buffer3[7+(5*i)+j][9] = _s_dpi_levels[j][i][0];
-			buffer3[7+(5*i)+j][10] = _s_dpi_levels[j][i][1];
-		}
-	}
-	//key mapping
-	for( int i = 0; i < 5; i++ ){
-		for( int j = 0; j < 20; j++ ){
-			buffer3[35+(20*i)+j][8] = _s_keymap_data[i][j][0];
-			buffer3[35+(20*i)+j][9] = _s_keymap_data[i][j][1];
-			buffer3[35+(20*i)+j][10] = _s_keymap_data[i][j][2];
-			buffer3[35+(20*i)+j][11] = _s_keymap_data[i][j][3];
-		}
-	}
-	//usb report rate
-	for( int i = 0; i < 3; i++ )
-		buffer1[13][8+(2*i)] = _i_encode_report_rate(_s_report_rates[i]);
-	for( int i = 3; i < 5; i++ )
-		buffer1[14][2+(2*i)] = _i_encode_report_rate(_s_report_rates[i]);
-	
-
 	//send data 1
-	for( int i = 0; i < rows1; i++ ){
-		libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer1[i], 16, 1000 );
+	for( auto& row : buffers.data_1 ){
+		_i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, row.data(), 16, 1000 );
 	}
 	
 	//send data 2
-	libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer2, 64, 1000 );
+	_i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, buffers.data_2.data(), 64, 1000 );
 	
 	//send data 3
-	for( int i = 0; i < rows3; i++ ){
-		libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer3[i], 16, 1000 );
+	for( auto& row : buffers.data_3 ){
+		_i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, row.data(), 16, 1000 );
 	}
 	
-	return 0;
+	return _i_transfer_error;
+}
+
+int mouse_m908::write_color( rd_profile profile, std::array<uint8_t, 3> color ){
+	
+	_s_colors[profile] = color;
+	
+	//prepare data
+	std::array<uint8_t, 16> buffer1 = mouse_m908_profile::session_open();
+	std::array<uint8_t, 16> buffer2 = mouse_m908_profile::encode_color( profile, _s_lightmodes[profile], color, _s_speed_levels[profile] );
+	std::array<uint8_t, 16> buffer3 = mouse_m908_profile::session_close();
+	
+	//send data, failed transfers are reported because the effects count them
+	int failed = 0;
+	failed += _i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, buffer1.data(), 16, 1000 ) < 0;
+	failed += _i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, buffer2.data(), 16, 1000 ) < 0;
+	failed += _i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, buffer3.data(), 16, 1000 ) < 0;
+	
+	if( _i_transfer_error != 0 )
+		return _i_transfer_error;
+	return failed;
 }
 
 int mouse_m908::write_macro( int macro_number ){
 	
 	//check if macro_number is valid
 	if( macro_number < 1 || macro_number > 15 ){
+		RD_LOG_ERROR( "invalid macro number " << macro_number );
 		return 1;
 	}
 	
+	RD_LOG_DEBUG( "model " << get_name() << ", macro " << macro_number );
+	
 	//prepare data 1
 	uint8_t buffer1[16];
 	std::copy(std::begin(_c_data_macros_1), std::end(_c_data_macros_1), std::begin(buffer1));
@@ -145,13 +113,98 @@ int mouse_m908::write_macro( int macro_number ){
 	std::copy(std::begin(_c_data_macros_3), std::end(_c_data_macros_3), std::begin(buffer3));
 	
 	//send data 1
-	libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer1, 16, 1000 );
+	_i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, buffer1, 16, 1000 );
 	
 	//send data 2
-	libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer2, 256, 1000 );
+	_i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, buffer2, 256, 1000 );
 	
 	//send data 3
-	libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0302, 0x0002, buffer3, 16, 1000 );
+	_i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, buffer3, 16, 1000 );
+	
+	return _i_transfer_error;
+}
+
+int mouse_m908::write_memory( const memory_image& target, const memory_image& current, size_t& rows ){
+	
+	RD_LOG_DEBUG( "model " << get_name() );
+	
+	rows = 0;
+	
+	// copies the bytes of target into a write row, bytes missing from target are taken from current (the mouse keeps them),
+	// returns whether all bytes of the row are known and whether the row differs from current
+	size_t partial_rows = 0;
+	auto fill = [&target, &current, &partial_rows]( uint8_t* row, size_t size, bool& changed ){
+		uint16_t address = row[2] | (row[3] << 8);
+		bool known = false, complete = true;
+		changed = false;
+		for( size_t i = 0; i < row[4] && 8+i < size; i++ ){
+			auto byte = target.find( address+i );
+			auto old = current.find( address+i );
+			if( byte != target.end() ){
+				known = true;
+				row[8+i] = byte->second;
+				changed = changed || old == current.end() || old->second != byte->second;
+			} else if( old != current.end() ){
+				row[8+i] = old->second;
+			} else{
+				complete = false;
+			}
+		}
+		// a partly known row would write the defaults of the template
+		if( known && !complete )
+			partial_rows++;
+		return known && complete;
+	};
+	
+	//prepare settings: the rows of write_settings, other commands (0xf1, 0xf5) are kept
+	mouse_m908_profile::reports reports = mouse_m908_profile().get_reports();
+	std::vector< std::pair< uint16_t, std::vector<uint8_t> > > settings;
+	size_t changed_rows = 0;
+	
+	auto add = [&]( uint16_t value, uint8_t* row, size_t size ){
+		bool changed = false;
+		if( row[1] == 0xf3 && (!fill( row, size, changed ) || !changed) )
+			return;
+		changed_rows += changed;
+		settings.push_back( { value, std::vector<uint8_t>( row, row+size ) } );
+	};
+	
+	for( auto& row : reports.data_1 )
+		add( 0x0302, row.data(), row.size() );
+	add( 0x0302, reports.data_2.data(), reports.data_2.size() );
+	for( auto& row : reports.data_3 )
+		add( 0x0302, row.data(), row.size() );
+	
+	//send settings, nothing if no row changed
+	if( changed_rows > 0 ){
+		for( auto& row : settings )
+			_i_control_transfer( 0x21, 0x09, row.first, 0x0002, row.second.data(), row.second.size(), 1000 );
+		rows += changed_rows;
+	}
+	
+	//send the macros that changed
+	for( int i = 0; i < 15; i++ ){
+		
+		uint8_t buffer1[16], buffer2[256], buffer3[16];
+		std::copy( std::begin(_c_data_macros_1), std::end(_c_data_macros_1), std::begin(buffer1) );
+		std::copy( std::begin(_c_data_macros_2), std::end(_c_data_macros_2), std::begin(buffer2) );
+		std::copy( std::begin(_c_data_macros_3), std::end(_c_data_macros_3), std::begin(buffer3) );
+		buffer2[2] = _c_data_macros_codes[i][0];
+		buffer2[3] = _c_data_macros_codes[i][1];
+		
+		bool changed = false;
+		if( !fill( buffer2, sizeof(buffer2), changed ) || !changed )
+			continue;
+		
+		_i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, buffer1, 16, 1000 );
+		_i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, buffer2, 256, 1000 );
+		_i_control_transfer( 0x21, 0x09, 0x0302, 0x0002, buffer3, 16, 1000 );
+		rows++;
+	}
+	
+	if( partial_rows > 0 )
+		RD_LOG_WARNING( partial_rows << " rows are only partly known and were not written" );
+	RD_LOG_INFO( rows << " rows differ from the mouse" );
 	
-	return 0;
+	return _i_transfer_error;
 }
@@ -21,6 +21,9 @@
 // Constructor, set the default settings
 mouse_m913::mouse_m913(){
 	
+	// the M913 has no interface 2
+	_i_interface_count = 2;
+	
 	//default settings
 	_s_profile = profile_1;
 	_s_scrollspeeds.fill( 0x01 );
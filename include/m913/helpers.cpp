@@ -22,158 +22,17 @@
 
 //init libusb and open mouse
 int mouse_m913::open_mouse(){
-	
-	//vars
-	int res = 0;
-	
-	//libusb init
-	res = libusb_init( NULL );
-	if( res < 0 ){
-		return res;
-	}
-	
-	//open device
-	_i_handle = libusb_open_device_with_vid_pid( NULL, _c_mouse_vid, _c_mouse_pid );
-	if( !_i_handle ){
-		return 1;
-	}
-	
-	if( _i_detach_kernel_driver ){
-		//detach kernel driver on interface 0 if active 
-		if( libusb_kernel_driver_active( _i_handle, 0 ) ){
-			res += libusb_detach_kernel_driver( _i_handle, 0 );
-			if( res == 0 ){
-				_i_detached_driver_0 = true;
-			} else{
-				return res;
-			}
-		}
-		
-		//detach kernel driver on interface 1 if active 
-		if( libusb_kernel_driver_active( _i_handle, 1 ) ){
-			res += libusb_detach_kernel_driver( _i_handle, 1 );
-			if( res == 0 ){
-				_i_detached_driver_1 = true;
-			} else{
-				return res;
-			}
-		}
-	}
-	
-	//claim interface 0
-	res += libusb_claim_interface( _i_handle, 0 );
-	if( res != 0 ){
-		return res;
-	}
-	
-	//claim interface 1
-	res += libusb_claim_interface( _i_handle, 1 );
-	if( res != 0 ){
-		return res;
-	}
-	
-	return res;
+	return _i_open_mouse( _c_mouse_vid, _c_mouse_pid );
 }
 
 // init libusb and open mouse by bus and device
 int mouse_m913::open_mouse_bus_device( uint8_t bus, uint8_t device ){
-
-	//vars
-	int res = 0;
-	
-	//libusb init
-	res = libusb_init( NULL );
-	if( res < 0 ){
-		return res;
-	}
-	
-	//open device (_i_handle)
-	libusb_device **dev_list; // device list
-	ssize_t num_devs = libusb_get_device_list(NULL, &dev_list); //get device list
-	
-	if( num_devs < 0 )
-		return 1;
-	
-	for( ssize_t i = 0; i < num_devs; i++ ){
-		
-		// check if correct bus and device
-		if( bus == libusb_get_bus_number( dev_list[i] ) &&
-			device == libusb_get_device_address( dev_list[i] ) ){
-			
-			// open device
-			if( libusb_open( dev_list[i], &_i_handle ) != 0 ){
-				return 1;
-			} else{
-				break;
-			}
-			
-		}
-		
-	}
-	
-	//free device list, unreference devices
-	libusb_free_device_list( dev_list, 1 );
-	
-	
-	if( _i_detach_kernel_driver ){
-		//detach kernel driver on interface 0 if active 
-		if( libusb_kernel_driver_active( _i_handle, 0 ) ){
-			res += libusb_detach_kernel_driver( _i_handle, 0 );
-			if( res == 0 ){
-				_i_detached_driver_0 = true;
-			} else{
-				return res;
-			}
-		}
-		
-		//detach kernel driver on interface 1 if active 
-		if( libusb_kernel_driver_active( _i_handle, 1 ) ){
-			res += libusb_detach_kernel_driver( _i_handle, 1 );
-			if( res == 0 ){
-				_i_detached_driver_1 = true;
-			} else{
-				return res;
-			}
-		}
-		
-	}
-		
-	//claim interface 0
-	res += libusb_claim_interface( _i_handle, 0 );
-	if( res != 0 ){
-		return res;
-	}
-	
-	//claim interface 1
-	res += libusb_claim_interface( _i_handle, 1 );
-	if( res != 0 ){
-		return res;
-	}
-	
-	return res;
+	return _i_open_mouse_bus_device( bus, device );
 }
 
 // close mouse
 int mouse_m913::close_mouse(){
-
-	// release interfaces 0 and 1
-	libusb_release_interface( _i_handle, 0 );
-	libusb_release_interface( _i_handle, 1 );
-	
-	// attach kernel driver for interface 0
-	if( _i_detached_driver_0 ){
-		libusb_attach_kernel_driver( _i_handle, 0 );
-	}
-	
-	// attach kernel driver for interface 1
-	if( _i_detached_driver_1 ){
-		libusb_attach_kernel_driver( _i_handle, 1 );
-	}
-	
-	// exit libusb
-	libusb_exit( NULL );
-	
-	return 0;
+	return _i_close_mouse();
 }
 
 // print current configuration
@@ -186,6 +186,14 @@ class mouse_m913 : public rd_mouse{
 			return vid == _c_mouse_vid && _c_all_pids.find(pid) != _c_all_pids.end();
 		}
 		
+		/// Get the USB ids of the model (vendor id, product id)
+		static std::vector< std::pair<uint16_t, uint16_t> > get_ids(){
+			std::vector< std::pair<uint16_t, uint16_t> > ids;
+			for( uint16_t pid : _c_all_pids )
+				ids.push_back( { _c_mouse_vid, pid } );
+			return ids;
+		}
+		
 		/// Get mouse name
 		static std::string get_name(){
 			return _c_name;
@@ -28,6 +28,8 @@ int mouse_m913::write_profile(){
 
 int mouse_m913::write_settings(){
 
+	RD_LOG_DEBUG( "model " << get_name() );
+
 	// return value
 	int ret = 0;
 
@@ -75,26 +77,24 @@ int mouse_m913::write_settings(){
 		buffer[j][13] = _s_keymap_data[profile_1][i+1][3];
 	}
 
-	// TODO! remove, print hexdump of buffer
-	/*
+	// hexdump of the buffer
 	for( int i = 0; i < rows; i++ ){
-		std::cout << i << "\t: ";
-		for( int j=0; j < 17; j++ ){
-			std::cout << std::hex << std::setw(2) << std::setfill('0') << (int)buffer[i][j] << " ";
-		}
-		std::cout << "\n";
+		RD_LOG_TRACE( i << ": " << rd_log::hex( buffer[i], 17 ) );
 	}
-	*/
 
 	
 	// send data
 	uint8_t buffer_in[17]; // holds the received data
 	int received; // how many bytes were actually received
 	for( int i = 0; i < rows; i++ ){
-		ret += libusb_control_transfer( _i_handle, 0x21, 0x09, 0x0308, 0x0001, buffer[i], 17, 1000 );
-		ret += libusb_interrupt_transfer( _i_handle, 0x82, buffer_in, 17, &received, 1000 );
+		ret += _i_control_transfer( 0x21, 0x09, 0x0308, 0x0001, buffer[i], 17, 1000 );
+		ret += _i_interrupt_transfer( 0x82, buffer_in, 17, &received, 1000 );
 	}
 
+	// transfers aborted (deadline or cancellation)
+	if( _i_transfer_error != 0 )
+		return _i_transfer_error;
+
 	return ret;
 }
 
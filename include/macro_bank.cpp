@@ -0,0 +1,183 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+
+#include "macro_bank.h"
+
+#include <algorithm>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char macro_bank_magic[8] = { 'R', 'D', 'M', 'A', 'C', 'R', 'O', 'S' };
+static const size_t macro_bank_header_size = 48;
+static const size_t macro_bank_entry_size = 40;
+
+// store value as little endian
+static void macro_bank_put( uint8_t* bytes, uint64_t value, int size ){
+	for( int i = 0; i < size; i++ )
+		bytes[i] = (value >> (8*i)) & 0xff;
+}
+
+// read little endian value
+static uint64_t macro_bank_get( const uint8_t* bytes, int size ){
+	uint64_t value = 0;
+	for( int i = 0; i < size; i++ )
+		value |= (uint64_t)bytes[i] << (8*i);
+	return value;
+}
+
+bool rd_macro_bank::is_macro_bank( const std::string& file ){
+	
+	std::ifstream in( file, std::ios::binary );
+	char magic[8];
+	
+	return in.read( magic, sizeof(magic) ) && std::equal( std::begin(magic), std::end(magic), macro_bank_magic );
+}
+
+int rd_macro_bank::compile( const std::string& file, const std::string& model, const std::vector< macro >& macros ){
+	
+	size_t index_offset = macro_bank_header_size;
+	size_t images_offset = index_offset + macros.size() * macro_bank_entry_size;
+	std::vector< uint8_t > bytes( images_offset + macros.size() * slot_size, 0 );
+	
+	// header
+	std::copy( std::begin(macro_bank_magic), std::end(macro_bank_magic), bytes.begin() );
+	macro_bank_put( &bytes[8], 1, 2 );
+	macro_bank_put( &bytes[10], slot_size, 2 );
+	macro_bank_put( &bytes[12], macros.size(), 4 );
+	std::copy_n( model.begin(), std::min( model.size(), (size_t)15 ), bytes.begin() + 16 );
+	macro_bank_put( &bytes[32], index_offset, 4 );
+	macro_bank_put( &bytes[36], images_offset, 4 );
+	
+	// index and slot images
+	for( size_t i = 0; i < macros.size(); i++ ){
+		
+		if( macros[i].number < 1 || macros[i].number > 15 )
+			return 1;
+		
+		uint8_t* entry = &bytes[index_offset + i * macro_bank_entry_size];
+		std::copy_n( macros[i].name.begin(), std::min( macros[i].name.size(), name_size - 1 ), entry );
+		entry[32] = macros[i].number;
+		macro_bank_put( entry + 36, i, 4 );
+		
+		std::copy( macros[i].image.begin(), macros[i].image.end(), bytes.begin() + images_offset + i * slot_size );
+	}
+	
+	std::ofstream out( file, std::ios::binary | std::ios::trunc );
+	if( !out.is_open() )
+		return 1;
+	
+	out.write( (const char*)bytes.data(), bytes.size() );
+	
+	return out.good() ? 0 : 1;
+}
+
+int rd_macro_bank::open( const std::string& file ){
+	
+	close();
+	
+	int fd = ::open( file.c_str(), O_RDONLY );
+	if( fd < 0 )
+		return 1;
+	
+	struct stat file_stat;
+	if( fstat( fd, &file_stat ) != 0 || (size_t)file_stat.st_size < macro_bank_header_size ){
+		::close( fd );
+		return 1;
+	}
+	
+	void* data = mmap( nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+	::close( fd );
+	
+	if( data == MAP_FAILED )
+		return 1;
+	
+	_i_data = static_cast< const uint8_t* >( data );
+	_i_size = file_stat.st_size;
+	
+	// check the header
+	if( !std::equal( std::begin(macro_bank_magic), std::end(macro_bank_magic), _i_data ) ||
+		macro_bank_get( _i_data+8, 2 ) != 1 || macro_bank_get( _i_data+10, 2 ) != slot_size ){
+		close();
+		return 1;
+	}
+	
+	_i_count = macro_bank_get( _i_data+12, 4 );
+	size_t index_offset = macro_bank_get( _i_data+32, 4 );
+	size_t images_offset = macro_bank_get( _i_data+36, 4 );
+	
+	// index and slot images inside the file
+	if( index_offset + _i_count * macro_bank_entry_size > _i_size || images_offset > _i_size ){
+		close();
+		return 1;
+	}
+	
+	_i_index = _i_data + index_offset;
+	_i_images = _i_data + images_offset;
+	
+	for( size_t i = 0; i < _i_count; i++ ){
+		
+		const uint8_t* entry = _i_index + i * macro_bank_entry_size;
+		if( entry[32] < 1 || entry[32] > 15 ||
+			images_offset + (macro_bank_get( entry+36, 4 ) + 1) * slot_size > _i_size ){
+			close();
+			return 1;
+		}
+	}
+	
+	return 0;
+}
+
+void rd_macro_bank::close(){
+	
+	if( _i_data != nullptr )
+		munmap( const_cast< uint8_t* >( _i_data ), _i_size );
+	
+	_i_data = nullptr;
+	_i_size = 0;
+	_i_count = 0;
+	_i_index = nullptr;
+	_i_images = nullptr;
+}
+
+std::string rd_macro_bank::model() const {
+	
+	if( _i_data == nullptr )
+		return "";
+	
+	const char* name = (const char*)_i_data + 16;
+	return std::string( name, std::find( name, name+16, '\0' ) );
+}
+
+std::string rd_macro_bank::name( size_t i ) const {
+	
+	const char* name = (const char*)_i_index + i * macro_bank_entry_size;
+	return std::string( name, std::find( name, name+name_size, '\0' ) );
+}
+
+int rd_macro_bank::number( size_t i ) const {
+	return _i_index[i * macro_bank_entry_size + 32];
+}
+
+const uint8_t* rd_macro_bank::image( size_t i ) const {
+	return _i_images + macro_bank_get( _i_index + i * macro_bank_entry_size + 36, 4 ) * slot_size;
+}
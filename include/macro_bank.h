@@ -0,0 +1,119 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+
+#ifndef RD_MACRO_BANK
+#define RD_MACRO_BANK
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * A compiled macro bank: a header, an index of named macros and the
+ * pre-encoded 256 byte slot images (as sent by write_macro). The bank is
+ * compiled for one model, the slot images contain the slot codes of that
+ * model. Loading a bank maps the file into memory without any parsing.
+ * 
+ * File format, all values little endian:
+ * 
+ * header (48 bytes):
+ *   0  char[8]   magic "RDMACROS"
+ *   8  uint16    format version (1)
+ *  10  uint16    slot image size (256)
+ *  12  uint32    number of macros
+ *  16  char[16]  model name, zero padded
+ *  32  uint32    offset of the index
+ *  36  uint32    offset of the slot images
+ *  40  uint64    reserved
+ * 
+ * index entry (40 bytes):
+ *   0  char[32]  name, zero padded
+ *  32  uint8     macro slot (1-15)
+ *  33  uint8[3]  reserved
+ *  36  uint32    number of the slot image
+ * 
+ */
+class rd_macro_bank{
+	
+	public:
+		
+		/// Size of a slot image
+		static const size_t slot_size = 256;
+		/// Maximum length of a macro name
+		static const size_t name_size = 32;
+		
+		/// A macro for compile()
+		struct macro{
+			std::string name;
+			int number;
+			std::array< uint8_t, slot_size > image;
+		};
+		
+		rd_macro_bank() = default;
+		~rd_macro_bank(){ close(); }
+		
+		rd_macro_bank( const rd_macro_bank& ) = delete;
+		rd_macro_bank& operator=( const rd_macro_bank& ) = delete;
+		
+		/// Check if the file starts with the macro bank magic
+		static bool is_macro_bank( const std::string& file );
+		
+		/** \brief Write a macro bank
+		 * \arg file output file
+		 * \arg model name of the model the slot images were encoded for
+		 * \arg macros the named macros
+		 * \return 0 if successful
+		 */
+		static int compile( const std::string& file, const std::string& model, const std::vector< macro >& macros );
+		
+		/** \brief Map a macro bank into memory and check its structure
+		 * \return 0 if successful, 1 if the file can't be opened or is not a valid macro bank
+		 */
+		int open( const std::string& file );
+		
+		/// Unmap the bank
+		void close();
+		
+		/// Model the bank was compiled for
+		std::string model() const;
+		/// Number of macros in the bank
+		size_t size() const { return _i_count; }
+		/// Name of macro i
+		std::string name( size_t i ) const;
+		/// Slot of macro i (1-15)
+		int number( size_t i ) const;
+		/// Slot image of macro i (slot_size bytes, points into the mapped file)
+		const uint8_t* image( size_t i ) const;
+		
+	private:
+		
+		/// mapped file, nullptr if not open
+		const uint8_t* _i_data = nullptr;
+		/// size of the mapped file
+		size_t _i_size = 0;
+		/// number of macros
+		size_t _i_count = 0;
+		/// pointer to the index and the slot images in _i_data
+		const uint8_t* _i_index = nullptr;
+		const uint8_t* _i_images = nullptr;
+};
+
+#endif
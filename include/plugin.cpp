@@ -0,0 +1,333 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+
+#include "plugin.h"
+#include "fingerprint.h"
+
+#include <dirent.h>
+#include <dlfcn.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+// plugin directory of the build, MOUSE_M908_PLUGIN_DIR overrides it
+#ifndef RD_PLUGIN_DIR
+#define RD_PLUGIN_DIR "/usr/lib/mouse_m908"
+#endif
+
+rd_plugin_loader::rd_plugin_loader(){
+	
+	// as root or setuid the environment and the cache may belong to another user, they don't choose the code that is loaded
+	bool privileged = geteuid() == 0 || geteuid() != getuid();
+	
+	const char* directory = privileged ? nullptr : getenv( "MOUSE_M908_PLUGIN_DIR" );
+	_i_directory = directory != nullptr && directory[0] != '\0' ? directory : RD_PLUGIN_DIR;
+	
+	if( privileged ){
+		_i_scan();
+		return;
+	}
+	
+	// $XDG_CACHE_HOME/mouse_m908 or ~/.cache/mouse_m908
+	if( getenv( "XDG_CACHE_HOME" ) != nullptr && getenv( "XDG_CACHE_HOME" )[0] != '\0' )
+		_i_index_file = std::string( getenv( "XDG_CACHE_HOME" ) ) + "/mouse_m908/plugins.index";
+	else if( getenv( "HOME" ) != nullptr )
+		_i_index_file = std::string( getenv( "HOME" ) ) + "/.cache/mouse_m908/plugins.index";
+	
+	if( _i_read_index() != 0 )
+		_i_scan();
+}
+
+std::vector< std::string > rd_plugin_loader::get_names(){
+	
+	std::vector< std::string > names;
+	for( auto& plugin : _i_plugins )
+		names.push_back( plugin.name );
+	
+	return names;
+}
+
+std::unique_ptr< rd_model > rd_plugin_loader::detect( const std::string& name ){
+	
+	// libusb init
+	if( libusb_init( NULL ) < 0 )
+		return nullptr;
+	
+	// get device list
+	libusb_device **dev_list; // device list
+	ssize_t num_devs = libusb_get_device_list(NULL, &dev_list);
+	
+	if( num_devs < 0 )
+		return nullptr;
+	
+	const plugin_entry* found = nullptr;
+	uint16_t found_vid = 0, found_pid = 0;
+	rd_fingerprint fingerprint;
+	
+	for( ssize_t i = 0; i < num_devs; i++ ){
+		
+		// get device descriptor
+		libusb_device_descriptor descriptor;
+		libusb_get_device_descriptor( dev_list[i], &descriptor );
+		
+		// compare the ids against the index, a fallback plugin only matches if no other does
+		const plugin_entry* match = nullptr;
+		for( auto& plugin : _i_plugins ){
+			
+			if( name != "" && plugin.name != name )
+				continue;
+			if( match != nullptr && (plugin.fallback || !match->fallback) )
+				continue;
+			
+			for( auto& id : plugin.ids ){
+				if( id.first == descriptor.idVendor && id.second == descriptor.idProduct )
+					match = &plugin;
+			}
+		}
+		
+		// the fallback plugin claims all PIDs of its VIDs: devices of another protocol family are skipped,
+		// unknown PIDs are accepted if it is requested by name and the device speaks its protocol
+		if( match != nullptr && match->fallback && !fingerprint.generic_protocol( dev_list[i] ) )
+			continue;
+		for( auto& plugin : _i_plugins ){
+			
+			if( match != nullptr || name == "" || plugin.name != name || !plugin.fallback )
+				continue;
+			
+			bool fallback_vid = false;
+			for( auto& id : plugin.ids )
+				fallback_vid = fallback_vid || id.first == descriptor.idVendor;
+			if( fallback_vid && fingerprint.probe( dev_list[i] ) == rd_fingerprint::protocol_m908 )
+				match = &plugin;
+		}
+		
+		// like rd_mouse::detect(), the last matching device is used
+		if( match != nullptr ){
+			found = match;
+			found_vid = descriptor.idVendor;
+			found_pid = descriptor.idProduct;
+		}
+	}
+	
+	// free device list, unreference devices
+	libusb_free_device_list( dev_list, 1 );
+	
+	// exit libusb
+	libusb_exit( NULL );
+	
+	if( found == nullptr )
+		return nullptr;
+	
+	return _i_create( *found, found_vid, found_pid );
+}
+
+std::unique_ptr< rd_model > rd_plugin_loader::load( const std::string& name ){
+	
+	for( auto& plugin : _i_plugins ){
+		
+		// the ids are only used by models with several ids, the first one is a valid choice
+		if( plugin.name == name && !plugin.ids.empty() )
+			return _i_create( plugin, plugin.ids[0].first, plugin.ids[0].second );
+	}
+	
+	return nullptr;
+}
+
+std::unique_ptr< rd_model > rd_plugin_loader::_i_create( const plugin_entry& plugin, uint16_t vid, uint16_t pid ){
+	
+	void* handle = nullptr;
+	const rd_plugin* registration = _i_open( _i_directory+"/"+plugin.file, handle );
+	if( registration == nullptr )
+		return nullptr;
+	
+	RD_LOG_DEBUG( "Loaded " << _i_directory << "/" << plugin.file << " for " << std::hex << vid << ":" << pid << std::dec );
+	
+	// the handle is not closed, the object uses the code of the plugin
+	return std::unique_ptr< rd_model >( registration->create( vid, pid ) );
+}
+
+const rd_plugin* rd_plugin_loader::_i_open( const std::string& file, void*& handle ){
+	
+	handle = dlopen( file.c_str(), RTLD_NOW | RTLD_LOCAL );
+	if( handle == nullptr ){
+		RD_LOG_WARNING( "Couldn't load " << file << ": " << dlerror() );
+		return nullptr;
+	}
+	
+	auto register_function = (rd_plugin_register_function)dlsym( handle, "rd_plugin_register" );
+	const rd_plugin* registration = register_function != nullptr ? register_function() : nullptr;
+	
+	if( registration == nullptr || registration->abi_version != RD_PLUGIN_ABI_VERSION ){
+		RD_LOG_WARNING( "Couldn't load " << file << ": not a plugin of this version" );
+		dlclose( handle );
+		handle = nullptr;
+		return nullptr;
+	}
+	
+	return registration;
+}
+
+int rd_plugin_loader::_i_read_index(){
+	
+	struct stat directory_status;
+	if( _i_index_file == "" || stat( _i_directory.c_str(), &directory_status ) != 0 )
+		return 1;
+	
+	std::ifstream index( _i_index_file );
+	if( !index.is_open() )
+		return 1;
+	
+	// header: directory and its modification time, files added or removed change it
+	std::string line, directory;
+	if( !std::getline( index, line ) || line != "# mouse_m908 plugin index 1" )
+		return 1;
+	if( !std::getline( index, directory ) || directory != _i_directory )
+		return 1;
+	if( !(index >> _i_directory_mtime) || _i_directory_mtime != (int64_t)directory_status.st_mtime )
+		return 1;
+	
+	// one line per plugin: file name inode size mtime fallback ids
+	std::vector< plugin_entry > plugins;
+	plugin_entry plugin;
+	size_t count = 0;
+	while( index >> plugin.file >> plugin.name >> plugin.inode >> plugin.size >> plugin.mtime >> plugin.fallback >> count ){
+		
+		// only plugins in the plugin directory, like the scan finds them
+		if( plugin.file.find( '/' ) != std::string::npos || plugin.file.length() <= 3 ||
+			plugin.file.compare( plugin.file.length()-3, 3, ".so" ) != 0 )
+			return 1;
+		
+		plugin.ids.clear();
+		for( size_t i = 0; i < count; i++ ){
+			unsigned int vid = 0, pid = 0;
+			if( !(index >> std::hex >> vid >> pid >> std::dec) )
+				return 1;
+			plugin.ids.push_back( { (uint16_t)vid, (uint16_t)pid } );
+		}
+		
+		// a plugin that was rebuilt or replaced
+		struct stat status;
+		if( stat( (_i_directory+"/"+plugin.file).c_str(), &status ) != 0 || (uint64_t)status.st_ino != plugin.inode ||
+			(uint64_t)status.st_size != plugin.size || (int64_t)status.st_mtime != plugin.mtime )
+			return 1;
+		
+		plugins.push_back( plugin );
+	}
+	
+	if( !index.eof() )
+		return 1;
+	
+	_i_plugins = plugins;
+	return 0;
+}
+
+int rd_plugin_loader::_i_scan(){
+	
+	_i_plugins.clear();
+	
+	struct stat directory_status;
+	DIR* directory = opendir( _i_directory.c_str() );
+	if( directory == nullptr || stat( _i_directory.c_str(), &directory_status ) != 0 ){
+		if( directory != nullptr )
+			closedir( directory );
+		RD_LOG_WARNING( "Couldn't open the plugin directory " << _i_directory );
+		return 1;
+	}
+	_i_directory_mtime = directory_status.st_mtime;
+	
+	std::vector< std::string > files;
+	for( dirent* entry = readdir( directory ); entry != nullptr; entry = readdir( directory ) ){
+		std::string file = entry->d_name;
+		if( file.length() > 3 && file.compare( file.length()-3, 3, ".so" ) == 0 )
+			files.push_back( file );
+	}
+	closedir( directory );
+	std::sort( files.begin(), files.end() );
+	
+	for( auto& file : files ){
+		
+		struct stat status;
+		void* handle = nullptr;
+		const rd_plugin* registration = _i_open( _i_directory+"/"+file, handle );
+		if( registration == nullptr || stat( (_i_directory+"/"+file).c_str(), &status ) != 0 ){
+			if( handle != nullptr )
+				dlclose( handle );
+			continue;
+		}
+		
+		plugin_entry plugin;
+		plugin.file = file;
+		plugin.name = registration->name;
+		plugin.fallback = registration->fallback != 0;
+		for( size_t i = 0; i < registration->id_count; i++ )
+			plugin.ids.push_back( { registration->ids[i].vid, registration->ids[i].pid } );
+		plugin.inode = status.st_ino;
+		plugin.size = status.st_size;
+		plugin.mtime = status.st_mtime;
+		_i_plugins.push_back( plugin );
+		
+		dlclose( handle );
+	}
+	
+	RD_LOG_DEBUG( "Found " << _i_plugins.size() << " plugins in " << _i_directory );
+	
+	if( _i_write_index() != 0 )
+		RD_LOG_DEBUG( "Couldn't write the plugin index " << _i_index_file );
+	
+	return 0;
+}
+
+int rd_plugin_loader::_i_write_index(){
+	
+	if( _i_index_file == "" )
+		return 1;
+	
+	// create the cache directory
+	std::string directory = _i_index_file.substr( 0, _i_index_file.rfind( '/' ) );
+	for( size_t position = directory.find( '/', 1 ); ; position = directory.find( '/', position+1 ) ){
+		mkdir( directory.substr( 0, position ).c_str(), 0755 );
+		if( position == std::string::npos )
+			break;
+	}
+	
+	// written to a temporary file first, an interrupted write leaves the old index
+	std::string temporary = _i_index_file + "." + std::to_string( getpid() );
+	std::ofstream index( temporary );
+	if( !index.is_open() )
+		return 1;
+	
+	index << "# mouse_m908 plugin index 1\n" << _i_directory << "\n" << _i_directory_mtime << "\n";
+	for( auto& plugin : _i_plugins ){
+		index << plugin.file << " " << plugin.name << " " << plugin.inode << " " << plugin.size << " "
+			<< plugin.mtime << " " << plugin.fallback << " " << plugin.ids.size() << std::hex;
+		for( auto& id : plugin.ids )
+			index << " " << id.first << " " << id.second;
+		index << std::dec << "\n";
+	}
+	
+	index.close();
+	if( !index || std::rename( temporary.c_str(), _i_index_file.c_str() ) != 0 ){
+		std::remove( temporary.c_str() );
+		return 1;
+	}
+	
+	return 0;
+}
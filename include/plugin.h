@@ -0,0 +1,267 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+
+#ifndef RD_PLUGIN
+#define RD_PLUGIN
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "actions.h"
+
+/// Version of the plugin interface (rd_plugin, rd_model and rd_options), plugins with another version are not loaded
+#define RD_PLUGIN_ABI_VERSION 3
+
+/**
+ * A model behind a common interface for main().
+ * 
+ * The monolithic build wraps the object returned by rd_mouse::detect(),
+ * the plugin build gets the object from the factory of the model plugin.
+ * 
+ */
+class rd_model{
+	
+	public:
+		
+		virtual ~rd_model(){}
+		
+		/// Get the name of the model
+		virtual std::string get_name() = 0;
+		
+		/// Perform all actions of the command line, throws std::string in case of an error
+		virtual void perform_actions( const rd_options& options, rd_stats& stats ) = 0;
+		
+		/// Compile the macros of the command line to a macro bank (--compile-macros), throws std::string in case of an error
+		virtual void compile_macro_bank( const rd_options& options ) = 0;
+		
+		/// Release the interfaces of the open mouse, it stays open (resident mode)
+		virtual void release_interfaces() = 0;
+		
+		/// Close the mouse if it is open (resident mode)
+		virtual void close_mouse() = 0;
+		
+		/// Get the claim stats of the mouse (resident mode)
+		virtual rd_mouse::claim_stats get_claim_stats() = 0;
+		
+		/// Get the usbfs device node of the open mouse, empty if it isn't open (resident mode)
+		virtual std::string get_device_node() = 0;
+};
+
+/// rd_model for the model class T
+template< typename T > class rd_model_adapter : public rd_model{
+	
+	public:
+		
+		rd_model_adapter( const T& mouse ) : _i_mouse( mouse ), _i_defaults( mouse ) {}
+		
+		std::string get_name() override {
+			return _i_mouse.get_name();
+		}
+		
+		void perform_actions( const rd_options& options, rd_stats& stats ) override {
+			
+			// resident mode: each command starts with the default settings, like in a new process
+			if( options.resident ){
+				T mouse = _i_defaults;
+				mouse.take_device( _i_mouse );
+				_i_mouse = mouse;
+			}
+			
+			::perform_actions( _i_mouse, options, stats );
+		}
+		
+		void compile_macro_bank( const rd_options& options ) override {
+			::compile_macro_bank( _i_mouse, options );
+		}
+		
+		void release_interfaces() override {
+			_i_mouse.release_interfaces();
+		}
+		
+		void close_mouse() override {
+			if( _i_mouse.is_open() )
+				_i_mouse.close_mouse();
+		}
+		
+		rd_mouse::claim_stats get_claim_stats() override {
+			return _i_mouse.get_claim_stats();
+		}
+		
+		std::string get_device_node() override {
+			return _i_mouse.get_device_node();
+		}
+		
+	private:
+		
+		T _i_mouse;
+		/// the object as detected, before any command
+		T _i_defaults;
+};
+
+/* Registration of a model plugin (<model>.so): the plugin exports the C
+ * function rd_plugin_register() (type rd_plugin_register_function), which
+ * returns a description of the model and its factory. The plugin is built
+ * from the same tree as the core, the core symbols (rd_mouse, rd_log, ...)
+ * are resolved against the executable.
+ */
+extern "C" {
+	
+	/// USB vendor and product id
+	struct rd_plugin_id{
+		uint16_t vid;
+		uint16_t pid;
+	};
+	
+	/// What a model plugin registers
+	struct rd_plugin{
+		/// RD_PLUGIN_ABI_VERSION of the plugin
+		uint32_t abi_version;
+		/// model name, same as get_name()
+		const char* name;
+		/// USB ids of the model
+		const rd_plugin_id* ids;
+		size_t id_count;
+		/// 1 if the plugin only matches when no other plugin does (generic)
+		uint32_t fallback;
+		/// creates the model object for the detected USB ids, deleted by the caller
+		rd_model* (*create)( uint16_t vid, uint16_t pid );
+	};
+	
+	/// The function exported by a plugin
+	typedef const rd_plugin* (*rd_plugin_register_function)();
+}
+
+/// Registration of the model class T, returned by rd_plugin_register() in include/<model>/plugin.cpp
+template< typename T > const rd_plugin* rd_plugin_entry( bool fallback ){
+	
+	static std::string name = T::get_name();
+	static std::vector< rd_plugin_id > ids;
+	static rd_plugin plugin;
+	
+	if( ids.empty() ){
+		for( auto& id : T::get_ids() )
+			ids.push_back( { id.first, id.second } );
+		
+		plugin = { RD_PLUGIN_ABI_VERSION, name.c_str(), ids.data(), ids.size(), fallback ? 1u : 0u,
+			[]( uint16_t vid, uint16_t pid ) -> rd_model* {
+				T mouse;
+				mouse.set_vid( vid );
+				mouse.set_pid( pid );
+				return new rd_model_adapter< T >( mouse );
+			}
+		};
+	}
+	
+	return &plugin;
+}
+
+/**
+ * Finds and loads the model plugins of the plugin build.
+ * 
+ * The plugins are the files <model>.so in the directory given by the
+ * environment variable MOUSE_M908_PLUGIN_DIR or else RD_PLUGIN_DIR (set
+ * by the build). Only the plugin of the detected mouse is loaded: the
+ * names and USB ids of all plugins are kept in an index file
+ * ($XDG_CACHE_HOME/mouse_m908/plugins.index or ~/.cache/mouse_m908/...),
+ * which is rebuilt by loading every plugin once when the directory or one
+ * of the plugins changed. A loaded plugin stays loaded until the program
+ * exits.
+ * 
+ * As root or setuid (geteuid() == 0 or geteuid() != getuid())
+ * MOUSE_M908_PLUGIN_DIR and the index are ignored, RD_PLUGIN_DIR is
+ * scanned on each run.
+ * 
+ */
+class rd_plugin_loader{
+	
+	public:
+		
+		/// Read the index or scan the plugin directory
+		rd_plugin_loader();
+		
+		/// Get the names of all plugins
+		std::vector< std::string > get_names();
+		
+		/** \brief Detects supported mice, like rd_mouse::detect()
+		 * \arg name only mice with this model name, all if empty
+		 * In the case of multiple connected mice, the last matching device in the libusb device list is detected
+		 * \return The model object, nullptr if no mouse was found or the plugin couldn't be loaded
+		 */
+		std::unique_ptr< rd_model > detect( const std::string& name = "" );
+		
+		/** \brief Loads the plugin of a model without a mouse (snapshots, --simulate, --compile-macros)
+		 * \return The model object, nullptr if there is no plugin with this name
+		 */
+		std::unique_ptr< rd_model > load( const std::string& name );
+		
+		/// Get _i_directory
+		const std::string& get_directory(){ return _i_directory; }
+		
+	private:
+		
+		/// a plugin in the index
+		struct plugin_entry{
+			std::string file;
+			std::string name;
+			bool fallback = false;
+			std::vector< std::pair<uint16_t, uint16_t> > ids;
+			/// inode, size and modification time when the index was written
+			uint64_t inode = 0, size = 0;
+			int64_t mtime = 0;
+		};
+		
+		/// plugin directory
+		std::string _i_directory;
+		/// index file, empty if there is no cache directory
+		std::string _i_index_file;
+		/// modification time of the directory when the index was written
+		int64_t _i_directory_mtime = 0;
+		/// plugins in the directory
+		std::vector< plugin_entry > _i_plugins;
+		
+		/** \brief Read the index file, fails if it belongs to another directory or a plugin changed
+		 * \return 0 if successful
+		 */
+		int _i_read_index();
+		
+		/** \brief Load every plugin of the directory once and write the index file
+		 * \return 0 if successful
+		 */
+		int _i_scan();
+		
+		/** \brief Write the index file (temporary file and rename)
+		 * \return 0 if successful
+		 */
+		int _i_write_index();
+		
+		/** \brief Load a plugin and check its ABI version
+		 * \arg handle set to the handle for dlclose
+		 * \return the registration of the plugin, nullptr in case of an error
+		 */
+		const rd_plugin* _i_open( const std::string& file, void*& handle );
+		
+		/// Load the plugin and create the model object for the USB ids
+		std::unique_ptr< rd_model > _i_create( const plugin_entry& plugin, uint16_t vid, uint16_t pid );
+};
+
+#endif
@@ -17,6 +17,7 @@
  */
 
 #include "rd_mouse.h"
+#include "fingerprint.h"
 
 rd_mouse::mouse_variant rd_mouse::detect(){
 	
@@ -33,6 +34,8 @@ rd_mouse::mouse_variant rd_mouse::detect(){
 	if( num_devs < 0 )
 		return mouse;
 	
+	rd_fingerprint fingerprint;
+	
 	for( ssize_t i = 0; i < num_devs; i++ ){
 		
 		// get device descriptor
@@ -44,6 +47,7 @@ rd_mouse::mouse_variant rd_mouse::detect(){
 		uint16_t pid = descriptor.idProduct;
 
 		// Compare the VID and PID of the current device against the IDs of all mice
+		rd_mouse::mouse_variant match = rd_mouse::monostate();
 		variant_loop< rd_mouse::mouse_variant >( [&](auto m){
 
 			if( m.has_vid_pid(vid, pid) ){
@@ -52,10 +56,19 @@ rd_mouse::mouse_variant rd_mouse::detect(){
 				m.set_vid(vid);
 				m.set_pid(pid);
 
-				mouse = m;
+				match = m;
 			}
 
 		} );
+		
+		#ifdef RD_WITH_GENERIC
+		// the generic backend claims all of its PIDs, devices of another protocol family are skipped
+		if( std::holds_alternative< mouse_generic >( match ) && !fingerprint.generic_protocol( dev_list[i] ) )
+			continue;
+		#endif
+		
+		if( !std::holds_alternative< rd_mouse::monostate >( match ) )
+			mouse = match;
 
 	}
 	
@@ -83,6 +96,8 @@ rd_mouse::mouse_variant rd_mouse::detect( const std::string& mouse_name ){
 	if( num_devs < 0 )
 		return mouse;
 	
+	rd_fingerprint fingerprint;
+	
 	for( ssize_t i = 0; i < num_devs; i++ ){
 		
 		// get device descriptor
@@ -94,6 +109,7 @@ rd_mouse::mouse_variant rd_mouse::detect( const std::string& mouse_name ){
 		uint16_t pid = descriptor.idProduct;
 
 		// Compare the VID and PID of the current device against the IDs of all mice
+		rd_mouse::mouse_variant match = rd_mouse::monostate();
 		variant_loop< rd_mouse::mouse_variant >( [&](auto m){
 
 			if( m.has_vid_pid(vid, pid) && mouse_name == m.get_name() ){
@@ -102,11 +118,34 @@ rd_mouse::mouse_variant rd_mouse::detect( const std::string& mouse_name ){
 				m.set_vid(vid);
 				m.set_pid(pid);
 
-				mouse = m;
+				match = m;
 			}
 			
 		} );
 		
+		#ifdef RD_WITH_GENERIC
+		// --model generic also accepts unknown PIDs of its VIDs if they speak its protocol
+		if( mouse_name == mouse_generic::get_name() ){
+			
+			bool generic_vid = false;
+			for( auto& id : mouse_generic::get_ids() )
+				generic_vid = generic_vid || id.first == vid;
+			
+			if( std::holds_alternative< rd_mouse::monostate >( match ) && generic_vid &&
+				fingerprint.probe( dev_list[i] ) == rd_fingerprint::protocol_m908 ){
+				mouse_generic m;
+				m.set_vid(vid);
+				m.set_pid(pid);
+				match = m;
+			} else if( std::holds_alternative< mouse_generic >( match ) && !fingerprint.generic_protocol( dev_list[i] ) ){
+				continue;
+			}
+		}
+		#endif
+		
+		if( !std::holds_alternative< rd_mouse::monostate >( match ) )
+			mouse = match;
+		
 	}
 	
 	// free device list, unreference devices
@@ -118,6 +157,108 @@ rd_mouse::mouse_variant rd_mouse::detect( const std::string& mouse_name ){
 	return mouse;
 }
 
+std::vector< std::pair<uint8_t, uint8_t> > rd_mouse::find( const std::string& mouse_name ){
+	
+	std::vector< std::pair<uint8_t, uint8_t> > devices;
+	
+	// libusb init
+	if( libusb_init( NULL ) < 0 )
+		return devices;
+	
+	// get device list
+	libusb_device **dev_list; // device list
+	ssize_t num_devs = libusb_get_device_list(NULL, &dev_list);
+	
+	if( num_devs < 0 )
+		return devices;
+	
+	for( ssize_t i = 0; i < num_devs; i++ ){
+		
+		// get device descriptor
+		libusb_device_descriptor descriptor;
+		libusb_get_device_descriptor( dev_list[i], &descriptor );
+		
+		// the first matching backend decides, like in detect()
+		bool found = false;
+		variant_loop< rd_mouse::mouse_variant >( [&](auto m){
+			if( m.has_vid_pid( descriptor.idVendor, descriptor.idProduct ) && mouse_name == m.get_name() )
+				found = true;
+		} );
+		
+		if( found )
+			devices.push_back( { libusb_get_bus_number( dev_list[i] ), libusb_get_device_address( dev_list[i] ) } );
+	}
+	
+	// free device list, unreference devices
+	libusb_free_device_list( dev_list, 1 );
+	
+	// exit libusb
+	libusb_exit( NULL );
+	
+	return devices;
+}
+
+std::string rd_mouse::get_port_path(){
+
+	if( _i_handle == nullptr )
+		return "";
+
+	libusb_device* device = libusb_get_device( _i_handle );
+	std::string path = std::to_string( libusb_get_bus_number( device ) );
+
+	// port numbers from the root hub, up to 7 hub levels
+	uint8_t ports[8];
+	int count = libusb_get_port_numbers( device, ports, sizeof(ports) );
+	for( int i = 0; i < count; i++ )
+		path += (i == 0 ? "-" : ".") + std::to_string( ports[i] );
+
+	return path;
+}
+
+std::string rd_mouse::get_device_node(){
+
+	if( _i_handle == nullptr )
+		return "";
+
+	libusb_device* device = libusb_get_device( _i_handle );
+	std::ostringstream node;
+	node << "/dev/bus/usb/" << std::setfill('0') << std::setw(3) << (int)libusb_get_bus_number( device )
+		<< "/" << std::setw(3) << (int)libusb_get_device_address( device );
+
+	return node.str();
+}
+
+std::string rd_mouse::get_device_id(){
+
+	if( _i_handle == nullptr )
+		return "";
+
+	libusb_device_descriptor descriptor;
+	if( libusb_get_device_descriptor( libusb_get_device( _i_handle ), &descriptor ) != 0 )
+		return "";
+
+	std::ostringstream id;
+	id << std::hex << std::setfill('0') << std::setw(4) << descriptor.idVendor << ":" << std::setw(4) << descriptor.idProduct;
+
+	// serial number, only printable characters: the identity is stored in text files
+	std::string serial;
+	unsigned char buffer[256];
+	int length = descriptor.iSerialNumber == 0 ? 0 :
+		libusb_get_string_descriptor_ascii( _i_handle, descriptor.iSerialNumber, buffer, sizeof(buffer) );
+	for( int i = 0; i < length; i++ ){
+		if( buffer[i] > 0x20 && buffer[i] < 0x7f )
+			serial += buffer[i];
+	}
+
+	// many of these mice have no serial number, the port path is used instead
+	if( !serial.empty() )
+		id << "/serial:" << serial;
+	else
+		id << "/port:" << get_port_path();
+
+	return id.str();
+}
+
 //init libusb and open mouse
 int rd_mouse::_i_open_mouse( const uint16_t vid, const uint16_t pid ){
 	
@@ -136,57 +277,7 @@ int rd_mouse::_i_open_mouse( const uint16_t vid, const uint16_t pid ){
 		return 1;
 	}
 	
-	if( _i_detach_kernel_driver ){
-		//detach kernel driver on interface 0 if active 
-		if( libusb_kernel_driver_active( _i_handle, 0 ) ){
-			res += libusb_detach_kernel_driver( _i_handle, 0 );
-			if( res == 0 ){
-				_i_detached_driver_0 = true;
-			} else{
-				return res;
-			}
-		}
-		
-		//detach kernel driver on interface 1 if active 
-		if( libusb_kernel_driver_active( _i_handle, 1 ) ){
-			res += libusb_detach_kernel_driver( _i_handle, 1 );
-			if( res == 0 ){
-				_i_detached_driver_1 = true;
-			} else{
-				return res;
-			}
-		}
-		
-		//detach kernel driver on interface 2 if active 
-		if( libusb_kernel_driver_active( _i_handle, 2 ) ){
-			res += libusb_detach_kernel_driver( _i_handle, 2 );
-			if( res == 0 ){
-				_i_detached_driver_2 = true;
-			} else{
-				return res;
-			}
-		}
-	}
-	
-	//claim interface 0
-	res += libusb_claim_interface( _i_handle, 0 );
-	if( res != 0 ){
-		return res;
-	}
-	
-	//claim interface 1
-	res += libusb_claim_interface( _i_handle, 1 );
-	if( res != 0 ){
-		return res;
-	}
-	
-	//claim interface 2
-	res += libusb_claim_interface( _i_handle, 2 );
-	if( res != 0 ){
-		return res;
-	}
-	
-	return res;
+	return claim_interfaces();
 }
 
 // init libusb and open mouse by bus and device
@@ -229,6 +320,17 @@ int rd_mouse::_i_open_mouse_bus_device( const uint8_t bus, const uint8_t device
 	libusb_free_device_list( dev_list, 1 );
 	
 	
+	return claim_interfaces();
+}
+
+// detach the kernel drivers and claim interfaces 0, 1 and 2 (0 and 1 if _i_interface_count is 2)
+int rd_mouse::claim_interfaces(){
+	
+	if( _i_claim_stats.claimed )
+		return 0;
+	
+	int res = 0;
+	
 	if( _i_detach_kernel_driver ){
 		//detach kernel driver on interface 0 if active 
 		if( libusb_kernel_driver_active( _i_handle, 0 ) ){
@@ -251,7 +353,7 @@ int rd_mouse::_i_open_mouse_bus_device( const uint8_t bus, const uint8_t device
 		}
 		
 		//detach kernel driver on interface 2 if active 
-		if( libusb_kernel_driver_active( _i_handle, 2 ) ){
+		if( _i_interface_count > 2 && libusb_kernel_driver_active( _i_handle, 2 ) ){
 			res += libusb_detach_kernel_driver( _i_handle, 2 );
 			if( res == 0 ){
 				_i_detached_driver_2 = true;
@@ -260,7 +362,7 @@ int rd_mouse::_i_open_mouse_bus_device( const uint8_t bus, const uint8_t device
 			}
 		}
 	}
-		
+	
 	//claim interface 0
 	res += libusb_claim_interface( _i_handle, 0 );
 	if( res != 0 ){
@@ -274,36 +376,75 @@ int rd_mouse::_i_open_mouse_bus_device( const uint8_t bus, const uint8_t device
 	}
 	
 	//claim interface 2
-	res += libusb_claim_interface( _i_handle, 2 );
+	if( _i_interface_count > 2 )
+		res += libusb_claim_interface( _i_handle, 2 );
 	if( res != 0 ){
 		return res;
 	}
 	
+	_i_claim_stats.claimed = true;
+	_i_claim_stats.claims++;
+	
 	return res;
 }
 
-//close mouse
-int rd_mouse::_i_close_mouse(){
+// release interfaces 0, 1 and 2 and reattach the kernel drivers
+int rd_mouse::release_interfaces(){
+	
+	// after a failed claim the detached drivers are still reattached
+	if( !_i_claim_stats.claimed && !_i_detached_driver_0 && !_i_detached_driver_1 && !_i_detached_driver_2 )
+		return 0;
+	
+	int res = 0;
 	
 	//release interfaces 0, 1 and 2
-	libusb_release_interface( _i_handle, 0 );
-	libusb_release_interface( _i_handle, 1 );
-	libusb_release_interface( _i_handle, 2 );
+	res += libusb_release_interface( _i_handle, 0 );
+	res += libusb_release_interface( _i_handle, 1 );
+	if( _i_interface_count > 2 )
+		res += libusb_release_interface( _i_handle, 2 );
 	
 	//attach kernel driver for interface 0
 	if( _i_detached_driver_0 ){
 		libusb_attach_kernel_driver( _i_handle, 0 );
+		_i_detached_driver_0 = false;
 	}
 	
 	//attach kernel driver for interface 1
 	if( _i_detached_driver_1 ){
 		libusb_attach_kernel_driver( _i_handle, 1 );
+		_i_detached_driver_1 = false;
 	}
 	
-	
 	//attach kernel driver for interface 2
 	if( _i_detached_driver_2 ){
-		libusb_attach_kernel_driver( _i_handle, 2);
+		libusb_attach_kernel_driver( _i_handle, 2 );
+		_i_detached_driver_2 = false;
+	}
+	
+	if( _i_claim_stats.claimed )
+		_i_claim_stats.releases++;
+	_i_claim_stats.claimed = false;
+	
+	return res;
+}
+
+//close mouse
+int rd_mouse::_i_close_mouse(){
+	
+	//cancel a running jitter measurement
+	jitter_stats jitter;
+	stop_jitter_measurement( jitter );
+	
+	//update the dump of the first failed transfer with the transfers that followed
+	if( _i_failed_transfers > 0 )
+		dump_flight_recorder();
+	_i_failed_transfers = 0;
+	
+	//release interfaces, attach kernel drivers, close the device
+	if( _i_handle != nullptr ){
+		release_interfaces();
+		libusb_close( _i_handle );
+		_i_handle = nullptr;
 	}
 	
 	//exit libusb
@@ -454,13 +595,90 @@ int rd_mouse::_i_decode_macro( const std::vector< uint8_t >& macro_bytes, std::o
 
 int rd_mouse::_i_encode_macro( std::array< uint8_t, 256 >& macro_bytes, std::istream& input, const size_t offset ){
 	
+	// everything after the last action that fits is ignored
+	std::vector< std::array<uint8_t, 3> > actions;
+	_i_encode_macro_actions( actions, input, offset <= 212 ? (212 - offset) / 3 + 1 : 0 );
+	_i_write_macro_actions( macro_bytes, actions, offset );
+	
+	return 0;
+}
+
+size_t rd_mouse::_i_write_macro_actions( std::array< uint8_t, 256 >& macro_bytes, const std::vector< std::array<uint8_t, 3> >& actions, const size_t offset ){
+	
 	macro_bytes.fill( 0x00 );
 	
+	size_t data_offset = offset; // position in macro_bytes
+	size_t written = 0;
+	for( auto& action : actions ){
+		
+		// maximum length reached
+		if( data_offset > 212 )
+			break;
+		
+		std::copy( action.begin(), action.end(), macro_bytes.begin()+data_offset );
+		data_offset += 3;
+		written++;
+	}
+	
+	return written;
+}
+
+int rd_mouse::compress_macro( std::array< uint8_t, 256 >& macro_bytes, std::istream& input, const size_t offset, macro_compression& compression ){
+	
+	std::vector< std::array<uint8_t, 3> > actions;
+	_i_encode_macro_actions( actions, input, SIZE_MAX );
+	
+	compression = macro_compression();
+	compression.actions = actions.size();
+	size_t capacity = offset <= 212 ? (212 - offset) / 3 + 1 : 0;
+	
+	// smallest period p: the macro is repeats × the first p actions, or the last
+	// period lacks its trailing delay (only if the macro doesn't fit otherwise)
+	size_t n = actions.size();
+	size_t period = 0;
+	for( int pass = 0; pass < 2 && period == 0; pass++ ){
+		
+		bool exact = pass == 0;
+		if( !exact && n <= capacity )
+			break;
+		
+		size_t length = exact ? n : n + 1;
+		for( size_t p = 1; p <= length / 2; p++ ){
+			
+			if( length % p != 0 || length / p > 255 )
+				continue;
+			if( !exact && actions[p-1][0] != 0x06 )
+				continue;
+			
+			size_t i = p;
+			while( i < n && actions[i] == actions[i % p] )
+				i++;
+			
+			if( i == n ){
+				period = p;
+				compression.repeats = length / p;
+				compression.exact_timing = exact;
+				compression.added_delay = exact ? 0 : actions[p-1][1];
+				break;
+			}
+		}
+	}
+	
+	if( period != 0 )
+		actions.resize( period );
+	
+	compression.encoded_actions = _i_write_macro_actions( macro_bytes, actions, offset );
+	compression.dropped_actions = actions.size() - compression.encoded_actions;
+	
+	return 0;
+}
+
+void rd_mouse::_i_encode_macro_actions( std::vector< std::array<uint8_t, 3> >& actions, std::istream& input, const size_t max_actions ){
+	
 	// process macro
 	std::string value1 = "";
 	std::string value2 = "";
 	std::size_t position = 0; // position in line
-	int data_offset = offset; // position in macro_bytes
 	
 	for( std::string line; std::getline(input, line); ){
 		
@@ -469,9 +687,10 @@ int rd_mouse::_i_encode_macro( std::array< uint8_t, 256 >& macro_bytes, std::ist
 			continue;
 		
 		// maximum length reached
-		if(data_offset > 212)
-			return 0;
+		if( actions.size() >= max_actions )
+			return;
 
+		std::array< uint8_t, 3 > action = {};
 		position = 0;
 		position = line.find("\t", position);
 		value1 = line.substr(0, position);
@@ -480,65 +699,65 @@ int rd_mouse::_i_encode_macro( std::array< uint8_t, 256 >& macro_bytes, std::ist
 		// keyboard key down
 		if( value1 == "down" && _c_keyboard_key_values.find(value2) != _c_keyboard_key_values.end() ){
 			
-			macro_bytes[data_offset] = 0x84;
-			macro_bytes[data_offset+1] = _c_keyboard_key_values[value2];
-			data_offset += 3;
+			action[0] = 0x84;
+			action[1] = _c_keyboard_key_values[value2];
+			actions.push_back( action );
 		
 		// keyboard key up
 		} else if( value1 == "up" && _c_keyboard_key_values.find(value2) != _c_keyboard_key_values.end() ){
 			
-			macro_bytes[data_offset] = 0x04;
-			macro_bytes[data_offset+1] = _c_keyboard_key_values[value2];
-			data_offset += 3;
+			action[0] = 0x04;
+			action[1] = _c_keyboard_key_values[value2];
+			actions.push_back( action );
 		
 		// mouse button down	
 		} else if( value1 == "down" && _c_keyboard_key_values.find(value2) == _c_keyboard_key_values.end() ){
 			
 			if( value2 == "mouse_left" ){
-				macro_bytes[data_offset] = 0x81;
-				macro_bytes[data_offset+1] = 0x01;
-				data_offset += 3;
+				action[0] = 0x81;
+				action[1] = 0x01;
+				actions.push_back( action );
 			} else if( value2 == "mouse_right" ){
-				macro_bytes[data_offset] = 0x81;
-				macro_bytes[data_offset+1] = 0x02;
-				data_offset += 3;
+				action[0] = 0x81;
+				action[1] = 0x02;
+				actions.push_back( action );
 			} else if( value2 == "mouse_middle" ){
-				macro_bytes[data_offset] = 0x81;
-				macro_bytes[data_offset+1] = 0x04;
-				data_offset += 3;
+				action[0] = 0x81;
+				action[1] = 0x04;
+				actions.push_back( action );
 			} else if( value2 == "mouse_backward" ){
-				macro_bytes[data_offset] = 0x81;
-				macro_bytes[data_offset+1] = 0x08;
-				data_offset += 3;
+				action[0] = 0x81;
+				action[1] = 0x08;
+				actions.push_back( action );
 			} else if( value2 == "mouse_forward" ){
-				macro_bytes[data_offset] = 0x81;
-				macro_bytes[data_offset+1] = 0x10;
-				data_offset += 3;
+				action[0] = 0x81;
+				action[1] = 0x10;
+				actions.push_back( action );
 			}
 		
 		// mouse button up
 		} else if( value1 == "up" && _c_keyboard_key_values.find(value2) == _c_keyboard_key_values.end() ){
 			
 			if( value2 == "mouse_left" ){
-				macro_bytes[data_offset] = 0x01;
-				macro_bytes[data_offset+1] = 0x01;
-				data_offset += 3;
+				action[0] = 0x01;
+				action[1] = 0x01;
+				actions.push_back( action );
 			} else if( value2 == "mouse_right" ){
-				macro_bytes[data_offset] = 0x01;
-				macro_bytes[data_offset+1] = 0x02;
-				data_offset += 3;
+				action[0] = 0x01;
+				action[1] = 0x02;
+				actions.push_back( action );
 			} else if( value2 == "mouse_middle" ){
-				macro_bytes[data_offset] = 0x01;
-				macro_bytes[data_offset+1] = 0x04;
-				data_offset += 3;
+				action[0] = 0x01;
+				action[1] = 0x04;
+				actions.push_back( action );
 			} else if( value2 == "mouse_backward" ){
-				macro_bytes[data_offset] = 0x01;
-				macro_bytes[data_offset+1] = 0x08;
-				data_offset += 3;
+				action[0] = 0x01;
+				action[1] = 0x08;
+				actions.push_back( action );
 			} else if( value2 == "mouse_forward" ){
-				macro_bytes[data_offset] = 0x01;
-				macro_bytes[data_offset+1] = 0x10;
-				data_offset += 3;
+				action[0] = 0x01;
+				action[1] = 0x10;
+				actions.push_back( action );
 			}
 		
 		// mouse movement left
@@ -546,10 +765,10 @@ int rd_mouse::_i_encode_macro( std::array< uint8_t, 256 >& macro_bytes, std::ist
 			
 			int distance = (uint8_t)(int8_t)(std::stoi( value2, 0, 10) * (-1));
 			if( distance >= 0x88 ){
-				macro_bytes[data_offset] = 0x02;
-				macro_bytes[data_offset+1] = distance;
-				macro_bytes[data_offset+2] = 0x00;
-				data_offset += 3;
+				action[0] = 0x02;
+				action[1] = distance;
+				action[2] = 0x00;
+				actions.push_back( action );
 			}
 		
 		// mouse movement right
@@ -557,10 +776,10 @@ int rd_mouse::_i_encode_macro( std::array< uint8_t, 256 >& macro_bytes, std::ist
 			
 			int distance = (uint8_t)std::stoi( value2, 0, 10);
 			if( distance <= 0x78 ){
-				macro_bytes[data_offset] = 0x02;
-				macro_bytes[data_offset+1] = distance;
-				macro_bytes[data_offset+2] = 0x00;
-				data_offset += 3;
+				action[0] = 0x02;
+				action[1] = distance;
+				action[2] = 0x00;
+				actions.push_back( action );
 			}
 		
 		// mouse movement up
@@ -568,10 +787,10 @@ int rd_mouse::_i_encode_macro( std::array< uint8_t, 256 >& macro_bytes, std::ist
 			
 			int distance = (uint8_t)(int8_t)(std::stoi( value2, 0, 10) * (-1));
 			if( distance >= 0x88 ){
-				macro_bytes[data_offset] = 0x02;
-				macro_bytes[data_offset+1] = 0x00;
-				macro_bytes[data_offset+2] = distance;
-				data_offset += 3;
+				action[0] = 0x02;
+				action[1] = 0x00;
+				action[2] = distance;
+				actions.push_back( action );
 			}
 			
 		// mouse movement down
@@ -579,10 +798,10 @@ int rd_mouse::_i_encode_macro( std::array< uint8_t, 256 >& macro_bytes, std::ist
 			
 			int distance = (uint8_t)std::stoi( value2, 0, 10);
 			if( distance <= 0x78 ){
-				macro_bytes[data_offset] = 0x02;
-				macro_bytes[data_offset+1] = 0x00;
-				macro_bytes[data_offset+2] = distance;
-				data_offset += 3;
+				action[0] = 0x02;
+				action[1] = 0x00;
+				action[2] = distance;
+				actions.push_back( action );
 			}
 		
 		// delay
@@ -590,16 +809,15 @@ int rd_mouse::_i_encode_macro( std::array< uint8_t, 256 >& macro_bytes, std::ist
 			
 			int duration = (uint8_t)stoi( value2, 0, 10);
 			if( duration >= 1 && duration <= 255 ){
-				macro_bytes[data_offset] = 0x06;
-				macro_bytes[data_offset+1] = duration;
-				data_offset += 3;
+				action[0] = 0x06;
+				action[1] = duration;
+				actions.push_back( action );
 			}
 			
 		}
 		
 	}
 	
-	return 0;
 }
 
 int rd_mouse::_i_decode_button_mapping( const std::array<uint8_t, 4>& bytes, std::string& mapping ){
@@ -774,159 +992,10 @@ int rd_mouse::_i_decode_button_mapping( const std::array<uint8_t, 4>& bytes, std
 
 int rd_mouse::_i_encode_button_mapping( const std::string& mapping, std::array<uint8_t, 4>& bytes ){
 	
-	// raw byte values
-	if( std::regex_match( mapping, std::regex("0x[0-9a-fA-F]{8}") ) ){
-
-		bytes[0] = std::stoi( mapping.substr(2, 2) , 0, 16 );
-		bytes[1] = std::stoi( mapping.substr(4, 2) , 0, 16 );
-		bytes[2] = std::stoi( mapping.substr(6, 2) , 0, 16 );
-		bytes[3] = std::stoi( mapping.substr(8, 2) , 0, 16 );
-
-	// is string in _c_keycodes? mousebuttons/special functions and media controls
-	} else if( _c_keycodes.find(mapping) != _c_keycodes.end() ){
-		
-		bytes[0] = _c_keycodes[mapping][0];
-		bytes[1] = _c_keycodes[mapping][1];
-		bytes[2] = _c_keycodes[mapping][2];
-		bytes[3] = _c_keycodes[mapping][3];
-	
-	// fire button (multiple keypresses)
-	} else if( mapping.find("fire") == 0 ){
-		
-		std::stringstream mapping_stream(mapping);
-		std::string value1 = "", value2 = "", value3 = "";
-		uint8_t keycode, repeats = 1, delay = 0;
-		
-		// the repeated value1 line is not a mistake, it skips the "fire:"
-		std::getline( mapping_stream, value1, ':' );
-		std::getline( mapping_stream, value1, ':' );
-		std::getline( mapping_stream, value2, ':' );
-		std::getline( mapping_stream, value3, ':' );
-		
-		if( value1 == "mouse_left" ){
-			keycode = 0x81;
-		} else if( value1 == "mouse_right" ){
-			keycode = 0x82;
-		} else if( value1 == "mouse_middle" ){
-			keycode = 0x84;
-		} else if( _c_keyboard_key_values.find(value1) != _c_keyboard_key_values.end() ){
-			keycode = _c_keyboard_key_values[value1];
-		} else{
-			return 1;
-		}
-		
-		repeats = (uint8_t)stoi(value2);
-		delay = (uint8_t)stoi(value3);
-		
-		// store values
-		bytes[0] = 0x99;
-		bytes[1] = keycode;
-		bytes[2] = repeats;
-		bytes[3] = delay;
-	
-	// snipe button (changes dpi while pressed)
-	} else if( mapping.find("snipe") == 0 ){
-		
-		try{
-			
-			int dpi_value = std::stoi( std::regex_replace( mapping, std::regex("snipe:"), "" ) );
-			uint8_t dpi_byte = _c_snipe_dpi_values.at( dpi_value );
-			
-			bytes[0] = 0x9a;
-			bytes[1] = 0x01;
-			bytes[2] = dpi_byte;
-			bytes[3] = dpi_byte;
-			
-		} catch( std::exception& f ){ // invalid mapping pattern or dpi
-			return 1;
-		}
+	// the lookup tables are built on the first call
+	static const rd_button_encoder encoder( _c_keycodes, _c_keyboard_modifier_values, _c_keyboard_key_values, _c_snipe_dpi_values );
 	
-	// macro (no repeats)
-	} else if( std::regex_match( mapping, std::regex("(macro[1-9]|macro1[0-5])") ) ){
-		
-		try{
-			
-			bytes[0] = 0x91;
-			bytes[1] = std::stoi( std::regex_replace( mapping, std::regex("macro"), "" ) ) - 1;
-			bytes[2] = 0x01;
-			bytes[3] = 0x00;
-			
-		} catch( std::exception& f ){
-			return 1;
-		}
-	
-	// macro (repeats)
-	} else if( std::regex_match( mapping, std::regex("(macro[1-9]|macro1[0-5]):\\d+") ) ){
-		
-		try{
-			
-			bytes[0] = 0x91;
-			bytes[1] = std::stoi( std::regex_replace( mapping, std::regex("(macro|:\\d+)"), "" ) ) - 1;
-			bytes[2] = std::stoi( std::regex_replace( mapping, std::regex("macro\\d+:"), "" ) );
-			bytes[3] = 0x00;
-			
-		} catch( std::exception& f ){
-			return 1;
-		}
-	
-	// macro (repeat until button is pressed again)
-	} else if( std::regex_match( mapping, std::regex("(macro[1-9]|macro1[0-5]):until") ) ){
-		
-		try{
-			
-			bytes[0] = 0x91;
-			bytes[1] = std::stoi( std::regex_replace( mapping, std::regex("(macro|:until)"), "" ) ) + 0x3f;
-			bytes[2] = 0xff;
-			bytes[3] = 0xff;
-			
-		} catch( std::exception& f ){
-			return 1;
-		}
-	
-	// macro (repeat while button id held down)
-	} else if( std::regex_match( mapping, std::regex("(macro[1-9]|macro1[0-5]):while") ) ){
-		
-		try{
-			
-			bytes[0] = 0x91;
-			bytes[1] = std::stoi( std::regex_replace( mapping, std::regex("(macro|:while)"), "" ) ) + 0x7f;
-			bytes[2] = 0xff;
-			bytes[3] = 0xff;
-			
-		} catch( std::exception& f ){
-			return 1;
-		}
-	
-	// string is not a key in _c_keycodes: keyboard key (+ modifiers) ?
-	} else{
-		
-		// search for modifiers and change values accordingly: ctrl, shift ...
-		uint8_t first_value = 0x90;
-		uint8_t modifier_value = 0x00;
-		for( auto i : _c_keyboard_modifier_values ){
-			if( mapping.find( i.first ) != std::string::npos ){
-				modifier_value += i.second;
-				first_value = 0x8f;
-			}
-		}
-		
-		// get key value and store everything
-		try{
-			
-			std::regex modifier_regex ("[a-z_]*\\+");
-			
-			// store values
-			bytes[0] = first_value;
-			bytes[1] = modifier_value;
-			bytes[2] = _c_keyboard_key_values[std::regex_replace( mapping, modifier_regex, "" )];
-			bytes[3] = 0x00;
-			
-		} catch( std::exception& f ){
-			return 1;
-		}
-	}
-	
-	return 0;
+	return encoder.encode( mapping, bytes );
 }
 
 int rd_mouse::_i_decode_dpi( const std::array<uint8_t, 2>& dpi_bytes, std::string& dpi_string ){
@@ -1026,3 +1095,58 @@ uint8_t rd_mouse::_i_encode_report_rate( const rd_mouse::rd_report_rate report_r
 
 	return return_value;
 }
+
+void rd_mouse::print_memory_rows( const memory_image& memory, std::ostream& output ){
+	
+	// one row per 16 consecutive addresses
+	output << std::hex << std::setfill('0');
+	for( auto byte = memory.begin(); byte != memory.end(); ){
+		
+		uint16_t address = byte->first;
+		std::vector< uint8_t > bytes;
+		while( byte != memory.end() && bytes.size() < 16 && byte->first == address + bytes.size() ){
+			bytes.push_back( byte->second );
+			byte++;
+		}
+		
+		output << std::setw(4) << address << " " << std::setw(2) << bytes.size() << ":";
+		for( uint8_t b : bytes )
+			output << " " << std::setw(2) << (int)b;
+		output << "\n";
+	}
+	output << std::dec << std::setfill(' ');
+}
+
+int rd_mouse::parse_memory_rows( std::istream& input, memory_image& memory, std::string& model ){
+	
+	memory.clear();
+	model = "";
+	
+	std::string line;
+	while( std::getline( input, line ) ){
+		
+		if( line.rfind( "# Model: ", 0 ) == 0 )
+			model = line.substr( 9 );
+		
+		if( line.empty() || line[0] == '#' )
+			continue;
+		
+		// address length: bytes
+		std::istringstream row( line );
+		unsigned int address = 0, length = 0, byte = 0;
+		char colon = 0;
+		if( !(row >> std::hex >> address >> length >> colon) || colon != ':' || address + length > 0x10000 )
+			return 1;
+		
+		for( unsigned int i = 0; i < length; i++ ){
+			if( !(row >> byte) || byte > 0xff )
+				return 1;
+			memory[address+i] = byte;
+		}
+		
+		if( row >> byte )
+			return 1;
+	}
+	
+	return 0;
+}
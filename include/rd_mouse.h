@@ -21,9 +21,16 @@
 #define RD_MOUSE
 
 #include <libusb.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <ctime>
 #include <exception>
 #include <fstream>
 #include <iomanip>
@@ -35,8 +42,32 @@
 #include <sstream>
 #include <string>
 #include <string>
+#include <thread>
 #include <utility>
 #include <variant>
+#include <vector>
+
+#include "button_encoder.h"
+#include "log.h"
+#include "stats.h"
+
+/* The models compiled in: a build with only some models defines
+ * RD_MODEL_SUBSET and RD_WITH_<MODEL> for each of them (make MODELS=...,
+ * cmake -D RD_MODELS=...). Without RD_MODEL_SUBSET all models are included.
+ */
+#ifndef RD_MODEL_SUBSET
+#define RD_WITH_M607
+#define RD_WITH_M709
+#define RD_WITH_M711
+#define RD_WITH_M715
+#define RD_WITH_M719
+#define RD_WITH_M721
+#define RD_WITH_M908
+#define RD_WITH_M913
+#define RD_WITH_M990
+#define RD_WITH_M990CHROMA
+#define RD_WITH_GENERIC
+#endif
 
 /* These declarations exist to make it possible for mouse_variant
  * to use these classes.
@@ -123,20 +154,48 @@ class rd_mouse{
 			r_1000Hz
 		};
 
-		/// This variant can hold an object for all available mice
+		/// Errors returned by the model operations, in addition to the libusb error codes
+		enum rd_error{
+			error_deadline_exceeded = -1000,
+			error_cancelled = -1001
+		};
+
+		/// This variant can hold an object for all mice compiled in (detection and variant_loop use only these)
 		typedef std::variant<
-			rd_mouse::monostate,
-			mouse_m607,
-			mouse_m709,
-			mouse_m711,
-			mouse_m715,
-			mouse_m719,
-			mouse_m721,
-			mouse_m908,
-			mouse_m913,
-			mouse_m990,
-			mouse_m990chroma,
-			mouse_generic // needs to be last to take the lowest priority during detection
+			rd_mouse::monostate
+			#ifdef RD_WITH_M607
+			, mouse_m607
+			#endif
+			#ifdef RD_WITH_M709
+			, mouse_m709
+			#endif
+			#ifdef RD_WITH_M711
+			, mouse_m711
+			#endif
+			#ifdef RD_WITH_M715
+			, mouse_m715
+			#endif
+			#ifdef RD_WITH_M719
+			, mouse_m719
+			#endif
+			#ifdef RD_WITH_M721
+			, mouse_m721
+			#endif
+			#ifdef RD_WITH_M908
+			, mouse_m908
+			#endif
+			#ifdef RD_WITH_M913
+			, mouse_m913
+			#endif
+			#ifdef RD_WITH_M990
+			, mouse_m990
+			#endif
+			#ifdef RD_WITH_M990CHROMA
+			, mouse_m990chroma
+			#endif
+			#ifdef RD_WITH_GENERIC
+			, mouse_generic // needs to be last to take the lowest priority during detection
+			#endif
 		> mouse_variant;
 		
 		/** \brief Detects supported mice
@@ -152,6 +211,12 @@ class rd_mouse{
 		 */
 		static mouse_variant detect( const std::string& mouse_name );
 		
+		/** \brief Finds all connected mice that have a specified name
+		 * \arg mouse_name finds mice with name = mouse_name
+		 * \return USB bus and device address of each mouse, for open_mouse_bus_device
+		 */
+		static std::vector< std::pair<uint8_t, uint8_t> > find( const std::string& mouse_name );
+		
 		/// Set whether to try to detach the kernel driver when opening the mouse
 		void set_detach_kernel_driver( bool detach_kernel_driver ){
 			_i_detach_kernel_driver = detach_kernel_driver;
@@ -159,6 +224,315 @@ class rd_mouse{
 		/// Get _i_detach_kernel_driver
 		bool get_detach_kernel_driver(){ return _i_detach_kernel_driver; }
 		
+		/** \brief Detach the kernel drivers (see set_detach_kernel_driver) and claim the interfaces of the open mouse
+		 * Called by open_mouse, the resident mode calls it again after release_interfaces.
+		 * \return 0 if successful or the interfaces are already claimed
+		 */
+		int claim_interfaces();
+		
+		/** \brief Release the interfaces and reattach the kernel drivers, the mouse stays open
+		 * The resident mode releases the mouse when it was idle, so the kernel driver gets it back.
+		 * \return 0 if successful
+		 */
+		int release_interfaces();
+		
+		/// Whether the mouse is open
+		bool is_open(){ return _i_handle != nullptr; }
+		
+		/// Claims and releases of the interfaces
+		struct claim_stats{
+			/// whether the interfaces are claimed now
+			bool claimed = false;
+			/// number of claim_interfaces and release_interfaces calls that claimed or released them
+			size_t claims = 0, releases = 0;
+		};
+		/// Get _i_claim_stats
+		claim_stats get_claim_stats(){ return _i_claim_stats; }
+		
+		/** \brief Take over the open mouse of another object of the same model
+		 * The handle, the detached kernel drivers and the claim stats are exchanged, this object must be closed.
+		 * The resident mode uses this to run each command with the default settings of a new object.
+		 */
+		void take_device( rd_mouse& other ){
+			std::swap( _i_handle, other._i_handle );
+			std::swap( _i_detached_driver_0, other._i_detached_driver_0 );
+			std::swap( _i_detached_driver_1, other._i_detached_driver_1 );
+			std::swap( _i_detached_driver_2, other._i_detached_driver_2 );
+			std::swap( _i_claim_stats, other._i_claim_stats );
+		}
+		
+		/** \brief Limit the configuration traffic to the given number of transfers per millisecond
+		 * This leaves bus time for the HID input reports while the settings are written.
+		 * \arg transfers_per_ms maximum transfer rate, 0 = unlimited
+		 */
+		void set_throttle_rate( double transfers_per_ms ){
+			_i_throttle_rate = transfers_per_ms;
+		}
+		/// Get _i_throttle_rate
+		double get_throttle_rate(){ return _i_throttle_rate; }
+		
+		/** \brief Limit the configuration traffic to the given fraction of time
+		 * After each transfer the transport stays idle long enough to keep the time spent in transfers below duty_cycle.
+		 * \arg duty_cycle maximum duty cycle (0 < duty_cycle <= 1), 1 = unlimited
+		 */
+		void set_throttle_duty_cycle( double duty_cycle ){
+			_i_throttle_duty_cycle = duty_cycle;
+		}
+		/// Get _i_throttle_duty_cycle
+		double get_throttle_duty_cycle(){ return _i_throttle_duty_cycle; }
+
+		/// Transfers counted during a dry run
+		struct dry_run_stats{
+			/// number of transfers that would have been sent
+			size_t transfers = 0;
+			/// number of payload bytes
+			size_t bytes = 0;
+		};
+
+		/** \brief Describe the following transfers instead of sending them to the mouse
+		 * Out transfers are printed as hex rows, in transfers return zeros. All transfers are counted.
+		 * \arg dry_run whether to enable the dry run
+		 * \arg output where to print the rows to, nullptr to only count them
+		 */
+		void set_dry_run( bool dry_run, std::ostream* output = nullptr ){
+			_i_dry_run = dry_run;
+			_i_dry_run_output = output;
+			_i_dry_run_stats = dry_run_stats();
+		}
+		/// Get _i_dry_run
+		bool get_dry_run(){ return _i_dry_run; }
+		/// Get _i_dry_run_stats
+		dry_run_stats get_dry_run_stats(){ return _i_dry_run_stats; }
+
+		/// Settings memory of a mouse (address → byte) in the address space of the 0xf2 read and 0xf3 write rows
+		typedef std::map< uint16_t, uint8_t > memory_image;
+		
+		/** \brief Simulate the settings memory of the mouse during a dry run (--simulate)
+		 * Write rows (0xf3) are stored in the memory, read rows (0xf2) are answered from it.
+		 * Bytes that were never written read zero.
+		 * \arg memory initial content, e.g. from parse_memory_rows
+		 */
+		void set_simulated_memory( const memory_image& memory ){
+			_i_simulated_memory = memory;
+			_i_simulate_memory = true;
+		}
+		/// Get _i_simulated_memory
+		const memory_image& get_simulated_memory(){ return _i_simulated_memory; }
+		
+		/// Print a memory image as hex rows (address length: bytes), at most 16 consecutive addresses per row
+		static void print_memory_rows( const memory_image& memory, std::ostream& output );
+		
+		/** \brief Read the hex rows written by print_memory_rows
+		 * Lines starting with # are skipped, "# Model: <name>" sets model.
+		 * \return 0 if successful, 1 if a row is invalid
+		 */
+		static int parse_memory_rows( std::istream& input, memory_image& memory, std::string& model );
+		
+		/// Transfers of the macro memory during the last read_and_print_settings
+		struct readback_stats{
+			/// number of transfers if no macro slot had been skipped
+			size_t transfers = 0;
+			/// number of transfers skipped because the first row of the macro slot was empty
+			size_t skipped = 0;
+		};
+		/// Get _i_readback_stats
+		readback_stats get_readback_stats(){ return _i_readback_stats; }
+		
+		/// Mean duration of the successful transfers sent to the mouse so far in µs, 0 if there were none
+		double get_transfer_latency(){
+			if( _i_latency_transfers == 0 )
+				return 0;
+			return std::chrono::duration<double, std::micro>( _i_latency_total ).count() / _i_latency_transfers;
+		}
+
+		/** \brief Estimate how long the given number of transfers takes, including the throttle
+		 * \arg transfers number of transfers
+		 * \arg latency duration of one transfer in µs
+		 * \return estimated duration in µs
+		 */
+		double estimate_transfer_time( size_t transfers, double latency ){
+			double per_transfer = latency;
+			if( _i_throttle_duty_cycle > 0 && _i_throttle_duty_cycle < 1 )
+				per_transfer = latency / _i_throttle_duty_cycle;
+			if( _i_throttle_rate > 0 )
+				per_transfer = std::max( per_transfer, 1000.0 / _i_throttle_rate );
+			return transfers * per_transfer;
+		}
+
+		/** \brief Record the following transfers for the write journal instead of sending them
+		 * In transfers return zeros while recording. The transfers are sent by commit_journal.
+		 * \arg path journal file, one per device
+		 * \see commit_journal
+		 */
+		void begin_journal( const std::string& path ){
+			_i_journal_path = path;
+			_i_journal_rows.clear();
+			_i_journal_recording = true;
+		}
+		
+		/** \brief Write the recorded transfers to the journal, send them and remove the journal when all were acknowledged
+		 * The journal is written atomically before the first transfer, the number of acknowledged transfers
+		 * is updated in the journal after each transfer. If the journal can't be written the transfers are sent without it.
+		 * \return 0 if successful, 1 if a transfer failed (the journal is kept), error_deadline_exceeded or error_cancelled
+		 * \see begin_journal, resume_journal
+		 */
+		int commit_journal();
+		
+		/** \brief Pause or resume the recording started by begin_journal, the transfers in between are sent
+		 * \see begin_journal
+		 */
+		void set_journal_recording( bool recording ){ _i_journal_recording = recording; }
+		
+		/** \brief The settings memory written by the recorded transfers (the 0xf3 write rows), later rows win
+		 * Used for the undo history before the journal is committed.
+		 * \see begin_journal
+		 */
+		memory_image get_journal_memory();
+		
+		/** \brief Finish an interrupted write: send the transfers of the journal that were not acknowledged
+		 * A session (0xf5 0x00) that was open at the first of these transfers is opened again before.
+		 * \arg path journal file, nothing is sent if it doesn't exist
+		 * \arg remaining set to the number of transfers that were not acknowledged
+		 * \return 0 if successful or there is no journal, 1 if the journal is invalid or a transfer failed,
+		 * error_deadline_exceeded or error_cancelled
+		 */
+		int resume_journal( const std::string& path, size_t& remaining );
+		
+		/// USB bus and port numbers of the open mouse, e.g. 1-4.2 (stays the same when the mouse is reconnected to the same port)
+		std::string get_port_path();
+		
+		/// usbfs device node of the open mouse, e.g. /dev/bus/usb/001/005 (removed when the mouse is disconnected), empty if no mouse is open
+		std::string get_device_node();
+		
+		/** \brief Identity of the open mouse, stays the same when it is reconnected
+		 * The serial number (iSerial string descriptor) if the mouse has one, e.g. 04d9:fc4d/serial:0123ABCD,
+		 * otherwise the port path, e.g. 04d9:fc4d/port:1-4.2. Empty if no mouse is open.
+		 * \see rd_device_store
+		 */
+		std::string get_device_id();
+		
+		/** \brief Set a deadline for the following operations
+		 * A pending transfer is cancelled when the deadline is reached, an open session on the mouse is closed
+		 * and the operations return error_deadline_exceeded without further transfers.
+		 */
+		void set_deadline( std::chrono::steady_clock::time_point deadline ){
+			_i_deadline = deadline;
+			_i_has_deadline = true;
+			_i_transfer_error = 0;
+		}
+		/// Remove the deadline
+		void clear_deadline(){
+			_i_has_deadline = false;
+			_i_transfer_error = 0;
+		}
+		
+		/** \brief Set a flag that cancels the following operations once it becomes true
+		 * The flag can be set from another thread or a signal handler, the operations then return error_cancelled.
+		 * It is checked before each transfer, a pending transfer is only cancelled if a deadline is set as well.
+		 * \arg token pointer to the flag, nullptr to remove
+		 */
+		void set_cancellation_token( const std::atomic<bool>* token ){
+			_i_cancellation_token = token;
+			_i_transfer_error = 0;
+		}
+		
+		/** \brief Measure the USB transfers as a phase of stats, the running phase is paused meanwhile
+		 * The other phases then only count the CPU-side work, see rd_stats::begin_transfer.
+		 * \arg stats statistics of the command, nullptr to stop measuring
+		 */
+		void set_stats( rd_stats* stats ){ _i_stats = stats; }
+		
+		/// Timing of the pointer reports received during a jitter measurement
+		struct jitter_stats{
+			/// number of received pointer reports
+			size_t reports = 0;
+			/// mean interval between reports in µs
+			double mean_interval = 0;
+			/// standard deviation of the interval in µs
+			double stddev_interval = 0;
+			/// longest interval in µs
+			double max_interval = 0;
+		};
+		
+		/** \brief Start recording the pointer reports (HID input) of the mouse
+		 * The reports are received asynchronously while other transfers are running.
+		 * \arg endpoint interrupt in endpoint of the pointer interface
+		 * \return 0 if successful
+		 * \see stop_jitter_measurement
+		 */
+		int start_jitter_measurement( uint8_t endpoint = 0x81 );
+		
+		/** \brief Stop recording the pointer reports and compute the report timing
+		 * \return 0 if successful
+		 * \see start_jitter_measurement
+		 */
+		int stop_jitter_measurement( jitter_stats& stats );
+		
+		/// Number of transfers kept by the flight recorder
+		static constexpr size_t flight_recorder_size = 256;
+		/// Number of payload bytes kept per transfer by the flight recorder
+		static constexpr size_t flight_recorder_payload = 64;
+		
+		/** \brief Set the file the flight recorder is written to
+		 * The last transfers are written to this file when a transfer fails.
+		 * \arg path file path, an empty string disables the automatic dumps
+		 */
+		static void set_flight_recorder_file( const std::string& path );
+		/** \brief Use the default file of the flight recorder
+		 * $XDG_RUNTIME_DIR/mouse_m908.rawdump, otherwise mouse_m908.rawdump in the cache directory of the user,
+		 * the automatic dumps are disabled if neither is known. The cache directory is created (mode 0700)
+		 * by the first dump.
+		 */
+		static void set_default_flight_recorder_file();
+		/// Get _i_flight_recorder_file
+		static std::string get_flight_recorder_file(){ return _i_flight_recorder_file; }
+		/// Get the number of flight recorder dumps written so far
+		static int get_flight_recorder_dumps(){ return _i_flight_recorder_dumps; }
+		
+		/** \brief Write the last transfers to the flight recorder file in the binary raw dump format
+		 * This function is async-signal-safe, it can be called from a signal handler.
+		 * \return 0 if successful
+		 * \see print_raw_dump
+		 */
+		static int dump_flight_recorder();
+		
+		/** \brief Read a binary raw dump and print the transfers as a hexdump
+		 * \arg input the raw dump
+		 * \arg output where to print to
+		 * \return 0 if successful, 1 if the input is not a valid raw dump
+		 * \see dump_flight_recorder
+		 */
+		static int print_raw_dump( std::istream& input, std::ostream& output );
+		
+		/// Result of compress_macro
+		struct macro_compression{
+			/// number of valid actions in the macro
+			size_t actions = 0;
+			/// number of actions encoded (one period if the macro was compressed)
+			size_t encoded_actions = 0;
+			/// number of actions that didn't fit into the slot
+			size_t dropped_actions = 0;
+			/// how often the encoded actions have to be played (button mapping macroN:repeats), 1 if not compressed
+			int repeats = 1;
+			/// whether the repeated period has the same timing as the macro
+			bool exact_timing = true;
+			/// delay added at the end of the macro if !exact_timing
+			int added_delay = 0;
+		};
+		
+		/** \brief Encode macro commands to macro bytecode, a macro that repeats one sequence of actions is encoded as one period
+		 * The period has to be repeated by the button mapping (macroN:repeats) to play the whole macro.
+		 * If the last period lacks its trailing delay it is only compressed if the macro doesn't fit into the slot,
+		 * the delay is then added to the end of the macro (exact_timing is false).
+		 * \arg macro_bytes holds the result
+		 * \arg input where the macro commands are read from
+		 * \arg offset skips offset bytes at the beginning
+		 * \arg compression holds the number of actions and repeats
+		 * \return 0 if successful
+		 * \see _i_encode_macro
+		 */
+		static int compress_macro( std::array< uint8_t, 256 >& macro_bytes, std::istream& input, const size_t offset, macro_compression& compression );
+		
 		/// Returns a reference to _c_lightmode_strings (lighmode names)
 		std::map< rd_mouse::rd_lightmode, std::string >& lightmode_strings(){ return _c_lightmode_strings; }
 		/// Returns a reference to _c_report_rate_strings (report rate names)
@@ -203,6 +577,207 @@ class rd_mouse{
 		bool _i_detached_driver_1 = false;
 		/// set by open_mouse for close_mouse
 		bool _i_detached_driver_2 = false;
+		/// number of interfaces claimed by claim_interfaces (0 and 1 or 0, 1 and 2)
+		int _i_interface_count = 3;
+		/// whether the interfaces are claimed and how often, see claim_interfaces
+		claim_stats _i_claim_stats;
+		
+		//transport
+		/// maximum transfers per ms, 0 = unlimited
+		double _i_throttle_rate = 0;
+		/// maximum fraction of time spent in transfers, 1 = unlimited
+		double _i_throttle_duty_cycle = 1;
+		/// earliest time for the next transfer, set by the throttle
+		std::chrono::steady_clock::time_point _i_throttle_next;
+		/// number of successful transfers in _i_latency_total
+		size_t _i_latency_transfers = 0;
+		/// total duration of the successful transfers
+		std::chrono::steady_clock::duration _i_latency_total{ 0 };
+		/// whether transfers are only described, see set_dry_run
+		bool _i_dry_run = false;
+		/// where the dry run rows are printed to, nullptr if not printed
+		std::ostream* _i_dry_run_output = nullptr;
+		/// transfers counted during the dry run
+		dry_run_stats _i_dry_run_stats;
+		/// whether the dry run answers read rows from _i_simulated_memory, see set_simulated_memory
+		bool _i_simulate_memory = false;
+		/// simulated settings memory
+		memory_image _i_simulated_memory;
+		/// the last read row (0xf2) sent to the simulated memory, answered by the next in transfer
+		std::array< uint8_t, 8 > _i_simulated_request = {};
+		/// transfers of the last macro readback, see _i_read_macro_rows
+		readback_stats _i_readback_stats;
+		/// whether _i_deadline is used
+		bool _i_has_deadline = false;
+		/// deadline for all transfers
+		std::chrono::steady_clock::time_point _i_deadline;
+		/// cancels all transfers when true, nullptr if unused
+		const std::atomic<bool>* _i_cancellation_token = nullptr;
+		/// statistics the transfers are measured in, nullptr if unused
+		rd_stats* _i_stats = nullptr;
+		/// buffer of the asynchronous control transfers
+		std::vector< unsigned char > _i_transfer_buffer;
+		/// set when the transfers were aborted: error_deadline_exceeded or error_cancelled, 0 otherwise
+		int _i_transfer_error = 0;
+		/// one transfer of the write journal
+		struct journal_row{
+			/// transfer_control or transfer_interrupt
+			uint8_t type = 0;
+			/// bmRequestType for control transfers, endpoint for interrupt transfers
+			uint8_t request_type = 0;
+			/// bRequest (control transfers only)
+			uint8_t request = 0;
+			/// wValue, wIndex and wLength (wLength is the buffer size for interrupt transfers)
+			uint16_t value = 0, index = 0, length = 0;
+			/// sent data for out transfers, empty for in transfers
+			std::vector< uint8_t > data;
+		};
+		/// whether transfers are recorded for the journal, see begin_journal
+		bool _i_journal_recording = false;
+		/// journal file
+		std::string _i_journal_path;
+		/// recorded transfers
+		std::vector< journal_row > _i_journal_rows;
+		/// whether a session was opened (0xf5 0x00) but not yet closed (0xf5 0x01)
+		bool _i_session_open = false;
+		/// report id, wValue and wIndex of the packet that opened the session
+		uint8_t _i_session_report_id = 0;
+		uint16_t _i_session_value = 0, _i_session_index = 0;
+		/// pending transfer for the pointer reports, nullptr if no jitter measurement is running
+		libusb_transfer* _i_jitter_transfer = nullptr;
+		/// buffer for _i_jitter_transfer
+		uint8_t _i_jitter_buffer[64];
+		/// set by stop_jitter_measurement to prevent resubmission
+		bool _i_jitter_stopping = false;
+		/// whether _i_jitter_transfer is submitted
+		bool _i_jitter_pending = false;
+		/// arrival times of the pointer reports
+		std::vector< std::chrono::steady_clock::time_point > _i_jitter_timestamps;
+		
+		/// Transfer types in the binary raw dump
+		enum rd_transfer_type{
+			transfer_control = 0,
+			transfer_interrupt = 1
+		};
+		
+		/// One transfer kept by the flight recorder
+		struct transfer_record{
+			/// start and end of the transfer, steady clock in ns
+			uint64_t start = 0, end = 0;
+			/// return value of the transfer (bytes transferred or error code)
+			int32_t result = 0;
+			/// transfer_control or transfer_interrupt
+			uint8_t type = 0;
+			/// bmRequestType for control transfers, endpoint for interrupt transfers
+			uint8_t request_type = 0;
+			/// bRequest (control transfers only)
+			uint8_t request = 0;
+			/// number of valid bytes in payload
+			uint8_t captured = 0;
+			/// wValue, wIndex and wLength (wLength is the buffer size for interrupt transfers)
+			uint16_t value = 0, index = 0, length = 0;
+			/// first bytes of the data sent or received
+			uint8_t payload[flight_recorder_payload] = {};
+			/// number of the transfer + 1 once the record is complete, 0 while it is written
+			std::atomic<uint64_t> sequence{ 0 };
+		};
+		
+		/// ring buffer with the last transfers, shared by all mice so the signal handlers can access it
+		static transfer_record _i_flight_recorder[flight_recorder_size];
+		/// number of records claimed since start, the next record is written to count % flight_recorder_size
+		static std::atomic<uint64_t> _i_flight_recorder_count;
+		/// file for dump_flight_recorder, fixed size to avoid allocations in signal handlers
+		static char _i_flight_recorder_file[4096];
+		/// length of the directory of _i_flight_recorder_file that dump_flight_recorder creates, 0 for none
+		static size_t _i_flight_recorder_directory;
+		/// number of dumps written so far
+		static std::atomic<int> _i_flight_recorder_dumps;
+		/// number of failed transfers since the mouse was opened, the flight recorder is dumped on the first one
+		int _i_failed_transfers = 0;
+		
+		/** \brief Add a transfer to the flight recorder and dump it if the transfer failed
+		 * \arg data the payload (sent data for out transfers, received data for in transfers)
+		 * \arg captured number of valid bytes in data
+		 */
+		void _i_record_transfer( uint8_t type, uint8_t request_type, uint8_t request, uint16_t value, uint16_t index,
+			uint16_t length, const unsigned char* data, int captured, int result,
+			std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end );
+		
+		/** \brief Send a control transfer to the mouse, all models use this instead of libusb_control_transfer
+		 * The transfer is delayed as required by the throttle.
+		 * \return the return value of libusb_control_transfer
+		 */
+		int _i_control_transfer( uint8_t request_type, uint8_t request, uint16_t value, uint16_t index,
+			unsigned char* data, uint16_t length, unsigned int timeout );
+		
+		/** \brief Receive an interrupt transfer from the mouse, all models use this instead of libusb_interrupt_transfer
+		 * The transfer is delayed as required by the throttle.
+		 * \return the return value of libusb_interrupt_transfer
+		 */
+		int _i_interrupt_transfer( unsigned char endpoint, unsigned char* data, int length,
+			int* transferred, unsigned int timeout );
+		
+		/** \brief Read the rows of _c_data_read_2 (64 byte control transfers), the macro slots are sparse
+		 * The macro slots have 4 rows each, starting at first_macro_row. If the first row of a slot holds no
+		 * action the other rows of the slot are not read and stay zero in buffer_in. Updates _i_readback_stats.
+		 * \arg rows the request rows
+		 * \arg buffer_in holds the responses, has to be zero initialized
+		 * \arg row_count number of rows
+		 * \arg first_macro_row first row of the first macro slot
+		 */
+		void _i_read_macro_rows( uint8_t (*rows)[64], uint8_t (*buffer_in)[64], int row_count, int first_macro_row );
+		
+		/** \brief Check the deadline and the cancellation token
+		 * \return 0, error_deadline_exceeded or error_cancelled
+		 */
+		int _i_check_abort();
+		
+		/** \brief Abort the current operation: close an open session and remember the error
+		 * \return error
+		 */
+		int _i_abort( int error );
+		
+		/// Close an open session (0xf5 0x01) without checking the deadline
+		void _i_close_session();
+		
+		/** \brief Record a transfer for the journal instead of sending it
+		 * \arg type transfer_control or transfer_interrupt
+		 * \arg request_type bmRequestType for control transfers, endpoint for interrupt transfers
+		 * \return length
+		 */
+		int _i_journal_record( uint8_t type, uint8_t request_type, uint8_t request, uint16_t value, uint16_t index,
+			unsigned char* data, int length );
+		
+		/** \brief Send the journal rows from first on, the journal file is updated after each acknowledged row
+		 * \arg fd journal file, -1 to send without journal
+		 * \return 0 if all rows were acknowledged, 1 if a transfer failed, error_deadline_exceeded or error_cancelled
+		 */
+		int _i_journal_send( int fd, size_t first );
+		
+		/** \brief Submit an asynchronous transfer and handle events until it completes or is cancelled
+		 * This is used instead of the synchronous libusb functions when a deadline is set.
+		 * \return LIBUSB_SUCCESS, a libusb error code, error_deadline_exceeded or error_cancelled
+		 */
+		int _i_run_transfer( libusb_transfer* transfer );
+		
+		/// libusb callback for _i_run_transfer
+		static void LIBUSB_CALL _i_transfer_callback( libusb_transfer* transfer );
+		
+		/** \brief Count and print a transfer instead of sending it, used in dry runs
+		 * \arg type transfer_control or transfer_interrupt
+		 * \arg request_type bmRequestType for control transfers, endpoint for interrupt transfers
+		 * \return length
+		 */
+		int _i_dry_run_transfer( uint8_t type, uint8_t request_type, uint16_t value, unsigned char* data, int length );
+
+		/// Wait until the throttle allows the next transfer
+		void _i_throttle_wait();
+		
+		/// Update the throttle after a transfer
+		void _i_throttle_update( std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end );
+		
+		/// libusb callback for _i_jitter_transfer
+		static void LIBUSB_CALL _i_jitter_callback( libusb_transfer* transfer );
 		
 		/** \brief Init libusb and open the mouse by its USB VID and PID
 		 * \return 0 if successful
@@ -237,6 +812,21 @@ class rd_mouse{
 		 */
 		static int _i_encode_macro( std::array< uint8_t, 256 >& macro_bytes, std::istream& input, const size_t offset );
 		
+		/** \brief Encode macro commands to a list of actions (3 bytes each), invalid commands are skipped
+		 * \arg actions holds the result
+		 * \arg input where the macro commands are read from
+		 * \arg max_actions stops reading after this many actions
+		 */
+		static void _i_encode_macro_actions( std::vector< std::array<uint8_t, 3> >& actions, std::istream& input, const size_t max_actions );
+		
+		/** \brief Write actions to macro bytecode, actions that don't fit into the slot are dropped
+		 * \arg macro_bytes holds the result
+		 * \arg actions the encoded actions
+		 * \arg offset skips offset bytes at the beginning
+		 * \return number of actions written
+		 */
+		static size_t _i_write_macro_actions( std::array< uint8_t, 256 >& macro_bytes, const std::vector< std::array<uint8_t, 3> >& actions, const size_t offset );
+		
 		/** \brief Decodes the bytes describing a button mapping
 		 * \arg bytes the 4 bytes descriping the mapping
 		 * \arg mapping string to hold the result
@@ -284,14 +874,36 @@ class rd_mouse{
 #endif
 
 // include header files for the individual models
+#ifdef RD_WITH_M607
 #include "m607/mouse_m607.h"
+#endif
+#ifdef RD_WITH_M709
 #include "m709/mouse_m709.h"
+#endif
+#ifdef RD_WITH_M711
 #include "m711/mouse_m711.h"
+#endif
+#ifdef RD_WITH_M715
 #include "m715/mouse_m715.h"
+#endif
+#ifdef RD_WITH_M719
 #include "m719/mouse_m719.h"
+#endif
+#ifdef RD_WITH_M721
 #include "m721/mouse_m721.h"
+#endif
+#ifdef RD_WITH_M908
 #include "m908/mouse_m908.h"
+#endif
+#ifdef RD_WITH_M913
 #include "m913/mouse_m913.h"
+#endif
+#ifdef RD_WITH_M990
 #include "m990/mouse_m990.h"
+#endif
+#ifdef RD_WITH_M990CHROMA
 #include "m990chroma/mouse_m990chroma.h"
+#endif
+#ifdef RD_WITH_GENERIC
 #include "generic/mouse_generic.h"
+#endif
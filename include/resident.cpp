@@ -0,0 +1,341 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+
+#include "resident.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+static const char resident_magic[4] = { 'R', 'D', 'R', 'S' };
+static const size_t resident_header_size = 8;
+/// limit for the arguments of a request
+static const size_t resident_max_arguments = 65536;
+
+// store value as little endian
+static void resident_put( uint8_t* bytes, uint64_t value, int size ){
+	for( int i = 0; i < size; i++ )
+		bytes[i] = (value >> (8*i)) & 0xff;
+}
+
+// read little endian value
+static uint64_t resident_get( const uint8_t* bytes, int size ){
+	uint64_t value = 0;
+	for( int i = 0; i < size; i++ )
+		value |= (uint64_t)bytes[i] << (8*i);
+	return value;
+}
+
+// read exactly size bytes, false at the end of the stream or on errors
+static bool resident_read( int fd, uint8_t* bytes, size_t size ){
+	while( size > 0 ){
+		ssize_t length = read( fd, bytes, size );
+		if( length < 0 && errno == EINTR )
+			continue;
+		if( length <= 0 )
+			return false;
+		bytes += length;
+		size -= length;
+	}
+	return true;
+}
+
+// write all bytes without SIGPIPE
+static bool resident_write( int fd, const uint8_t* bytes, size_t size ){
+	while( size > 0 ){
+		ssize_t length = send( fd, bytes, size, MSG_NOSIGNAL );
+		if( length < 0 && errno == EINTR )
+			continue;
+		if( length <= 0 )
+			return false;
+		bytes += length;
+		size -= length;
+	}
+	return true;
+}
+
+// the address of the socket, false if the path is empty or too long
+static bool resident_address( const std::string& path, sockaddr_un& address ){
+	
+	std::memset( &address, 0, sizeof(address) );
+	address.sun_family = AF_UNIX;
+	if( path.empty() || path.size() >= sizeof(address.sun_path) )
+		return false;
+	
+	std::copy( path.begin(), path.end(), address.sun_path );
+	return true;
+}
+
+// whether the other end of a connected socket runs as the same user
+static bool resident_same_user( int fd ){
+#ifdef SO_PEERCRED
+	ucred credentials;
+	socklen_t credentials_size = sizeof(credentials);
+	return getsockopt( fd, SOL_SOCKET, SO_PEERCRED, &credentials, &credentials_size ) == 0 && credentials.uid == getuid();
+#else
+	uid_t uid;
+	gid_t gid;
+	return getpeereid( fd, &uid, &gid ) == 0 && uid == getuid();
+#endif
+}
+
+// a unix stream socket that is not inherited by other programs
+static int resident_socket(){
+	
+	int fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+	if( fd >= 0 )
+		fcntl( fd, F_SETFD, FD_CLOEXEC );
+	return fd;
+}
+
+std::string rd_resident::socket_path( bool create ){
+	
+	if( getenv( "MOUSE_M908_SOCKET" ) != nullptr && getenv( "MOUSE_M908_SOCKET" )[0] != '\0' )
+		return getenv( "MOUSE_M908_SOCKET" );
+	if( getenv( "XDG_RUNTIME_DIR" ) != nullptr && getenv( "XDG_RUNTIME_DIR" )[0] != '\0' )
+		return std::string( getenv( "XDG_RUNTIME_DIR" ) ) + "/mouse_m908.socket";
+	
+	// /tmp is shared: the socket is kept in a directory that only the user can use, a directory created by someone else is not used
+	std::string directory = "/tmp/mouse_m908-" + std::to_string( getuid() );
+	if( create )
+		mkdir( directory.c_str(), 0700 );
+	struct stat status;
+	if( lstat( directory.c_str(), &status ) != 0 || !S_ISDIR( status.st_mode ) || status.st_uid != getuid() || (status.st_mode & 0777) != 0700 )
+		return "";
+	return directory + "/mouse_m908.socket";
+}
+
+int rd_resident::listen( const std::string& path ){
+	
+	sockaddr_un address;
+	if( !resident_address( path, address ) )
+		return -1;
+	
+	int fd = resident_socket();
+	if( fd < 0 )
+		return -1;
+	
+	// a socket that accepts connections belongs to another resident mode, otherwise it is left over
+	if( connect( fd, (sockaddr*)&address, sizeof(address) ) == 0 ){
+		close( fd );
+		return -1;
+	}
+	close( fd );
+	unlink( path.c_str() );
+	
+	fd = resident_socket();
+	if( fd < 0 )
+		return -1;
+	
+	// only the user can connect
+	mode_t mask = umask( 0077 );
+	int result = bind( fd, (sockaddr*)&address, sizeof(address) );
+	umask( mask );
+	
+	if( result != 0 || ::listen( fd, 16 ) != 0 ){
+		close( fd );
+		return -1;
+	}
+	
+	return fd;
+}
+
+int rd_resident::serve( int socket, const std::function< int( const std::vector< std::string >& ) >& perform ){
+	
+	int connection = accept( socket, nullptr, nullptr );
+	if( connection < 0 )
+		return 1;
+	fcntl( connection, F_SETFD, FD_CLOEXEC );
+	
+	// connections of other users are refused (the socket permissions already prevent them where supported)
+	if( !resident_same_user( connection ) ){
+		close( connection );
+		return 1;
+	}
+	
+	// a client that connects but doesn't send its request doesn't block the resident mode
+	timeval timeout = { 1, 0 };
+	setsockopt( connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout) );
+	
+	// header and file descriptors
+	uint8_t header[resident_header_size];
+	alignas(cmsghdr) char control[CMSG_SPACE( 3 * sizeof(int) )];
+	iovec vector = { header, sizeof(header) };
+	msghdr message = {};
+	message.msg_iov = &vector;
+	message.msg_iovlen = 1;
+	message.msg_control = control;
+	message.msg_controllen = sizeof(control);
+	
+	ssize_t length;
+	do{
+		length = recvmsg( connection, &message, 0 );
+	} while( length < 0 && errno == EINTR );
+	
+	std::vector< int > fds;
+	for( cmsghdr* c = length > 0 ? CMSG_FIRSTHDR( &message ) : nullptr; c != nullptr; c = CMSG_NXTHDR( &message, c ) ){
+		if( c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_RIGHTS ){
+			size_t count = (c->cmsg_len - CMSG_LEN( 0 )) / sizeof(int);
+			for( size_t i = 0; i < count; i++ ){
+				int fd;
+				std::memcpy( &fd, CMSG_DATA( c ) + i * sizeof(int), sizeof(int) );
+				fds.push_back( fd );
+			}
+		}
+	}
+	
+	// rest of the header and the arguments
+	std::vector< uint8_t > arguments;
+	bool valid = length > 0 && fds.size() == 3 &&
+		resident_read( connection, header + length, sizeof(header) - length ) &&
+		std::equal( std::begin(resident_magic), std::end(resident_magic), header ) &&
+		resident_get( header+4, 4 ) <= resident_max_arguments;
+	if( valid ){
+		arguments.resize( resident_get( header+4, 4 ) );
+		valid = resident_read( connection, arguments.data(), arguments.size() ) && (arguments.empty() || arguments.back() == 0);
+	}
+	
+	if( !valid ){
+		for( int fd : fds )
+			close( fd );
+		close( connection );
+		return 1;
+	}
+	
+	std::vector< std::string > command;
+	for( auto begin = arguments.begin(); begin != arguments.end(); ){
+		auto end = std::find( begin, arguments.end(), 0 );
+		command.emplace_back( begin, end );
+		begin = end + 1;
+	}
+	
+	// run the command in the directory of the client with its stdout and stderr
+	std::cout.flush();
+	std::cerr.flush();
+	int saved_directory = open( ".", O_RDONLY );
+	int saved_output = dup( STDOUT_FILENO );
+	int saved_error = dup( STDERR_FILENO );
+	
+	if( fchdir( fds[0] ) != 0 )
+		std::cerr << "Warning: Couldn't change to the directory of the command\n";
+	dup2( fds[1], STDOUT_FILENO );
+	dup2( fds[2], STDERR_FILENO );
+	
+	int status = perform( command );
+	
+	// a client that closed its output (e.g. piped to head) leaves the streams in a failed state
+	std::cout.flush();
+	std::cerr.flush();
+	std::cout.clear();
+	std::cerr.clear();
+	
+	dup2( saved_output, STDOUT_FILENO );
+	dup2( saved_error, STDERR_FILENO );
+	if( saved_directory >= 0 && fchdir( saved_directory ) != 0 )
+		std::cerr << "Warning: Couldn't change back to the directory of the resident mode\n";
+	
+	for( int fd : { saved_directory, saved_output, saved_error, fds[0], fds[1], fds[2] } ){
+		if( fd >= 0 )
+			close( fd );
+	}
+	
+	uint8_t reply[4];
+	resident_put( reply, (uint32_t)status, 4 );
+	resident_write( connection, reply, sizeof(reply) );
+	close( connection );
+	
+	return 0;
+}
+
+int rd_resident::forward( const std::string& path, const std::vector< std::string >& arguments, int& status ){
+	
+	sockaddr_un address;
+	if( !resident_address( path, address ) )
+		return 1;
+	
+	int fd = resident_socket();
+	if( fd < 0 )
+		return 1;
+	// the working directory, stdout and stderr are only passed to a resident mode of the same user
+	if( connect( fd, (sockaddr*)&address, sizeof(address) ) != 0 || !resident_same_user( fd ) ){
+		close( fd );
+		return 1;
+	}
+	
+	int directory = open( ".", O_RDONLY );
+	if( directory < 0 ){
+		close( fd );
+		return 1;
+	}
+	
+	std::vector< uint8_t > request( resident_header_size );
+	std::copy( std::begin(resident_magic), std::end(resident_magic), request.begin() );
+	for( auto& argument : arguments ){
+		request.insert( request.end(), argument.begin(), argument.end() );
+		request.push_back( 0 );
+	}
+	resident_put( request.data()+4, request.size() - resident_header_size, 4 );
+	
+	// the header with the file descriptors, then the rest
+	int fds[3] = { directory, STDOUT_FILENO, STDERR_FILENO };
+	alignas(cmsghdr) char control[CMSG_SPACE( sizeof(fds) )] = {};
+	iovec vector = { request.data(), resident_header_size };
+	msghdr message = {};
+	message.msg_iov = &vector;
+	message.msg_iovlen = 1;
+	message.msg_control = control;
+	message.msg_controllen = sizeof(control);
+	cmsghdr* c = CMSG_FIRSTHDR( &message );
+	c->cmsg_level = SOL_SOCKET;
+	c->cmsg_type = SCM_RIGHTS;
+	c->cmsg_len = CMSG_LEN( sizeof(fds) );
+	std::memcpy( CMSG_DATA( c ), fds, sizeof(fds) );
+	
+	ssize_t length;
+	do{
+		length = sendmsg( fd, &message, MSG_NOSIGNAL );
+	} while( length < 0 && errno == EINTR );
+	close( directory );
+	
+	// no reply: the resident mode refused the connection or ended before the command finished
+	uint8_t reply[4];
+	bool performed = length > 0 &&
+		resident_write( fd, request.data() + length, request.size() - length ) &&
+		resident_read( fd, reply, sizeof(reply) );
+	close( fd );
+	
+	if( !performed )
+		return 1;
+	
+	status = (int32_t)resident_get( reply, 4 );
+	return 0;
+}
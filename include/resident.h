@@ -0,0 +1,81 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+
+#ifndef RD_RESIDENT
+#define RD_RESIDENT
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * The control socket of the resident mode: a command line started while
+ * the resident mode runs sends its arguments over the socket instead of
+ * opening the mouse itself. The command runs in the resident process, in
+ * the working directory of the client and with the client's stdout and
+ * stderr, so files and output are the same as without the resident mode.
+ * 
+ * Protocol on a unix stream socket, all values little endian:
+ * 
+ * request (client to resident mode):
+ *   0  char[4]   magic "RDRS"
+ *   4  uint32    size of the arguments
+ *   8  char[]    arguments, each terminated by a zero byte
+ * The first message carries three file descriptors (SCM_RIGHTS): the
+ * working directory, stdout and stderr of the client.
+ * 
+ * reply (resident mode to client):
+ *   0  int32     exit status of the command
+ * 
+ * The socket only accepts connections of the same user, and the client
+ * only talks to a resident mode of the same user.
+ */
+class rd_resident{
+	
+	public:
+		
+		/** \brief Socket path: $MOUSE_M908_SOCKET, $XDG_RUNTIME_DIR/mouse_m908.socket or /tmp/mouse_m908-<uid>/mouse_m908.socket
+		 * The path is empty if the directory in /tmp is missing or isn't a directory of the user with mode 0700.
+		 * \arg create create the directory in /tmp with mode 0700 (the resident mode), clients only look it up
+		 */
+		static std::string socket_path( bool create = false );
+		
+		/** \brief Create the socket of the resident mode
+		 * \return the listening socket, -1 if it couldn't be created or another resident mode is running
+		 */
+		static int listen( const std::string& path );
+		
+		/** \brief Accept a connection and perform its command
+		 * The command runs with the working directory, stdout and stderr of the client, they are restored afterwards.
+		 * \arg socket listening socket from listen()
+		 * \arg perform performs the arguments (without the program name), returns the exit status
+		 * \return 0 if a command was performed, 1 if the connection was invalid
+		 */
+		static int serve( int socket, const std::function< int( const std::vector< std::string >& ) >& perform );
+		
+		/** \brief Send a command to a running resident mode and wait for it
+		 * \arg arguments the arguments without the program name
+		 * \arg status set to the exit status of the command
+		 * \return 0 if the command was performed by the resident mode, 1 if there is none
+		 */
+		static int forward( const std::string& path, const std::vector< std::string >& arguments, int& status );
+};
+
+#endif
@@ -0,0 +1,240 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+
+#include "stats.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+rd_stats::rd_stats( rd_stats_mode mode ) : _i_mode( mode ){
+	
+	for( int i = 0; i < counters; i++ )
+		_i_fd[i] = -1;
+	
+	if( _i_mode != stats_hw )
+		return;
+	
+	#ifdef __linux__
+	
+	// cycles, instructions, branch misses, cache misses
+	const uint64_t configs[counters] = {
+		PERF_COUNT_HW_CPU_CYCLES,
+		PERF_COUNT_HW_INSTRUCTIONS,
+		PERF_COUNT_HW_BRANCH_MISSES,
+		PERF_COUNT_HW_CACHE_MISSES
+	};
+	
+	int opened = 0;
+	for( int i = 0; i < counters; i++ ){
+		
+		perf_event_attr attr;
+		std::memset( &attr, 0, sizeof(attr) );
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = configs[i];
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		
+		// this process, any cpu
+		_i_fd[i] = syscall( SYS_perf_event_open, &attr, 0, -1, -1, 0 );
+		if( _i_fd[i] >= 0 )
+			opened++;
+		else if( _i_error.empty() ){
+			_i_error = std::string( "perf_event_open: " ) + std::strerror( errno );
+			if( errno == EACCES || errno == EPERM )
+				_i_error += ", check /proc/sys/kernel/perf_event_paranoid";
+		}
+	}
+	
+	// measure at least the time
+	if( opened == 0 )
+		_i_mode = stats_time;
+	
+	#else
+	
+	_i_error = "hardware counters are only supported on Linux";
+	_i_mode = stats_time;
+	
+	#endif
+}
+
+rd_stats::~rd_stats(){
+	
+	#ifdef __linux__
+	for( int i = 0; i < counters; i++ ){
+		if( _i_fd[i] >= 0 )
+			close( _i_fd[i] );
+	}
+	#endif
+}
+
+void rd_stats::begin( const std::string& phase ){
+	
+	if( _i_mode == stats_off )
+		return;
+	
+	if( _i_current >= 0 )
+		end();
+	
+	_i_current = _i_phase( phase );
+	_i_start_counting();
+}
+
+void rd_stats::end(){
+	
+	if( _i_mode == stats_off || _i_current < 0 )
+		return;
+	
+	_i_stop_counting( true );
+	_i_current = -1;
+}
+
+void rd_stats::begin_transfer(){
+	
+	if( _i_mode == stats_off )
+		return;
+	
+	// the running phase continues after the transfer, it isn't counted as a run twice
+	_i_paused = _i_current;
+	if( _i_current >= 0 )
+		_i_stop_counting( false );
+	
+	_i_current = _i_phase( "transfers" );
+	_i_start_counting();
+}
+
+void rd_stats::end_transfer(){
+	
+	if( _i_mode == stats_off || _i_current < 0 )
+		return;
+	
+	_i_stop_counting( true );
+	_i_current = _i_paused;
+	_i_paused = -1;
+	
+	if( _i_current >= 0 )
+		_i_start_counting();
+}
+
+int rd_stats::_i_phase( const std::string& name ){
+	
+	for( size_t i = 0; i < _i_phases.size(); i++ ){
+		if( _i_phases[i].name == name )
+			return i;
+	}
+	
+	_i_phases.emplace_back();
+	_i_phases.back().name = name;
+	return _i_phases.size() - 1;
+}
+
+void rd_stats::_i_start_counting(){
+	
+	#ifdef __linux__
+	for( int i = 0; i < counters; i++ ){
+		if( _i_fd[i] >= 0 ){
+			ioctl( _i_fd[i], PERF_EVENT_IOC_RESET, 0 );
+			ioctl( _i_fd[i], PERF_EVENT_IOC_ENABLE, 0 );
+		}
+	}
+	#endif
+	
+	_i_start = std::chrono::steady_clock::now();
+}
+
+void rd_stats::_i_stop_counting( bool run ){
+	
+	auto end = std::chrono::steady_clock::now();
+	phase_stats& phase = _i_phases[_i_current];
+	
+	#ifdef __linux__
+	for( int i = 0; i < counters; i++ ){
+		if( _i_fd[i] >= 0 ){
+			ioctl( _i_fd[i], PERF_EVENT_IOC_DISABLE, 0 );
+			
+			uint64_t value = 0;
+			if( read( _i_fd[i], &value, sizeof(value) ) == sizeof(value) )
+				phase.values[i] += value;
+		}
+	}
+	#endif
+	
+	if( run )
+		phase.runs++;
+	phase.time += std::chrono::duration<double, std::milli>( end - _i_start ).count();
+}
+
+void rd_stats::print( std::ostream& output ){
+	
+	if( _i_mode == stats_off )
+		return;
+	
+	end();
+	
+	if( !_i_error.empty() && _i_mode == stats_hw )
+		output << "Some hardware counters are unavailable (" << _i_error << ")\n";
+	else if( !_i_error.empty() )
+		output << "Hardware counters unavailable (" << _i_error << ")\n";
+	
+	if( _i_phases.empty() )
+		return;
+	
+	const char* names[counters] = { "cycles", "instructions", "branch-misses", "cache-misses" };
+	
+	// header
+	output << std::left << std::setw(16) << "phase" << std::right << std::setw(6) << "runs" << std::setw(12) << "time [ms]";
+	if( _i_mode == stats_hw ){
+		for( int i = 0; i < counters; i++ )
+			output << std::setw(15) << names[i];
+		output << std::setw(7) << "IPC";
+	}
+	output << "\n";
+	
+	for( auto& phase : _i_phases ){
+		
+		output << std::left << std::setw(16) << phase.name << std::right << std::setw(6) << phase.runs;
+		output << std::fixed << std::setprecision(3) << std::setw(12) << phase.time;
+		
+		if( _i_mode == stats_hw ){
+			for( int i = 0; i < counters; i++ ){
+				if( _i_fd[i] >= 0 )
+					output << std::setw(15) << phase.values[i];
+				else
+					output << std::setw(15) << "n/a";
+			}
+			
+			// instructions per cycle
+			if( _i_fd[0] >= 0 && _i_fd[1] >= 0 && phase.values[0] > 0 )
+				output << std::setprecision(2) << std::setw(7) << (double)phase.values[1] / phase.values[0];
+			else
+				output << std::setw(7) << "n/a";
+		}
+		
+		output << std::defaultfloat << std::setprecision(6) << "\n";
+	}
+}
@@ -0,0 +1,123 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+
+#ifndef RD_STATS
+#define RD_STATS
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * Per-phase statistics for the CPU-side work (config parsing, setters,
+ * macro encoding, decoding): wall time and, if available, hardware
+ * performance counters (cycles, instructions, branch misses, cache misses)
+ * measured with perf_event_open. The counters only count user space.
+ * The USB transfers are measured as the separate phase "transfers", the
+ * phase they happen in is paused meanwhile (see rd_mouse::set_stats).
+ * 
+ * Without perf events (other systems, no PMU, perf_event_paranoid)
+ * only the wall time is measured.
+ * 
+ */
+class rd_stats{
+	
+	public:
+		
+		/// What is measured
+		enum rd_stats_mode{
+			stats_off,
+			stats_time,
+			stats_hw
+		};
+		
+		/// Number of hardware counters
+		static const int counters = 4;
+		
+		/** \brief Open the performance counters if mode is stats_hw
+		 * Falls back to stats_time if none of the counters can be opened.
+		 */
+		rd_stats( rd_stats_mode mode = stats_off );
+		
+		/// Close the performance counters
+		~rd_stats();
+		
+		rd_stats( const rd_stats& ) = delete;
+		rd_stats& operator=( const rd_stats& ) = delete;
+		
+		/** \brief Start measuring a phase
+		 * Phases with the same name are added up. A running phase is ended first.
+		 */
+		void begin( const std::string& phase );
+		
+		/// Stop measuring the current phase
+		void end();
+		
+		/** \brief Measure a USB transfer in the phase "transfers" until end_transfer
+		 * The running phase is paused and continues with end_transfer.
+		 */
+		void begin_transfer();
+		
+		/// End the measurement of a USB transfer
+		void end_transfer();
+		
+		/// Print the results of all phases
+		void print( std::ostream& output );
+		
+		/// Get _i_mode
+		rd_stats_mode get_mode(){ return _i_mode; }
+		
+	private:
+		
+		/// results of one phase
+		struct phase_stats{
+			std::string name;
+			int runs = 0;
+			double time = 0;
+			uint64_t values[counters] = {};
+		};
+		
+		/// what is measured
+		rd_stats_mode _i_mode;
+		/// file descriptors of the counters, -1 if unavailable
+		int _i_fd[counters];
+		/// why the counters are unavailable, empty if all were opened
+		std::string _i_error;
+		/// results in the order of the first begin()
+		std::vector< phase_stats > _i_phases;
+		/// index of the running phase in _i_phases, -1 if none
+		int _i_current = -1;
+		/// index of the phase paused by begin_transfer, -1 if none
+		int _i_paused = -1;
+		/// start of the running phase
+		std::chrono::steady_clock::time_point _i_start;
+		
+		/// index of a phase, added if it is new
+		int _i_phase( const std::string& name );
+		
+		/// start the counters and the time of the running phase
+		void _i_start_counting();
+		
+		/// add the counters and the time to the running phase, counted as a run if run
+		void _i_stop_counting( bool run );
+};
+
+#endif
@@ -0,0 +1,790 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ * 
+ */
+
+
+#include "rd_mouse.h"
+
+#include <cstdlib>
+
+#include <sys/stat.h>
+
+//transport functions (all usb transfers to and from the mouse)
+
+// timeval for libusb event handling, negative durations are zero (tv_usec must stay below one second)
+static timeval transport_timeval( std::chrono::microseconds duration ){
+	long long us = std::max( (long long)duration.count(), 0LL );
+	timeval tv;
+	tv.tv_sec = us / 1000000;
+	tv.tv_usec = us % 1000000;
+	return tv;
+}
+
+// measures a transfer in the statistics of the command while it exists, nothing if stats is nullptr
+struct transfer_stats{
+	rd_stats* stats;
+	transfer_stats( rd_stats* s ) : stats( s ){
+		if( stats != nullptr )
+			stats->begin_transfer();
+	}
+	~transfer_stats(){
+		if( stats != nullptr )
+			stats->end_transfer();
+	}
+	transfer_stats( const transfer_stats& ) = delete;
+	transfer_stats& operator=( const transfer_stats& ) = delete;
+};
+
+int rd_mouse::_i_control_transfer( uint8_t request_type, uint8_t request, uint16_t value, uint16_t index,
+	unsigned char* data, uint16_t length, unsigned int timeout ){
+	
+	// deadline exceeded or cancelled: no further transfers
+	int abort = _i_check_abort();
+	if( abort != 0 )
+		return _i_abort( abort );
+	
+	// dry run: describe the transfer instead of sending it
+	if( _i_dry_run )
+		return _i_dry_run_transfer( transfer_control, request_type, value, data, length );
+	
+	// write journal: record the transfer, it is sent by commit_journal
+	if( _i_journal_recording )
+		return _i_journal_record( transfer_control, request_type, request, value, index, data, length );
+	
+	// the transfer and the throttle wait are measured apart from the CPU-side phases
+	transfer_stats measure( _i_stats );
+	
+	_i_throttle_wait();
+	
+	int ret = 0;
+	auto start = std::chrono::steady_clock::now();
+	
+	// without a deadline the cancellation token is only checked between the transfers, the synchronous path is used
+	if( _i_has_deadline ){
+		
+		// asynchronous transfer that can be cancelled, the buffer is reused
+		std::vector< unsigned char >& buffer = _i_transfer_buffer;
+		buffer.assign( LIBUSB_CONTROL_SETUP_SIZE + length, 0 );
+		libusb_fill_control_setup( buffer.data(), request_type, request, value, index, length );
+		if( !(request_type & 0x80) && data != nullptr )
+			std::copy( data, data + length, buffer.begin() + LIBUSB_CONTROL_SETUP_SIZE );
+		
+		libusb_transfer* transfer = libusb_alloc_transfer( 0 );
+		if( transfer == nullptr )
+			return LIBUSB_ERROR_NO_MEM;
+		
+		libusb_fill_control_transfer( transfer, _i_handle, buffer.data(), _i_transfer_callback, nullptr, timeout );
+		ret = _i_run_transfer( transfer );
+		
+		if( ret == LIBUSB_SUCCESS ){
+			ret = transfer->actual_length;
+			if( (request_type & 0x80) && data != nullptr )
+				std::copy( buffer.begin() + LIBUSB_CONTROL_SETUP_SIZE, buffer.begin() + LIBUSB_CONTROL_SETUP_SIZE + ret, data );
+		}
+		
+		libusb_free_transfer( transfer );
+		
+	} else{
+		ret = libusb_control_transfer( _i_handle, request_type, request, value, index, data, length, timeout );
+	}
+	
+	auto end = std::chrono::steady_clock::now();
+	_i_throttle_update( start, end );
+	
+	// per-transfer latency for the dry run estimate
+	if( ret >= 0 ){
+		_i_latency_transfers++;
+		_i_latency_total += end - start;
+	}
+	
+	// sent data for out transfers, received data for in transfers
+	int captured = std::clamp( (request_type & 0x80) ? ret : (int)length, 0, (int)length );
+	_i_record_transfer( transfer_control, request_type, request, value, index, length, data, captured, ret, start, end );
+	
+	RD_LOG_TRACE( std::hex << std::setfill('0') << std::setw(2) << (int)request_type << " " << std::setw(2) << (int)request
+		<< " " << std::setw(4) << value << " " << std::setw(4) << index << std::dec << std::setfill(' ')
+		<< " " << length << " -> " << ret << ": " << rd_log::hex( data, captured ) );
+	if( ret < 0 )
+		RD_LOG_DEBUG( "control transfer failed: " << (ret <= error_deadline_exceeded ? "aborted" : libusb_error_name( ret )) );
+	
+	if( ret == error_deadline_exceeded || ret == error_cancelled )
+		return _i_abort( ret );
+	
+	// keep track of the session (0xf5 0x00 opens, 0xf5 0x01 closes) to leave the mouse in a known state on abort
+	if( ret >= 0 && request_type == 0x21 && data != nullptr && length >= 3 && data[1] == 0xf5 ){
+		if( data[2] == 0x00 ){
+			_i_session_open = true;
+			_i_session_report_id = data[0];
+			_i_session_value = value;
+			_i_session_index = index;
+		} else if( data[2] == 0x01 ){
+			_i_session_open = false;
+		}
+	}
+	
+	return ret;
+}
+
+int rd_mouse::_i_interrupt_transfer( unsigned char endpoint, unsigned char* data, int length,
+	int* transferred, unsigned int timeout ){
+	
+	// deadline exceeded or cancelled: no further transfers
+	int abort = _i_check_abort();
+	if( abort != 0 )
+		return _i_abort( abort );
+	
+	// dry run: describe the transfer instead of receiving it
+	if( _i_dry_run ){
+		int ret = _i_dry_run_transfer( transfer_interrupt, endpoint, 0, data, length );
+		if( transferred != nullptr )
+			*transferred = ret;
+		return LIBUSB_SUCCESS;
+	}
+	
+	// write journal: record the transfer, it is sent by commit_journal
+	if( _i_journal_recording ){
+		int ret = _i_journal_record( transfer_interrupt, endpoint, 0, 0, 0, data, length );
+		if( transferred != nullptr )
+			*transferred = ret;
+		return LIBUSB_SUCCESS;
+	}
+	
+	transfer_stats measure( _i_stats );
+	
+	_i_throttle_wait();
+	
+	int ret = 0;
+	auto start = std::chrono::steady_clock::now();
+	
+	if( _i_has_deadline ){
+		
+		// asynchronous transfer that can be cancelled
+		libusb_transfer* transfer = libusb_alloc_transfer( 0 );
+		if( transfer == nullptr )
+			return LIBUSB_ERROR_NO_MEM;
+		
+		libusb_fill_interrupt_transfer( transfer, _i_handle, endpoint, data, length, _i_transfer_callback, nullptr, timeout );
+		ret = _i_run_transfer( transfer );
+		
+		if( transferred != nullptr )
+			*transferred = transfer->actual_length;
+		
+		libusb_free_transfer( transfer );
+		
+	} else{
+		ret = libusb_interrupt_transfer( _i_handle, endpoint, data, length, transferred, timeout );
+	}
+	
+	auto end = std::chrono::steady_clock::now();
+	_i_throttle_update( start, end );
+	
+	// per-transfer latency for the dry run estimate
+	if( ret >= 0 ){
+		_i_latency_transfers++;
+		_i_latency_total += end - start;
+	}
+	
+	int captured = (transferred != nullptr && ret == 0) ? std::clamp( *transferred, 0, length ) : 0;
+	_i_record_transfer( transfer_interrupt, endpoint, 0, 0, 0, length, data, captured, ret, start, end );
+	
+	RD_LOG_TRACE( "endpoint " << std::hex << (int)endpoint << std::dec << " " << length << " -> " << ret << ": "
+		<< rd_log::hex( data, captured ) );
+	if( ret < 0 )
+		RD_LOG_DEBUG( "interrupt transfer failed: " << (ret <= error_deadline_exceeded ? "aborted" : libusb_error_name( ret )) );
+	
+	if( ret == error_deadline_exceeded || ret == error_cancelled )
+		return _i_abort( ret );
+	
+	return ret;
+}
+
+void rd_mouse::_i_read_macro_rows( uint8_t (*rows)[64], uint8_t (*buffer_in)[64], int row_count, int first_macro_row ){
+	
+	_i_readback_stats = readback_stats();
+	_i_readback_stats.transfers = 2 * row_count;
+	
+	for( int i = 0; i < row_count; i++ ){
+		// control out
+		_i_control_transfer( 0x21, 0x09, 0x0303, 0x0002, rows[i], 64, 1000 );
+		
+		// control in
+		_i_control_transfer( 0xa1, 0x01, 0x0303, 0x0002, buffer_in[i], 64, 1000 );
+		
+		// first row of a macro slot without an action: the macro is not defined, skip the rest of the slot
+		if( i >= first_macro_row && (i - first_macro_row) % 4 == 0 &&
+			buffer_in[i][8] == 0 && buffer_in[i][9] == 0 && buffer_in[i][10] == 0 ){
+			
+			int skip = std::min( 3, row_count-1-i );
+			_i_readback_stats.skipped += 2 * skip;
+			i += skip;
+		}
+	}
+}
+
+int rd_mouse::_i_check_abort(){
+	
+	if( _i_cancellation_token != nullptr && _i_cancellation_token->load() )
+		return error_cancelled;
+	
+	if( _i_has_deadline && std::chrono::steady_clock::now() >= _i_deadline )
+		return error_deadline_exceeded;
+	
+	return 0;
+}
+
+int rd_mouse::_i_abort( int error ){
+	
+	if( _i_transfer_error == 0 ){
+		_i_transfer_error = error;
+		RD_LOG_INFO( (error == error_cancelled ? "cancelled" : "deadline exceeded") << ", aborting" );
+	}
+	
+	// close the session, the mouse otherwise keeps waiting for the remaining packets
+	_i_close_session();
+	
+	return error;
+}
+
+void rd_mouse::_i_close_session(){
+	
+	if( !_i_session_open )
+		return;
+	
+	_i_session_open = false;
+	
+	uint8_t buffer[16] = { _i_session_report_id, 0xf5, 0x01 };
+	auto start = std::chrono::steady_clock::now();
+	int ret = libusb_control_transfer( _i_handle, 0x21, 0x09, _i_session_value, _i_session_index, buffer, 16, 100 );
+	_i_record_transfer( transfer_control, 0x21, 0x09, _i_session_value, _i_session_index, 16, buffer, 16, ret,
+		start, std::chrono::steady_clock::now() );
+}
+
+int rd_mouse::_i_run_transfer( libusb_transfer* transfer ){
+	
+	int completed = 0;
+	transfer->user_data = &completed;
+	
+	int ret = libusb_submit_transfer( transfer );
+	if( ret != LIBUSB_SUCCESS )
+		return ret;
+	
+	// handle events until the transfer completes, the cancellation token is polled every 10 ms
+	int abort = 0;
+	while( !completed ){
+		
+		if( abort == 0 ){
+			abort = _i_check_abort();
+			if( abort != 0 )
+				libusb_cancel_transfer( transfer );
+		}
+		
+		auto wait = std::chrono::microseconds( 10000 );
+		if( abort == 0 && _i_has_deadline ){
+			wait = std::min( wait, std::chrono::duration_cast<std::chrono::microseconds>(
+				_i_deadline - std::chrono::steady_clock::now() ) + std::chrono::microseconds( 1 ) );
+		}
+		
+		timeval tv = transport_timeval( wait );
+		libusb_handle_events_timeout_completed( NULL, &tv, &completed );
+	}
+	
+	switch( transfer->status ){
+		case LIBUSB_TRANSFER_COMPLETED:
+			return LIBUSB_SUCCESS;
+		case LIBUSB_TRANSFER_CANCELLED:
+			return abort != 0 ? abort : LIBUSB_ERROR_INTERRUPTED;
+		case LIBUSB_TRANSFER_TIMED_OUT:
+			return LIBUSB_ERROR_TIMEOUT;
+		case LIBUSB_TRANSFER_STALL:
+			return LIBUSB_ERROR_PIPE;
+		case LIBUSB_TRANSFER_NO_DEVICE:
+			return LIBUSB_ERROR_NO_DEVICE;
+		case LIBUSB_TRANSFER_OVERFLOW:
+			return LIBUSB_ERROR_OVERFLOW;
+		default:
+			return LIBUSB_ERROR_IO;
+	}
+}
+
+void LIBUSB_CALL rd_mouse::_i_transfer_callback( libusb_transfer* transfer ){
+	*static_cast< int* >( transfer->user_data ) = 1;
+}
+
+int rd_mouse::_i_dry_run_transfer( uint8_t type, uint8_t request_type, uint16_t value, unsigned char* data, int length ){
+	
+	_i_dry_run_stats.transfers++;
+	_i_dry_run_stats.bytes += std::max( length, 0 );
+	
+	// in transfers (bit 7 of bmRequestType or the endpoint address) read nothing
+	bool in = request_type & 0x80;
+	if( in && data != nullptr )
+		std::fill( data, data + length, 0 );
+	
+	// simulated settings memory: a read row is answered by the next control in transfer, write rows are stored
+	if( _i_simulate_memory && type == transfer_control && data != nullptr && length >= 8 ){
+		
+		if( in && _i_simulated_request[1] == 0xf2 ){
+			uint16_t address = _i_simulated_request[2] | (_i_simulated_request[3] << 8);
+			std::copy( _i_simulated_request.begin(), _i_simulated_request.end(), data );
+			for( int i = 0; i < _i_simulated_request[4] && 8+i < length; i++ ){
+				auto byte = _i_simulated_memory.find( address+i );
+				if( byte != _i_simulated_memory.end() )
+					data[8+i] = byte->second;
+			}
+			_i_simulated_request = {};
+		} else if( !in && data[1] == 0xf2 ){
+			std::copy( data, data+8, _i_simulated_request.begin() );
+		} else if( !in && data[1] == 0xf3 ){
+			uint16_t address = data[2] | (data[3] << 8);
+			for( int i = 0; i < data[4] && 8+i < length; i++ )
+				_i_simulated_memory[address+i] = data[8+i];
+		}
+	}
+	
+	if( _i_dry_run_output != nullptr ){
+		std::ostream& output = *_i_dry_run_output;
+		output << (type == transfer_control ? "control " : "interrupt ") << (in ? "in " : "out ")
+			<< std::hex << std::setfill('0') << std::setw(4) << value << std::dec << std::setfill(' ')
+			<< " " << std::setw(3) << length;
+		if( !in )
+			output << ": " << rd_log::hex( data, length );
+		output << "\n";
+	}
+	
+	return length;
+}
+
+void rd_mouse::_i_throttle_wait(){
+	
+	auto now = std::chrono::steady_clock::now();
+	if( now >= _i_throttle_next )
+		return;
+	
+	// keep handling events while waiting, so that the pointer reports are timestamped on arrival
+	if( _i_jitter_transfer != nullptr ){
+		
+		while( now < _i_throttle_next ){
+			timeval tv = transport_timeval( std::chrono::duration_cast<std::chrono::microseconds>( _i_throttle_next - now ) );
+			libusb_handle_events_timeout_completed( NULL, &tv, NULL );
+			now = std::chrono::steady_clock::now();
+		}
+		
+	} else if( _i_has_deadline ){
+		std::this_thread::sleep_until( std::min( _i_throttle_next, _i_deadline ) );
+	} else{
+		std::this_thread::sleep_until( _i_throttle_next );
+	}
+}
+
+void rd_mouse::_i_throttle_update( std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end ){
+	
+	_i_throttle_next = end;
+	
+	// transfer rate: spread the transfer starts evenly
+	if( _i_throttle_rate > 0 ){
+		auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+			std::chrono::duration<double, std::milli>( 1.0 / _i_throttle_rate ) );
+		_i_throttle_next = std::max( _i_throttle_next, start + interval );
+	}
+	
+	// duty cycle: stay idle proportionally to the duration of the transfer
+	if( _i_throttle_duty_cycle > 0 && _i_throttle_duty_cycle < 1 ){
+		auto idle = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+			(end - start) * ((1.0 - _i_throttle_duty_cycle) / _i_throttle_duty_cycle) );
+		_i_throttle_next = std::max( _i_throttle_next, end + idle );
+	}
+}
+
+// flight recorder
+
+rd_mouse::transfer_record rd_mouse::_i_flight_recorder[rd_mouse::flight_recorder_size];
+std::atomic<uint64_t> rd_mouse::_i_flight_recorder_count( 0 );
+char rd_mouse::_i_flight_recorder_file[4096] = "";
+size_t rd_mouse::_i_flight_recorder_directory = 0;
+std::atomic<int> rd_mouse::_i_flight_recorder_dumps( 0 );
+
+/* Binary raw dump format, all values little endian:
+ * 
+ * header (32 bytes):
+ *   0  char[8]  magic "RDRAWDMP"
+ *   8  uint16   format version (1)
+ *  10  uint16   record size (96)
+ *  12  uint32   number of records
+ *  16  uint64   steady clock at the time of the dump in ns
+ *  24  uint64   system clock at the time of the dump in ns since the unix epoch
+ * 
+ * records, oldest first:
+ *   0  uint64   start of the transfer, steady clock in ns
+ *   8  uint64   end of the transfer, steady clock in ns
+ *  16  int32    result (bytes transferred or error code)
+ *  20  uint8    type (0 = control, 1 = interrupt)
+ *  21  uint8    bmRequestType (control) or endpoint (interrupt)
+ *  22  uint8    bRequest
+ *  23  uint8    number of valid payload bytes
+ *  24  uint16   wValue
+ *  26  uint16   wIndex
+ *  28  uint16   wLength
+ *  30  uint16   reserved
+ *  32  uint8[64] payload
+ */
+static const char raw_dump_magic[8] = { 'R', 'D', 'R', 'A', 'W', 'D', 'M', 'P' };
+static const size_t raw_dump_header_size = 32;
+static const size_t raw_dump_record_size = 32 + rd_mouse::flight_recorder_payload;
+
+// store value as little endian
+static void raw_dump_put( uint8_t* bytes, uint64_t value, int size ){
+	for( int i = 0; i < size; i++ )
+		bytes[i] = (value >> (8*i)) & 0xff;
+}
+
+// read little endian value
+static uint64_t raw_dump_get( const uint8_t* bytes, int size ){
+	uint64_t value = 0;
+	for( int i = 0; i < size; i++ )
+		value |= (uint64_t)bytes[i] << (8*i);
+	return value;
+}
+
+// write() until all bytes are written
+static bool raw_dump_write( int fd, const uint8_t* bytes, size_t size ){
+	while( size > 0 ){
+		ssize_t written = write( fd, bytes, size );
+		if( written < 0 && errno == EINTR )
+			continue;
+		if( written <= 0 )
+			return false;
+		bytes += written;
+		size -= written;
+	}
+	return true;
+}
+
+void rd_mouse::_i_record_transfer( uint8_t type, uint8_t request_type, uint8_t request, uint16_t value, uint16_t index,
+	uint16_t length, const unsigned char* data, int captured, int result,
+	std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end ){
+	
+	// several mice (--sync-lighting) record from their own threads: each transfer claims its slot, the sequence number
+	// marks the record as complete, a dump skips the records that are being written
+	uint64_t count = _i_flight_recorder_count.fetch_add( 1, std::memory_order_relaxed );
+	transfer_record& record = _i_flight_recorder[count % flight_recorder_size];
+	record.sequence.store( 0, std::memory_order_relaxed );
+	std::atomic_thread_fence( std::memory_order_release );
+	
+	record.start = std::chrono::duration_cast<std::chrono::nanoseconds>( start.time_since_epoch() ).count();
+	record.end = std::chrono::duration_cast<std::chrono::nanoseconds>( end.time_since_epoch() ).count();
+	record.result = result;
+	record.type = type;
+	record.request_type = request_type;
+	record.request = request;
+	record.value = value;
+	record.index = index;
+	record.length = length;
+	
+	captured = std::clamp( captured, 0, std::min( (int)length, (int)flight_recorder_payload ) );
+	if( data == nullptr )
+		captured = 0;
+	record.captured = captured;
+	std::copy( data, data + captured, record.payload );
+	std::fill( record.payload + captured, record.payload + flight_recorder_payload, 0 );
+	
+	record.sequence.store( count + 1, std::memory_order_release );
+	
+	// dump on the first failed transfer, close_mouse dumps again to include the following transfers
+	if( result < 0 && ++_i_failed_transfers == 1 )
+		dump_flight_recorder();
+}
+
+void rd_mouse::set_default_flight_recorder_file(){
+	
+	if( getenv( "XDG_RUNTIME_DIR" ) != nullptr && getenv( "XDG_RUNTIME_DIR" )[0] != '\0' ){
+		set_flight_recorder_file( std::string( getenv( "XDG_RUNTIME_DIR" ) ) + "/mouse_m908.rawdump" );
+		return;
+	}
+	
+	// the cache directory of the user, not a shared directory like /tmp where other users can place links
+	std::string directory;
+	if( getenv( "XDG_CACHE_HOME" ) != nullptr && getenv( "XDG_CACHE_HOME" )[0] != '\0' )
+		directory = std::string( getenv( "XDG_CACHE_HOME" ) ) + "/mouse_m908";
+	else if( getenv( "HOME" ) != nullptr && getenv( "HOME" )[0] != '\0' )
+		directory = std::string( getenv( "HOME" ) ) + "/.cache/mouse_m908";
+	
+	set_flight_recorder_file( directory != "" ? directory + "/mouse_m908.rawdump" : "" );
+	if( directory != "" && directory.size() < sizeof(_i_flight_recorder_file) )
+		_i_flight_recorder_directory = directory.size();
+}
+
+void rd_mouse::set_flight_recorder_file( const std::string& path ){
+	size_t length = std::min( path.size(), sizeof(_i_flight_recorder_file) - 1 );
+	std::copy( path.begin(), path.begin() + length, _i_flight_recorder_file );
+	_i_flight_recorder_file[length] = '\0';
+	_i_flight_recorder_directory = 0;
+}
+
+int rd_mouse::dump_flight_recorder(){
+	
+	// automatic dumps disabled
+	if( _i_flight_recorder_file[0] == '\0' )
+		return 1;
+	
+	int flags = O_WRONLY | O_CREAT | O_TRUNC;
+	#ifdef O_NOFOLLOW
+	flags |= O_NOFOLLOW;
+	#endif
+	
+	// one dump at a time, a failing transfer of another mouse or SIGUSR1 during a dump doesn't write the file again
+	static std::atomic<bool> dumping( false );
+	if( dumping.exchange( true, std::memory_order_acquire ) )
+		return 1;
+	
+	// the cache directory is only created when a dump is written (mkdir is async-signal-safe, the path is copied on the stack)
+	if( _i_flight_recorder_directory > 0 ){
+		char directory[sizeof(_i_flight_recorder_file)];
+		std::copy( _i_flight_recorder_file, _i_flight_recorder_file + _i_flight_recorder_directory, directory );
+		for( size_t i = 1; i <= _i_flight_recorder_directory; i++ ){
+			if( i == _i_flight_recorder_directory || directory[i] == '/' ){
+				directory[i] = '\0';
+				mkdir( directory, 0700 );
+				directory[i] = '/';
+			}
+		}
+	}
+	
+	int fd = open( _i_flight_recorder_file, flags, 0600 );
+	if( fd < 0 ){
+		dumping.store( false, std::memory_order_release );
+		return 1;
+	}
+	
+	uint64_t count = _i_flight_recorder_count.load( std::memory_order_relaxed );
+	uint64_t first = count > flight_recorder_size ? count - flight_recorder_size : 0;
+	
+	// header, the number of records is written after the records
+	uint8_t header[raw_dump_header_size] = {};
+	std::copy( std::begin(raw_dump_magic), std::end(raw_dump_magic), header );
+	raw_dump_put( header+8, 1, 2 );
+	raw_dump_put( header+10, raw_dump_record_size, 2 );
+	raw_dump_put( header+16, std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch() ).count(), 8 );
+	raw_dump_put( header+24, std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::system_clock::now().time_since_epoch() ).count(), 8 );
+	
+	bool ok = raw_dump_write( fd, header, sizeof(header) );
+	
+	// complete records, oldest first
+	uint32_t records = 0;
+	for( uint64_t i = first; ok && i < count; i++ ){
+		
+		const transfer_record& record = _i_flight_recorder[i % flight_recorder_size];
+		uint8_t bytes[raw_dump_record_size] = {};
+		
+		if( record.sequence.load( std::memory_order_acquire ) != i + 1 )
+			continue;
+		
+		raw_dump_put( bytes, record.start, 8 );
+		raw_dump_put( bytes+8, record.end, 8 );
+		raw_dump_put( bytes+16, (uint32_t)record.result, 4 );
+		bytes[20] = record.type;
+		bytes[21] = record.request_type;
+		bytes[22] = record.request;
+		bytes[23] = record.captured;
+		raw_dump_put( bytes+24, record.value, 2 );
+		raw_dump_put( bytes+26, record.index, 2 );
+		raw_dump_put( bytes+28, record.length, 2 );
+		std::copy( std::begin(record.payload), std::end(record.payload), bytes+32 );
+		
+		// rewritten while it was copied
+		std::atomic_thread_fence( std::memory_order_acquire );
+		if( record.sequence.load( std::memory_order_relaxed ) != i + 1 )
+			continue;
+		
+		ok = raw_dump_write( fd, bytes, sizeof(bytes) );
+		records++;
+	}
+	
+	raw_dump_put( header+12, records, 4 );
+	ok = ok && lseek( fd, 0, SEEK_SET ) == 0 && raw_dump_write( fd, header, sizeof(header) );
+	
+	close( fd );
+	dumping.store( false, std::memory_order_release );
+	
+	if( !ok )
+		return 1;
+	
+	_i_flight_recorder_dumps++;
+	return 0;
+}
+
+int rd_mouse::print_raw_dump( std::istream& input, std::ostream& output ){
+	
+	// header
+	uint8_t header[raw_dump_header_size];
+	if( !input.read( (char*)header, sizeof(header) ) ||
+		!std::equal( std::begin(raw_dump_magic), std::end(raw_dump_magic), header ) ||
+		raw_dump_get( header+8, 2 ) != 1 || raw_dump_get( header+10, 2 ) < raw_dump_record_size ){
+		return 1;
+	}
+	
+	size_t record_size = raw_dump_get( header+10, 2 );
+	uint64_t records = raw_dump_get( header+12, 4 );
+	
+	// time of the dump
+	std::time_t dump_time = raw_dump_get( header+24, 8 ) / 1000000000;
+	output << "# Raw dump written " << std::put_time( std::localtime( &dump_time ), "%Y-%m-%d %H:%M:%S" );
+	output << ", " << records << " transfers\n";
+	output << "# start [ms], duration [ms], type, setup, result: payload\n\n";
+	
+	std::vector< uint8_t > bytes( record_size );
+	uint64_t first_start = 0;
+	
+	for( uint64_t i = 0; i < records; i++ ){
+		
+		if( !input.read( (char*)bytes.data(), record_size ) )
+			return 1;
+		
+		uint64_t start = raw_dump_get( bytes.data(), 8 );
+		uint64_t end = raw_dump_get( bytes.data()+8, 8 );
+		int32_t result = (int32_t)raw_dump_get( bytes.data()+16, 4 );
+		size_t captured = std::min( (size_t)bytes[23], flight_recorder_payload );
+		
+		if( i == 0 )
+			first_start = start;
+		
+		output << std::fixed << std::setprecision(3);
+		output << std::setw(10) << (start - first_start) / 1e6 << " " << std::setw(8) << (end - start) / 1e6 << " ";
+		output << std::defaultfloat << std::setprecision(6);
+		
+		// setup
+		output << std::hex << std::setfill('0');
+		if( bytes[20] == transfer_interrupt ){
+			output << "interrupt " << std::setw(2) << (int)bytes[21];
+			output << " " << std::setw(4) << raw_dump_get( bytes.data()+28, 2 );
+		} else{
+			output << "control " << std::setw(2) << (int)bytes[21] << " " << std::setw(2) << (int)bytes[22];
+			output << " " << std::setw(4) << raw_dump_get( bytes.data()+24, 2 );
+			output << " " << std::setw(4) << raw_dump_get( bytes.data()+26, 2 );
+			output << " " << std::setw(4) << raw_dump_get( bytes.data()+28, 2 );
+		}
+		output << std::dec << std::setfill(' ');
+		
+		// result
+		if( result == error_deadline_exceeded )
+			output << " deadline exceeded";
+		else if( result == error_cancelled )
+			output << " cancelled";
+		else if( result < 0 )
+			output << " " << libusb_error_name( result );
+		else
+			output << " " << result;
+		
+		// payload
+		output << ":" << std::hex << std::setfill('0');
+		for( size_t j = 0; j < captured; j++ )
+			output << " " << std::setw(2) << (int)bytes[32+j];
+		output << std::dec << std::setfill(' ') << "\n";
+	}
+	
+	return 0;
+}
+
+int rd_mouse::start_jitter_measurement( uint8_t endpoint ){
+	
+	// already running
+	if( _i_jitter_transfer != nullptr )
+		return 1;
+	
+	_i_jitter_transfer = libusb_alloc_transfer( 0 );
+	if( _i_jitter_transfer == nullptr )
+		return 1;
+	
+	// reserve enough space for several seconds at 1000 Hz, the callback should not allocate
+	_i_jitter_timestamps.clear();
+	_i_jitter_timestamps.reserve( 65536 );
+	_i_jitter_stopping = false;
+	_i_jitter_pending = true;
+	
+	libusb_fill_interrupt_transfer( _i_jitter_transfer, _i_handle, endpoint, _i_jitter_buffer,
+		sizeof(_i_jitter_buffer), _i_jitter_callback, this, 0 );
+	
+	if( libusb_submit_transfer( _i_jitter_transfer ) != 0 ){
+		libusb_free_transfer( _i_jitter_transfer );
+		_i_jitter_transfer = nullptr;
+		_i_jitter_pending = false;
+		return 1;
+	}
+	
+	return 0;
+}
+
+int rd_mouse::stop_jitter_measurement( jitter_stats& stats ){
+	
+	// not running
+	if( _i_jitter_transfer == nullptr )
+		return 1;
+	
+	// cancel the pending transfer and wait for the callback
+	_i_jitter_stopping = true;
+	if( _i_jitter_pending )
+		libusb_cancel_transfer( _i_jitter_transfer );
+	while( _i_jitter_pending ){
+		timeval tv = { 0, 100000 };
+		libusb_handle_events_timeout_completed( NULL, &tv, NULL );
+	}
+	
+	libusb_free_transfer( _i_jitter_transfer );
+	_i_jitter_transfer = nullptr;
+	
+	// compute the intervals between the reports
+	stats = jitter_stats();
+	stats.reports = _i_jitter_timestamps.size();
+	
+	if( _i_jitter_timestamps.size() < 2 )
+		return 0;
+	
+	double sum = 0, sum_squares = 0;
+	for( size_t i = 1; i < _i_jitter_timestamps.size(); i++ ){
+		double interval = std::chrono::duration<double, std::micro>( _i_jitter_timestamps[i] - _i_jitter_timestamps[i-1] ).count();
+		sum += interval;
+		sum_squares += interval * interval;
+		stats.max_interval = std::max( stats.max_interval, interval );
+	}
+	
+	double n = _i_jitter_timestamps.size() - 1;
+	stats.mean_interval = sum / n;
+	stats.stddev_interval = std::sqrt( std::max( 0.0, sum_squares / n - stats.mean_interval * stats.mean_interval ) );
+	
+	return 0;
+}
+
+void LIBUSB_CALL rd_mouse::_i_jitter_callback( libusb_transfer* transfer ){
+	
+	rd_mouse* mouse = static_cast< rd_mouse* >( transfer->user_data );
+	
+	if( transfer->status == LIBUSB_TRANSFER_COMPLETED &&
+		mouse->_i_jitter_timestamps.size() < mouse->_i_jitter_timestamps.capacity() ){
+		mouse->_i_jitter_timestamps.push_back( std::chrono::steady_clock::now() );
+	}
+	
+	// resubmit until stopped
+	if( !mouse->_i_jitter_stopping && transfer->status != LIBUSB_TRANSFER_CANCELLED &&
+		transfer->status != LIBUSB_TRANSFER_NO_DEVICE ){
+		
+		if( libusb_submit_transfer( transfer ) == 0 )
+			return;
+	}
+	
+	mouse->_i_jitter_pending = false;
+}
@@ -17,19 +17,39 @@
  */
 
 #include <map>
+#include <memory>
 #include <array>
+#include <sstream>
 #include <string>
+#include <vector>
 #include <iostream>
 #include <fstream>
 #include <exception>
 #include <regex>
 #include <type_traits>
 #include <variant>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
 #include <getopt.h>
+#include <poll.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <sys/prctl.h>
+#endif
 
 #include "include/rd_mouse.h"
+#include "include/actions.h"
+#include "include/plugin.h"
 #include "include/load_config.h"
+#include "include/macro_bank.h"
+#include "include/stats.h"
 #include "include/help.h"
+#include "include/light_sync.h"
+#include "include/resident.h"
 
 // this is the default version string
 // the version string gets overwritten by the makefile
@@ -46,16 +66,100 @@ template< typename T1, typename T2 > struct overload : T1, T2  {
 };
 
 
-// this function checks its arguments and opens the mouse accordingly
-// (with vid and pid or with bus and device)
-template< typename T >int open_mouse_wrapper( T &m, const bool flag_bus, const bool flag_device,
-	const std::string &string_bus, const std::string &string_device );
+// values for options that only have a long form
+enum long_only_options{
+	option_throttle = 256,
+	option_measure_jitter,
+	option_timeout,
+	option_flight_recorder,
+	option_print_dump,
+	option_log_level,
+	option_log_sink,
+	option_stats,
+	option_compile_macros,
+	option_dry_run,
+	option_sync_lighting,
+	option_simulate,
+	option_journal,
+	option_backup,
+	option_restore,
+	option_compress_macros,
+	option_resident,
+	option_undo,
+};
+
+
+// signal handler for SIGUSR1, writes the flight recorder to its file
+extern "C" void flight_recorder_handler( int signal ){
+	(void)signal;
+	rd_mouse::dump_flight_recorder();
+}
+
+// tells the user where the flight recorder was written to
+void print_flight_recorder_note(){
+	if( rd_mouse::get_flight_recorder_dumps() > 0 ){
+		std::cerr << "The last transfers were saved to " << rd_mouse::get_flight_recorder_file();
+		std::cerr << ", use --print-dump to view them.\n";
+	}
+}
+
+// the names of all models (--model ?)
+std::vector< std::string > model_names();
+
+// this function detects the mouse, only mice of the model string_model if it isn't empty
+// returns nullptr if no mouse was found
+std::unique_ptr< rd_model > detect_model( const std::string &string_model );
+
+// this function returns the model object for a model name without detecting the mouse
+// (snapshots, --simulate, --compile-macros), nullptr if the model is unknown
+std::unique_ptr< rd_model > find_model( const std::string &string_model );
+
+// this function runs a lighting effect in sync on all connected mice of the model (M908 only)
+void sync_lighting( const std::string &string_model, const std::string &string_sync_lighting, const bool flag_kernel_driver );
+
+// the parsed command line
+struct command_line{
+	rd_options options;
+	bool flag_help = false;
+	bool flag_version = false;
+	bool flag_print_dump = false;
+	bool flag_compile_macros = false;
+	bool flag_sync_lighting = false;
+	bool flag_resident = false;
+	bool flag_flight_recorder = false;
+	/// --flight-recorder, --log-level or --log-sink: settings of the process, not of the command
+	bool flag_process_settings = false;
+	rd_stats::rd_stats_mode stats_mode = rd_stats::stats_off;
+	
+	std::string string_model = "";
+	std::string string_print_dump;
+	std::string string_sync_lighting;
+	std::string string_resident;
+};
+
+// this function parses the command line, throws std::string for wrong arguments
+// --flight-recorder, --log-level and --log-sink are applied immediately
+void parse_command_line( int argc, char **argv, command_line &command );
+
+// these functions check the combinations of the options, throw std::string for wrong combinations
+void check_macro_options( const rd_options &options );
+void check_mouse_options( const rd_options &options );
+
+// this function sets the directory of the write journals and whether they are used
+void set_journal_directory( rd_options &options );
 
+// whether a command can be performed by the resident mode: only actions on the mouse chosen when it started
+bool resident_command( const command_line &command );
 
+// this function runs the resident mode: the mouse stays open and performs the commands read from stdin and the socket
+void run_resident( const command_line &resident );
 
 // main function
 int main( int argc, char **argv ){
 	
+	// the latency reported with --stats: direct or performed by the resident mode
+	auto start = std::chrono::steady_clock::now();
+	
 	try{
 		// if no arguments: print help
 		if( argc == 1 ){
@@ -63,112 +167,135 @@ int main( int argc, char **argv ){
 			return 0;
 		}
 		
-		//command line options
-		static struct option long_options[] = {
-			{"help", no_argument, 0, 'h'},
-			{"config", required_argument, 0, 'c'},
-			{"profile", required_argument, 0, 'p'},
-			{"macro", required_argument, 0, 'm'},
-			{"number", required_argument, 0, 'n'},
-			{"bus", required_argument, 0, 'b'},
-			{"device", required_argument, 0, 'd'},
-			{"kernel-driver", no_argument, 0, 'k'},
-			{"version", no_argument, 0, 'v'},
-			{"dump", required_argument, 0, 'D'},
-			{"read", required_argument, 0, 'R'},
-			{"model", required_argument, 0, 'M'},
-			{0, 0, 0, 0}
-		};
-		
-		bool flag_config = false, flag_profile = false;
-		bool flag_macro = false, flag_number = false;
-		bool flag_bus = false, flag_device = false;
-		bool flag_kernel_driver = false;
-		bool flag_dump_settings = false;
-		bool flag_read_settings = false;
-		
-		std::string string_config, string_profile;
-		std::string string_macro, string_number;
-		std::string string_bus, string_device;
-		std::string string_dump, string_read;
-		std::string string_model = "";
-		
-		//parse command line options
-		int c, option_index = 0;
-		while( (c = getopt_long( argc, argv, "hc:p:m:n:b:d:kvD:R:M:",
-		long_options, &option_index ) ) != -1 ){
+		command_line command;
+		parse_command_line( argc, argv, command );
+		
+		rd_options &options = command.options;
+		std::string &string_model = command.string_model;
+		
+		if( command.flag_help ){
+			std::cout << mouse_m908_help;
+			return 0;
+		}
+		if( command.flag_version ){
+			std::cout << "Version: " << VERSION_STRING << "\n";
+			return 0;
+		}
+		
+		// print a binary raw dump (flight recorder), no mouse needed
+		if( command.flag_print_dump ){
 			
-			switch( c ){
-				case 'h':
-					std::cout << mouse_m908_help;
-					return 0;
-					break;
-				case 'c':
-					flag_config = true;
-					string_config = optarg;
-					break;
-				case 'p':
-					flag_profile = true;
-					string_profile = optarg;
-					break;
-				case 'm':
-					flag_macro = true;
-					string_macro = optarg;
-					break;
-				case 'n':
-					flag_number = true;
-					string_number = optarg;
-					break;
-				case 'b':
-					flag_bus = true;
-					string_bus = optarg;
-					break;
-				case 'd':
-					flag_device = true;
-					string_device = optarg;
-					break;
-				case 'k':
-					flag_kernel_driver = true;
-					break;
-				case 'v':
-					std::cout << "Version: " << VERSION_STRING << "\n";
-					return 0;
-					break;
-				case 'D':
-					flag_dump_settings = true;
-					string_dump = optarg;
-					break;
-				case 'R':
-					flag_read_settings = true;
-					string_read = optarg;
-					break;
-				case 'M':
-					string_model = optarg;
-					break;
-				case '?':
-					break;
-				default:
-					break;
+			std::ifstream in;
+			if( command.string_print_dump != "-" ){
+				in.open( command.string_print_dump, std::ios::binary );
+				if( !in.is_open() )
+					throw std::string( "Couldn't open "+command.string_print_dump );
 			}
+			
+			if( rd_mouse::print_raw_dump( command.string_print_dump != "-" ? in : std::cin, std::cout ) != 0 )
+				throw std::string( "Invalid raw dump: "+command.string_print_dump );
+			
+			return 0;
 		}
-
+		
+		// the default file of the flight recorder, only needed from here on (--flight-recorder overrides it)
+		if( !command.flag_flight_recorder )
+			rd_mouse::set_default_flight_recorder_file();
+		
+		// SIGUSR1 writes the last transfers to the flight recorder file
+		struct sigaction dump_action = {};
+		dump_action.sa_handler = flight_recorder_handler;
+		sigaction( SIGUSR1, &dump_action, nullptr );
+		
 		// print a list of valid model names
 		if( string_model == "?" ){
-			variant_loop<rd_mouse::mouse_variant>( [](auto m){
-				if( m.get_name() != rd_mouse::monostate::get_name() )
-					std::cout << m.get_name() << "\n";
-			} );
+			for( auto& name : model_names() )
+				std::cout << name << "\n";
+			return 0;
+		}
+		
+		// run a lighting effect in sync on all connected mice
+		if( command.flag_sync_lighting ){
+			sync_lighting( string_model, command.string_sync_lighting, options.flag_kernel_driver );
+			return 0;
+		}
+		
+		// keep the mouse open and read the commands from stdin and the socket
+		if( command.flag_resident ){
+			run_resident( command );
+			return 0;
+		}
+		
+		// a running resident mode performs the command, libusb isn't needed here
+		if( resident_command( command ) ){
+			
+			int status = 0;
+			if( rd_resident::forward( rd_resident::socket_path(), std::vector< std::string >( argv + 1, argv + argc ), status ) == 0 ){
+				
+				double latency = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+				RD_LOG_INFO( "performed by the resident mode in " << latency << " ms" );
+				if( command.stats_mode != rd_stats::stats_off )
+					std::cerr << "Path: resident mode (" << rd_resident::socket_path() << "), " << latency << " ms\n";
+				
+				return status;
+			}
+		}
+		
+		check_macro_options( options );
+		
+		std::unique_ptr< rd_model > mouse;
+		
+		// compile macros to a macro bank, the mouse is only needed if no model was specified
+		if( command.flag_compile_macros ){
+			
+			if( !options.flag_macro )
+				throw std::string( "Missing option, --compile-macros requires --macro." );
+			
+			if( string_model == "" )
+				mouse = detect_model( "" );
+			else
+				mouse = find_model( string_model );
+			
+			if( mouse == nullptr )
+				throw std::string( "Couldn't detect mouse, try with the --model option." );
+			
+			mouse->compile_macro_bank( options );
+			
 			return 0;
 		}
 		
-		rd_mouse::mouse_variant mouse;
+		// dry run against a snapshot or simulated mouse: the mouse is only needed if the model is unknown
+		options.snapshot = options.flag_dry_run && options.string_dry_run != "";
+		options.offline = options.snapshot || options.flag_simulate;
+		
+		if( options.snapshot ){
+			
+			std::ifstream snapshot_file( options.string_dry_run );
+			if( !snapshot_file.is_open() )
+				throw std::string( "Couldn't open "+options.string_dry_run );
+			
+			// snapshots written with -R start with the model name
+			std::string line;
+			if( string_model == "" && std::getline( snapshot_file, line ) && line.rfind( "# Model: ", 0 ) == 0 )
+				string_model = line.substr( 9 );
+		}
+		
+		if( options.flag_simulate && string_model == "" )
+			throw std::string( "Missing option, --simulate requires --model." );
+		
+		if( options.offline )
+			mouse = find_model( string_model );
+		
+		check_mouse_options( options );
 		
-		if( string_model == "" )
-			mouse = rd_mouse::detect();
-		else
-			mouse = rd_mouse::detect(string_model);
+		// detect the mouse unless the model is known from the snapshot or simulated
+		if( mouse == nullptr && !options.flag_simulate )
+			mouse = detect_model( string_model );
 		
-		if( std::holds_alternative<rd_mouse::monostate>(mouse) ){
+		if( mouse == nullptr && options.flag_simulate )
+			throw std::string( "Unknown model "+string_model+", use --model ? for a list." );
+		
+		if( mouse == nullptr ){
 			throw std::string( 
 				"Couldn't detect mouse.\n"
 				"- Check hardware and permissions (maybe you need to be root?)\n"
@@ -177,263 +304,647 @@ int main( int argc, char **argv ){
 			);
 		}
 		
-		// lambda function to perform all actions on the mouse
-		auto perform_actions = overload(
-			[](rd_mouse::monostate){},
-			[&](auto& m){
-
-				// set whether to detach kernel driver
-				m.set_detach_kernel_driver( !flag_kernel_driver );
-				
-				// open mouse, throws std::string in case of an error, handling in main()
-				open_mouse_wrapper( m, flag_bus, flag_device, string_bus, string_device );
-				
-				try{
-					// read settings and dump raw data
-					if( flag_dump_settings ){
-						
-						// dump to file or cout
-						if( string_dump != "-" ){
-							std::ofstream out( string_dump );
-							
-							if( out.is_open() ){				
-								// dump settings
-								m.dump_settings( out );
-							
-								out.close();
-							} else{
-								throw std::string( "Couldn't open "+string_dump );
-							}
-						} else{
-							m.dump_settings( std::cout );
-						}
-						
-					}
-					
-					// read settings and print in .ini format
-					if( flag_read_settings ){
-						
-						// dump to file or cout
-						if( string_read != "-" ){
-							std::ofstream out( string_read );
-							
-							if( out.is_open() ){
-								out << "# Model: " << m.get_name() << "\n";
-								// read settings
-								m.read_and_print_settings( out );
-							
-								out.close();
-							} else{
-								throw std::string( "Couldn't open "+string_read );
-							}
-						} else{
-							std::cout << "# Model: " << m.get_name() << "\n";
-							m.read_and_print_settings( std::cout );
-						}
-						
-					}
-					
-					// load and write config
-					if( flag_config ){
-						
-						simple_ini_parser pt;
-						if( pt.read_ini( string_config ) != 0 )
-							throw std::string( "Could not open configuration file." );
-						
-						//parse config file
-						for( int i = 1; i < 6; i++ ){
-							
-							rd_mouse::rd_profile profile = (rd_mouse::rd_profile)(i - 1);
-
-							for( auto& lightmode : m.lightmode_strings() ){
-								if( pt.get("profile"+std::to_string(i)+".lightmode", "") == lightmode.second )
-									m.set_lightmode( profile, lightmode.first );
-							}
-
-							if( std::regex_match( pt.get("profile"+std::to_string(i)+".color", ""), std::regex("[0-9a-fA-F]{6}") ) ){
-								m.set_color( profile,
-								{(uint8_t)stoi( pt.get("profile"+std::to_string(i)+".color", "").substr(0,2), 0, 16),
-								(uint8_t)stoi( pt.get("profile"+std::to_string(i)+".color", "").substr(2,2), 0, 16), 
-								(uint8_t)stoi( pt.get("profile"+std::to_string(i)+".color", "").substr(4,2), 0, 16)} );
-							}
-							
-							if( pt.get("profile"+std::to_string(i)+".brightness", "").length() != 0 ){
-								m.set_brightness( profile, (uint8_t)stoi( pt.get("profile"+std::to_string(i)+".brightness", ""), 0, 16) );
-							}
-							
-							if( pt.get("profile"+std::to_string(i)+".speed", "").length() != 0 ){
-								m.set_speed( profile, (uint8_t)stoi( pt.get("profile"+std::to_string(i)+".speed", ""), 0, 16) );
-							}
-							
-							if( pt.get("profile"+std::to_string(i)+".scrollspeed", "").length() != 0 ){
-								m.set_scrollspeed( profile, (uint8_t)stoi( pt.get("profile"+std::to_string(i)+".scrollspeed", ""), 0, 16) );
-							}
-							
-							// DPI
-							for( int j = 1; j < 6; j++ ){
-								
-								// DPI level disabled
-								if( pt.get("profile"+std::to_string(i)+".dpi"+std::to_string(j)+"_enable", "") == "0" )
-									m.set_dpi_enable( profile, j-1, false );
-								
-								// DPI value
-								if( pt.get("profile"+std::to_string(i)+".dpi"+std::to_string(j), "").length() != 0 ){ // non-empty dpi value
-									
-									if( m.set_dpi( profile, j-1, pt.get("profile"+std::to_string(i)+".dpi"+std::to_string(j), "") ) != 0 ) // if invalid dpi value
-										std::cerr << "Warning: Unknown DPI value " << pt.get("profile"+std::to_string(i)+".dpi"+std::to_string(j), "") << "\n";
-								}
-							}
-							
-							for( auto& report_rate : m.report_rate_strings() ){
-								if( pt.get("profile"+std::to_string(i)+".report_rate", "") == report_rate.second )
-									m.set_report_rate( profile, report_rate.first );
-							}
-
-							// button mapping
-							for( auto key : m.button_names() ){
-								if( pt.get("profile"+std::to_string(i)+"."+key.second, "").length() != 0 ){ m.set_key_mapping( profile, key.first, pt.get("profile"+std::to_string(i)+"."+key.second, "") );	}
-							}
-							
-						}
-						
-						// write settings
-						m.write_settings();
-						
-					}
-					
-					// change active profile
-					if( flag_profile ){
-						
-						// set profile
-						if( !std::regex_match( string_profile, std::regex("[1-5]") ) )
-							throw std::string( "Wrong argument, expected 1-5." );
-
-						m.set_profile( (rd_mouse::rd_profile)(std::stoi(string_profile) - 1) );
-
-						// write profile
-						m.write_profile();
-						
-					}
-					
-					// send all macros
-					if( flag_macro && !flag_number ){
-						
-						// load macros
-						int r = m.set_all_macros( string_macro );
-						
-						if( r != 0 )
-							throw std::string( "Couldn't load macros." );
-						
-						// write macros
-						for( int i = 1; i < 16; i++ )
-							m.write_macro(i);
-						
-					}
-					
-					// send individual macro
-					if( flag_macro && flag_number ){
-						
-						
-						// set macro and macro slot (number)
-						int number;
-						
-						if( std::regex_match( string_number, std::regex("[0-9]+") ) ){
-							number = (int)stoi(string_number);
-						} else{
-							throw std::string( "Wrong argument, expected 1-15." );
-						}
-						
-						if( number < 1 || number > 15 )
-							throw std::string( "Wrong argument, expected 1-15." );
-						
-						if( m.set_macro( number, string_macro ) != 0 )
-							throw std::string( "Couldn't load macro" );
-						
-						// write macro
-						m.write_macro(number);
-						
-					} else if( !flag_macro && flag_number ){
-						throw std::string( "Misssing option, --macro and --number must be used together." );
-					}
-				
-				
-				// error handling
-				} catch( std::string const &message ){ // close mouse, rethrow
-					
-					m.close_mouse();
-					throw;
-					
-				} catch( std::exception const &e ){ // close mouse, rethrow
-					
-					m.close_mouse();
-					throw;
-					
-				}
-				
-				// close mouse
-				m.close_mouse();
-
-			}
-		);
-
-		std::visit( [&](auto&& arg){ perform_actions(arg); }, mouse );
+		set_journal_directory( options );
+		
+		// time and hardware counters of the CPU-side phases
+		rd_stats stats( command.stats_mode );
+		
+		// perform all actions on the mouse
+		mouse->perform_actions( options, stats );
+		
+		// print the statistics of the phases
+		stats.print( std::cerr );
+		
+		double latency = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+		RD_LOG_INFO( "performed directly in " << latency << " ms" );
+		if( command.stats_mode != rd_stats::stats_off )
+			std::cerr << "Path: direct, " << latency << " ms\n";
 
 	} catch( std::string const &message ){ // print error message and quit
 		
 		std::cerr << message << "\n";
+		print_flight_recorder_note();
 		return 1;
 		
 	} catch( std::exception const &e ){ // handle exceptions
 		
 		std::cerr << "An exception occured:\n" << e.what() << "\n";
+		print_flight_recorder_note();
 		return 1;
 		
 	}
 	
+	print_flight_recorder_note();
+	
 	return 0;
 }
 
-template< typename T >int open_mouse_wrapper( T &m, const bool flag_bus, const bool flag_device,
-	const std::string &string_bus, const std::string &string_device ){
+void parse_command_line( int argc, char **argv, command_line &command ){
+	
+	//command line options
+	static struct option long_options[] = {
+		{"help", no_argument, 0, 'h'},
+		{"config", required_argument, 0, 'c'},
+		{"profile", required_argument, 0, 'p'},
+		{"macro", required_argument, 0, 'm'},
+		{"number", required_argument, 0, 'n'},
+		{"bus", required_argument, 0, 'b'},
+		{"device", required_argument, 0, 'd'},
+		{"kernel-driver", no_argument, 0, 'k'},
+		{"version", no_argument, 0, 'v'},
+		{"dump", required_argument, 0, 'D'},
+		{"read", required_argument, 0, 'R'},
+		{"model", required_argument, 0, 'M'},
+		{"throttle", required_argument, 0, option_throttle},
+		{"measure-jitter", no_argument, 0, option_measure_jitter},
+		{"timeout", required_argument, 0, option_timeout},
+		{"flight-recorder", required_argument, 0, option_flight_recorder},
+		{"print-dump", required_argument, 0, option_print_dump},
+		{"log-level", required_argument, 0, option_log_level},
+		{"log-sink", required_argument, 0, option_log_sink},
+		{"stats", optional_argument, 0, option_stats},
+		{"compile-macros", required_argument, 0, option_compile_macros},
+		{"dry-run", optional_argument, 0, option_dry_run},
+		{"sync-lighting", required_argument, 0, option_sync_lighting},
+		{"simulate", optional_argument, 0, option_simulate},
+		{"journal", required_argument, 0, option_journal},
+		{"backup", required_argument, 0, option_backup},
+		{"restore", required_argument, 0, option_restore},
+		{"compress-macros", no_argument, 0, option_compress_macros},
+		{"resident", optional_argument, 0, option_resident},
+		{"undo", optional_argument, 0, option_undo},
+		{0, 0, 0, 0}
+	};
+	
+	rd_options &options = command.options;
 	
-	int open_return = 0; // open_mouse() return value
+	// getopt is called again for each command of the resident mode
+	optind = 0;
 	
-	if( flag_bus != flag_device ){ // improper arguments
+	//parse command line options
+	int c, option_index = 0;
+	while( (c = getopt_long( argc, argv, "hc:p:m:n:b:d:kvD:R:M:",
+	long_options, &option_index ) ) != -1 ){
 		
-		throw std::string( "Missing argument, --bus and --device must be used together." );
+		switch( c ){
+			case 'h':
+				command.flag_help = true;
+				break;
+			case 'c':
+				options.flag_config = true;
+				options.string_config = optarg;
+				break;
+			case 'p':
+				options.flag_profile = true;
+				options.string_profile = optarg;
+				break;
+			case 'm':
+				options.flag_macro = true;
+				options.string_macro = optarg;
+				break;
+			case 'n':
+				options.flag_number = true;
+				options.string_number = optarg;
+				break;
+			case 'b':
+				options.flag_bus = true;
+				options.string_bus = optarg;
+				break;
+			case 'd':
+				options.flag_device = true;
+				options.string_device = optarg;
+				break;
+			case 'k':
+				options.flag_kernel_driver = true;
+				break;
+			case 'v':
+				command.flag_version = true;
+				break;
+			case 'D':
+				options.flag_dump_settings = true;
+				options.string_dump = optarg;
+				break;
+			case 'R':
+				options.flag_read_settings = true;
+				options.string_read = optarg;
+				break;
+			case 'M':
+				command.string_model = optarg;
+				break;
+			case option_throttle:
+				options.flag_throttle = true;
+				options.string_throttle = optarg;
+				break;
+			case option_measure_jitter:
+				options.flag_measure_jitter = true;
+				break;
+			case option_timeout:
+				options.flag_timeout = true;
+				options.string_timeout = optarg;
+				break;
+			case option_flight_recorder:
+				command.flag_process_settings = true;
+				command.flag_flight_recorder = true;
+				rd_mouse::set_flight_recorder_file( optarg );
+				break;
+			case option_print_dump:
+				command.flag_print_dump = true;
+				command.string_print_dump = optarg;
+				break;
+			case option_log_level:
+				command.flag_process_settings = true;
+				if( rd_log::set_level( optarg ) != 0 )
+					throw std::string( "Wrong argument, expected off, error, warning, info, debug or trace." );
+				break;
+			case option_log_sink:
+				command.flag_process_settings = true;
+				if( rd_log::set_sink( optarg ) != 0 )
+					throw std::string( "Couldn't open "+std::string( optarg ) );
+				break;
+			case option_compile_macros:
+				command.flag_compile_macros = true;
+				options.string_compile_macros = optarg;
+				break;
+			case option_dry_run:
+				options.flag_dry_run = true;
+				options.string_dry_run = optarg == nullptr ? "" : optarg;
+				break;
+			case option_sync_lighting:
+				command.flag_sync_lighting = true;
+				command.string_sync_lighting = optarg;
+				break;
+			case option_simulate:
+				options.flag_simulate = true;
+				if( optarg != nullptr )
+					options.string_simulate = optarg;
+				break;
+			case option_journal:
+				options.string_journal = optarg;
+				break;
+			case option_backup:
+				options.flag_backup = true;
+				options.string_backup = optarg;
+				break;
+			case option_restore:
+				options.flag_restore = true;
+				options.string_restore = optarg;
+				break;
+			case option_compress_macros:
+				options.flag_compress_macros = true;
+				break;
+			case option_resident:
+				command.flag_resident = true;
+				if( optarg != nullptr )
+					command.string_resident = optarg;
+				break;
+			case option_undo:
+				options.flag_undo = true;
+				if( optarg != nullptr )
+					options.string_undo = optarg;
+				break;
+			case option_stats:
+				if( optarg == nullptr )
+					command.stats_mode = rd_stats::stats_time;
+				else if( std::string( optarg ) == "hw" )
+					command.stats_mode = rd_stats::stats_hw;
+				else
+					throw std::string( "Wrong argument, expected --stats or --stats=hw." );
+				break;
+			case '?':
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+void check_macro_options( const rd_options &options ){
+	
+	if( options.flag_compress_macros && !options.flag_macro )
+		throw std::string( "Missing option, --compress-macros requires --macro." );
+	if( options.flag_compress_macros && rd_macro_bank::is_macro_bank( options.string_macro ) )
+		throw std::string( "Wrong options, --compress-macros needs the macro file, not a compiled macro bank." );
+}
+
+void check_mouse_options( const rd_options &options ){
+	
+	if( options.flag_measure_jitter && options.offline )
+		throw std::string( "Wrong options, --measure-jitter needs the mouse." );
+	if( options.snapshot && (options.flag_dump_settings || options.flag_read_settings || options.flag_backup || options.flag_restore) )
+		throw std::string( "Wrong options, -D, -R, --backup and --restore need the mouse, use --dry-run without a snapshot." );
+	if( options.flag_compress_macros && !options.flag_config )
+		throw std::string( "Missing option, --compress-macros requires --config, the repeats are set by the button mappings." );
+	if( options.flag_restore && (options.flag_config || options.flag_macro) )
+		throw std::string( "Wrong options, --restore can't be combined with --config or --macro." );
+	if( options.flag_undo && (options.flag_config || options.flag_macro || options.flag_profile || options.flag_restore) )
+		throw std::string( "Wrong options, --undo can't be combined with --config, --macro, --profile or --restore." );
+	if( options.flag_undo && options.offline )
+		throw std::string( "Wrong options, --undo needs the mouse." );
+}
+
+void set_journal_directory( rd_options &options ){
+	
+	// directory of the write journals: --journal, $XDG_STATE_HOME/mouse_m908 or ~/.local/state/mouse_m908, off disables them
+	if( options.string_journal == "" && getenv( "XDG_STATE_HOME" ) != nullptr && getenv( "XDG_STATE_HOME" )[0] != '\0' )
+		options.string_journal = std::string( getenv( "XDG_STATE_HOME" ) ) + "/mouse_m908";
+	else if( options.string_journal == "" && getenv( "HOME" ) != nullptr )
+		options.string_journal = std::string( getenv( "HOME" ) ) + "/.local/state/mouse_m908";
+	options.journal = options.string_journal != "" && options.string_journal != "off" && !options.offline && !options.flag_dry_run;
+}
+
+bool resident_command( const command_line &command ){
+	
+	return !command.flag_help && !command.flag_version && !command.flag_print_dump && !command.flag_compile_macros &&
+		!command.flag_sync_lighting && !command.flag_resident && !command.flag_process_settings && command.string_model == "" &&
+		!command.options.flag_bus && !command.options.flag_device && !command.options.flag_simulate && command.options.string_dry_run == "";
+}
+
+// performs one command of the resident mode on the open mouse, errors are printed
+// arguments starts with the program name, returns the exit status
+int run_resident_command( rd_model &mouse, std::vector< std::string > arguments, const command_line &resident ){
+	
+	std::vector< char* > argv;
+	for( auto& argument : arguments )
+		argv.push_back( &argument[0] );
+	argv.push_back( nullptr );
+	
+	bool performed = false;
+	
+	try{
+		
+		command_line command;
+		parse_command_line( argv.size() - 1, argv.data(), command );
+		rd_options &options = command.options;
+		
+		if( !resident_command( command ) )
+			throw std::string( "Wrong options, the resident mode only performs the actions on the mouse." );
+		
+		// the mouse was chosen when the resident mode started
+		options.flag_bus = resident.options.flag_bus;
+		options.flag_device = resident.options.flag_device;
+		options.string_bus = resident.options.string_bus;
+		options.string_device = resident.options.string_device;
+		if( options.string_journal == "" )
+			options.string_journal = resident.options.string_journal;
+		options.resident = true;
+		
+		check_macro_options( options );
+		check_mouse_options( options );
+		set_journal_directory( options );
+		
+		rd_stats stats( command.stats_mode );
+		performed = true;
+		mouse.perform_actions( options, stats );
+		stats.print( std::cerr );
+		
+		// the claims the command line would have made
+		if( command.stats_mode != rd_stats::stats_off ){
+			rd_mouse::claim_stats claims = mouse.get_claim_stats();
+			std::cerr << "Interface claims: " << claims.claims << ", releases: " << claims.releases << "\n";
+		}
+		
+	} catch( std::string const &message ){ // print error message, after a failed action the next command opens the mouse again
+		
+		std::cerr << message << "\n";
+		if( performed )
+			mouse.close_mouse();
 		return 1;
 		
-	} else if( flag_bus && flag_device ){ // open with bus and device
+	} catch( std::exception const &e ){
 		
-		if( !std::regex_match( string_bus, std::regex("[0-9]+") ) ||
-			!std::regex_match( string_device, std::regex("[0-9]+") ) ){
-			
+		std::cerr << "An exception occured:\n" << e.what() << "\n";
+		if( performed )
+			mouse.close_mouse();
+		return 1;
+		
+	}
+	
+	return 0;
+}
+
+void run_resident( const command_line &resident ){
+	
+	// interfaces are released after this time without commands (ms)
+	int idle_time = 2000;
+	if( resident.string_resident != "" ){
+		if( !std::regex_match( resident.string_resident, std::regex("[0-9]+") ) )
 			throw std::string( "Wrong argument, expected number." );
-			return 1;
+		idle_time = std::stoi( resident.string_resident );
+	}
+	
+	if( resident.options.flag_bus != resident.options.flag_device )
+		throw std::string( "Missing argument, --bus and --device must be used together." );
+	
+	std::unique_ptr< rd_model > mouse = detect_model( resident.string_model );
+	if( mouse == nullptr )
+		throw std::string( "Couldn't detect mouse, try with the --model option." );
+	
+	// the command lines started while the resident mode runs send their commands to this socket
+	std::string socket_path = rd_resident::socket_path( true );
+	if( socket_path == "" )
+		throw std::string( "Couldn't use /tmp/mouse_m908-"+std::to_string( getuid() )+" for the socket, set XDG_RUNTIME_DIR or MOUSE_M908_SOCKET." );
+	int socket = rd_resident::listen( socket_path );
+	if( socket < 0 )
+		throw std::string( "Couldn't create "+socket_path+", is another resident mode running?" );
+	
+	// SIGINT and SIGTERM end the resident mode after the running command, a client that goes away doesn't
+	struct sigaction action = {};
+	action.sa_handler = cancel_handler;
+	action.sa_flags = SA_RESETHAND;
+	sigaction( SIGINT, &action, nullptr );
+	sigaction( SIGTERM, &action, nullptr );
+	signal( SIGPIPE, SIG_IGN );
+	
+	std::cerr << "Resident mode for the " << mouse->get_name() << ", reading commands from stdin and " << socket_path << "\n";
+	
+	size_t commands = 0;
+	std::string input;
+	auto last_command = std::chrono::steady_clock::now();
+	bool end_of_input = false;
+	
+	// nothing is polled periodically while idle: the loop sleeps in poll() on the socket, stdin, the device node
+	// (inotify, a disconnected mouse is closed and opened again by the next command) and the libusb file descriptors
+	int watch_fd = -1, watch = -1;
+	std::string watched_node;
+	#ifdef __linux__
+	watch_fd = inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+	#endif
+	
+	while( !cancel_requested ){
+		
+		// the interfaces are claimed by the first command of a burst and released when the mouse was idle long enough
+		int timeout = -1;
+		if( mouse->get_claim_stats().claimed ){
+			auto idle = std::chrono::duration_cast< std::chrono::milliseconds >( std::chrono::steady_clock::now() - last_command ).count();
+			if( idle >= idle_time ){
+				mouse->release_interfaces();
+				continue;
+			}
+			timeout = idle_time - idle;
 		}
 		
-		open_return = m.open_mouse_bus_device( stoi(string_bus), stoi(string_device) );
+		// the node changes when the mouse was opened again
+		std::string node = mouse->get_device_node();
+		#ifdef __linux__
+		if( watch_fd >= 0 && node != watched_node ){
+			if( watch >= 0 )
+				inotify_rm_watch( watch_fd, watch );
+			watch = node.empty() ? -1 : inotify_add_watch( watch_fd, node.c_str(), IN_DELETE_SELF );
+			watched_node = node;
+		}
+		#endif
 		
-	} else{ // open with vid and pid
+		// stdin is no longer watched at its end, the socket still is
+		std::vector< pollfd > fds = { { socket, POLLIN, 0 }, { end_of_input ? -1 : STDIN_FILENO, POLLIN, 0 }, { watch_fd, POLLIN, 0 } };
+		if( !node.empty() ){
+			const libusb_pollfd** usb_fds = libusb_get_pollfds( NULL );
+			for( size_t i = 0; usb_fds != nullptr && usb_fds[i] != nullptr; i++ )
+				fds.push_back( { usb_fds[i]->fd, usb_fds[i]->events, 0 } );
+			libusb_free_pollfds( usb_fds );
+		}
+		
+		// the release after the idle time is the only timer, it may be late by a tenth of the idle time
+		// so the kernel can coalesce it with other wakeups, the default slack is restored for the transfers
+		#ifdef __linux__
+		if( timeout >= 0 )
+			prctl( PR_SET_TIMERSLACK, std::clamp( idle_time / 10, 1, 1000 ) * 1000000ul, 0, 0, 0 );
+		#endif
+		int ready = poll( fds.data(), fds.size(), timeout );
+		#ifdef __linux__
+		if( timeout >= 0 )
+			prctl( PR_SET_TIMERSLACK, 0, 0, 0, 0 );
+		#endif
+		if( ready < 0 && errno != EINTR )
+			break;
+		if( ready <= 0 )
+			continue;
 		
-		open_return = m.open_mouse();
+		// events of the open mouse, e.g. its removal
+		for( size_t i = 3; i < fds.size(); i++ ){
+			if( fds[i].revents != 0 ){
+				timeval zero = { 0, 0 };
+				libusb_handle_events_timeout_completed( NULL, &zero, nullptr );
+				break;
+			}
+		}
 		
+		// the device node was removed: the mouse was disconnected
+		#ifdef __linux__
+		if( fds[2].revents & POLLIN ){
+			alignas(inotify_event) char events[4096];
+			bool removed = false;
+			for( ssize_t length; (length = read( watch_fd, events, sizeof(events) )) > 0; ){
+				for( char* e = events; e < events + length; e += sizeof(inotify_event) + ((inotify_event*)e)->len )
+					removed = removed || (((inotify_event*)e)->wd == watch && (((inotify_event*)e)->mask & IN_DELETE_SELF));
+			}
+			if( removed ){
+				std::cerr << "The mouse was disconnected, the next command opens it again\n";
+				mouse->close_mouse();
+				watch = -1;
+				watched_node = "";
+			}
+		}
+		#endif
+		
+		// a command line
+		if( fds[0].revents & POLLIN ){
+			if( rd_resident::serve( socket, [&]( const std::vector< std::string >& arguments ){
+					std::vector< std::string > command = { "mouse_m908" };
+					command.insert( command.end(), arguments.begin(), arguments.end() );
+					return run_resident_command( *mouse, command, resident );
+				} ) == 0 ){
+				last_command = std::chrono::steady_clock::now();
+				commands++;
+			}
+		}
+		
+		if( !(fds[1].revents & (POLLIN | POLLHUP)) )
+			continue;
+		
+		char buffer[4096];
+		ssize_t length = read( STDIN_FILENO, buffer, sizeof(buffer) );
+		if( length < 0 && errno == EINTR )
+			continue;
+		if( length <= 0 ){
+			end_of_input = true;
+			input += "\n";
+		} else{
+			input.append( buffer, length );
+		}
+		
+		// one command per line, the arguments are separated by spaces or tabs (no quoting), # starts a comment
+		for( size_t newline; (newline = input.find( '\n' )) != std::string::npos && !cancel_requested; ){
+			
+			std::vector< std::string > command = { "mouse_m908" };
+			std::istringstream words( input.substr( 0, newline ) );
+			for( std::string word; words >> word; )
+				command.push_back( word );
+			input.erase( 0, newline + 1 );
+			
+			if( command.size() == 1 || command[1][0] == '#' )
+				continue;
+			
+			run_resident_command( *mouse, command, resident );
+			last_command = std::chrono::steady_clock::now();
+			commands++;
+		}
 	}
 	
-	// Could not open → print message
-	if( open_return != 0 ){
+	if( watch_fd >= 0 )
+		close( watch_fd );
+	close( socket );
+	unlink( socket_path.c_str() );
+	mouse->close_mouse();
+	
+	// each command of the command line claims and releases the interfaces once
+	rd_mouse::claim_stats claims = mouse->get_claim_stats();
+	std::cerr << "Resident mode: " << commands << " commands, " << claims.claims << " interface claims, ";
+	std::cerr << claims.releases << " releases, " << (commands > claims.claims ? commands - claims.claims : 0) << " claim/release cycles avoided\n";
+}
+
+void sync_lighting( const std::string &string_model, const std::string &string_sync_lighting, const bool flag_kernel_driver ){
+	
+#ifndef RD_WITH_M908
+	(void)string_model;
+	(void)string_sync_lighting;
+	(void)flag_kernel_driver;
+	throw std::string( "--sync-lighting needs the M908, which is not included in this build." );
+#else
+	// effect[:frames per second[:seconds]], 0 seconds = until SIGINT or SIGTERM
+	std::smatch match;
+	if( !std::regex_match( string_sync_lighting, match, std::regex("([a-z]+)(:([0-9]*\\.?[0-9]+)(:([0-9]*\\.?[0-9]+))?)?") ) )
+		throw std::string( "Wrong argument, expected <effect>[:<fps>[:<seconds>]]." );
+	
+	rd_light_sync::rd_effect effect;
+	if( rd_light_sync::effect( match[1], effect ) != 0 )
+		throw std::string( "Unknown effect, expected rainbow, wave, breathing or chase." );
+	
+	double frame_rate = match[3].matched ? std::stod( match[3] ) : 25;
+	double duration = match[5].matched ? std::stod( match[5] ) : 10;
+	if( frame_rate <= 0 )
+		throw std::string( "Wrong argument, the frame rate must be greater than 0." );
+	
+	// only the M908 can write the color without the other settings
+	if( string_model != "" && string_model != mouse_m908::get_name() )
+		throw std::string( "--sync-lighting is only supported for the M908." );
+	
+	auto devices = rd_mouse::find( mouse_m908::get_name() );
+	if( devices.empty() )
+		throw std::string( "Couldn't find any M908." );
+	
+	// the mice are not moved after opening them
+	std::vector< mouse_m908 > mice( devices.size() );
+	size_t opened = 0;
+	rd_light_sync sync;
+	
+	try{
 		
-		throw std::string(
-			"Couldn't open mouse.\n"
-			"- Check hardware and permissions (maybe you need to be root?)\n"
-			"- Try with or without the --kernel-driver option\n"
-			"- Try with the --model option\n"
-			"- Try with the --bus and --device options\n"
-			"If nothing works please report this as a bug."
-		);
+		for( size_t i = 0; i < devices.size(); i++ ){
+			
+			mouse_m908& m = mice[i];
+			m.set_detach_kernel_driver( !flag_kernel_driver );
+			
+			if( m.open_mouse_bus_device( devices[i].first, devices[i].second ) != 0 )
+				throw std::string( "Couldn't open the mouse at bus "+std::to_string( devices[i].first )+", device "+std::to_string( devices[i].second )+"." );
+			opened++;
+			
+			// the color is written to the active profile, the lightmode must be static for host-driven colors
+			if( m.read_settings() != 0 )
+				std::cerr << "Warning: Couldn't read the settings of the mouse at bus " << (int)devices[i].first << ", device " << (int)devices[i].second << "\n";
+			rd_mouse::rd_profile profile = m.get_profile();
+			m.set_lightmode( profile, rd_mouse::lightmode_static );
+			
+			sync.add_device( "bus "+std::to_string( devices[i].first )+" device "+std::to_string( devices[i].second ),
+				[&m, profile]( const rd_light_sync::rd_color& color ){ return m.write_color( profile, color ); } );
+		}
+		
+		// SIGINT and SIGTERM stop the effect, a second signal terminates immediately
+		struct sigaction action = {};
+		action.sa_handler = cancel_handler;
+		action.sa_flags = SA_RESETHAND;
+		sigaction( SIGINT, &action, nullptr );
+		sigaction( SIGTERM, &action, nullptr );
+		
+		if( sync.measure_latency( { 0, 0, 0 } ) != 0 )
+			std::cerr << "Warning: Couldn't send the color to all mice\n";
+		
+		sync.run( effect, frame_rate, duration, &cancel_requested );
+		sync.print_stats( std::cerr );
+		
+	} catch( std::string const &message ){ // close mice, rethrow
+		
+		for( size_t i = 0; i < opened; i++ )
+			mice[i].close_mouse();
+		throw;
 		
-		return 1;
 	}
 	
-	return 0;
+	for( auto& m : mice )
+		m.close_mouse();
+#endif
+}
+
+#ifdef RD_PLUGINS
+
+// the plugins are indexed on first use
+rd_plugin_loader& plugin_loader(){
+	static rd_plugin_loader loader;
+	return loader;
+}
+
+std::vector< std::string > model_names(){
+	return plugin_loader().get_names();
 }
+
+std::unique_ptr< rd_model > detect_model( const std::string &string_model ){
+	return plugin_loader().detect( string_model );
+}
+
+std::unique_ptr< rd_model > find_model( const std::string &string_model ){
+	return plugin_loader().load( string_model );
+}
+
+#else
+
+// wraps the object in the variant, nullptr for rd_mouse::monostate
+std::unique_ptr< rd_model > make_model( rd_mouse::mouse_variant &mouse ){
+	return std::visit( overload(
+		[](rd_mouse::monostate) -> std::unique_ptr< rd_model > { return nullptr; },
+		[](auto& m) -> std::unique_ptr< rd_model > { return std::make_unique< rd_model_adapter< std::decay_t<decltype(m)> > >( m ); }
+	), mouse );
+}
+
+std::vector< std::string > model_names(){
+	
+	std::vector< std::string > names;
+	variant_loop<rd_mouse::mouse_variant>( [&](auto m){
+		if( m.get_name() != rd_mouse::monostate::get_name() )
+			names.push_back( m.get_name() );
+	} );
+	
+	return names;
+}
+
+std::unique_ptr< rd_model > detect_model( const std::string &string_model ){
+	
+	rd_mouse::mouse_variant mouse;
+	if( string_model == "" )
+		mouse = rd_mouse::detect();
+	else
+		mouse = rd_mouse::detect( string_model );
+	
+	return make_model( mouse );
+}
+
+std::unique_ptr< rd_model > find_model( const std::string &string_model ){
+	
+	rd_mouse::mouse_variant mouse;
+	variant_loop<rd_mouse::mouse_variant>( [&](auto m){
+		if( m.get_name() == string_model )
+			mouse = m;
+	} );
+	
+	return make_model( mouse );
+}
+
+#endif